@@ -0,0 +1,47 @@
+#include <iostream>
+#include <chrono>
+
+#include <symengine/basic.h>
+#include <symengine/add.h>
+#include <symengine/mul.h>
+#include <symengine/symbol.h>
+#include <symengine/cse.h>
+
+using SymEngine::Basic;
+using SymEngine::symbol;
+using SymEngine::add;
+using SymEngine::mul;
+using SymEngine::cse;
+using SymEngine::vec_basic;
+using SymEngine::vec_pair;
+using SymEngine::RCP;
+
+// cse() of n sums x + y_i + z_i and n products x y_i z_i, all sharing x, with
+// nothing else in common. The time should grow about linearly with n.
+int main(int argc, char *argv[])
+{
+    SymEngine::print_stack_on_segfault();
+
+    RCP<const Basic> x = symbol("x");
+    for (unsigned n = 1000; n <= 16000; n *= 2) {
+        vec_basic exprs;
+        for (unsigned i = 0; i < n; i++) {
+            RCP<const Basic> y = symbol("y" + std::to_string(i));
+            RCP<const Basic> z = symbol("z" + std::to_string(i));
+            exprs.push_back(add(add(x, y), z));
+            exprs.push_back(mul(mul(x, y), z));
+        }
+        vec_pair replacements;
+        vec_basic reduced;
+        auto t1 = std::chrono::high_resolution_clock::now();
+        cse(replacements, reduced, exprs);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        std::cout << "n = " << n << ": "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(
+                         t2 - t1)
+                         .count()
+                  << "ms" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include <iostream>
+#include <chrono>
+
+#include <symengine/fields.h>
+
+using SymEngine::GaloisFieldDict;
+using SymEngine::integer_class;
+
+int main(int argc, char *argv[])
+{
+    SymEngine::print_stack_on_segfault();
+
+    // Factors monic polynomials with pseudo-random coefficients of increasing
+    // degree over fields of small and word-size order
+    const char *moduli[] = {"101", "1000003", "2305843009213693951"};
+    std::vector<unsigned> degrees = {25, 50, 100, 200, 400, 800};
+
+    for (const char *m : moduli) {
+        const integer_class p((std::string(m)));
+        std::cout << "Factoring over GF(" << m << ")" << std::endl;
+        for (unsigned n : degrees) {
+            std::vector<integer_class> v(n + 1);
+            unsigned long s = 12345;
+            for (unsigned i = 0; i < n; i++) {
+                s = s * 6364136223846793005UL + 1442695040888963407UL;
+                v[i] = integer_class(s) % p;
+            }
+            v[n] = 1;
+            GaloisFieldDict f = GaloisFieldDict::from_vec(v, p);
+
+            auto t1 = std::chrono::high_resolution_clock::now();
+            auto factors = f.gf_factor();
+            auto t2 = std::chrono::high_resolution_clock::now();
+
+            std::cout << "degree " << n << ": "
+                      << std::chrono::duration_cast<
+                             std::chrono::milliseconds>(t2 - t1)
+                             .count()
+                      << " ms, " << factors.second.size() << " factors"
+                      << std::endl;
+        }
+    }
+
+    return 0;
+}
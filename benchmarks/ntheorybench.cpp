@@ -34,6 +34,9 @@ void bench_mertens()
     _bench_mertens(32);
     _bench_mertens(64);
     _bench_mertens(113);
+    _bench_mertens(1000000);
+    _bench_mertens(1000000000);
+    _bench_mertens(100000000000);
     cout << endl;
 }
 
@@ -96,10 +99,187 @@ void bench_mp_sqrt()
     _bench_mp_sqrt(4);
 }
 
+void _bench_sieve(const uint64_t start, const uint64_t limit)
+{
+    std::vector<uint64_t> primes;
+    cout << "Sieve::generate_primes(primes, " << start << ", " << limit
+         << "): ";
+    auto t1 = std::chrono::high_resolution_clock::now();
+    SymEngine::Sieve::generate_primes(primes, start, limit);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    cout << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                .count()
+         << "ms" << endl;
+
+    cout << "Sieve::count_primes(" << start << ", " << limit << "): ";
+    t1 = std::chrono::high_resolution_clock::now();
+    SymEngine::Sieve::count_primes(start, limit);
+    t2 = std::chrono::high_resolution_clock::now();
+    cout << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                .count()
+         << "ms" << endl;
+}
+void bench_sieve()
+{
+    _bench_sieve(0, 10000000);
+    _bench_sieve(0, 100000000);
+    _bench_sieve(0, 1000000000);
+    _bench_sieve(1000000000000ULL, 1000100000000ULL);
+    cout << endl;
+}
+
+void _bench_factor(const char *a)
+{
+    SymEngine::RCP<const SymEngine::Integer> f;
+    cout << "factor(f, " << a << "): ";
+    auto t1 = std::chrono::high_resolution_clock::now();
+    factor(SymEngine::outArg(f), *integer(SymEngine::integer_class(a)));
+    auto t2 = std::chrono::high_resolution_clock::now();
+    cout << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                .count()
+         << "ms" << endl;
+}
+void bench_factor()
+{
+    // Products of two random primes of about half the digits each
+    _bench_factor("6957649925799255383");
+    _bench_factor("871209201215259372308405412131");
+    _bench_factor("4804223080685634677665591398195033880799");
+    _bench_factor("38183752041006019459167453539273587136100551000527");
+    _bench_factor(
+        "164307574344931721968963846069831945260014787930488916784061");
+    cout << endl;
+}
+
+void _bench_batch(const char *start, unsigned count)
+{
+    SymEngine::integer_class a(start);
+    SymEngine::vec_integer_class n;
+    std::vector<SymEngine::RCP<const SymEngine::Integer>> ints;
+    for (unsigned i = 0; i < count; i++) {
+        n.push_back(a + i);
+        ints.push_back(integer(a + i));
+    }
+
+    cout << "probab_prime_p(" << start << " + i), " << count << " times: ";
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (auto &i : ints)
+        SymEngine::probab_prime_p(*i);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    cout << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                .count()
+         << "ms" << endl;
+
+    std::vector<int> result;
+    cout << "probab_prime_p_batch: ";
+    t1 = std::chrono::high_resolution_clock::now();
+    SymEngine::probab_prime_p_batch(result, n);
+    t2 = std::chrono::high_resolution_clock::now();
+    cout << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                .count()
+         << "ms" << endl;
+
+    cout << "prime_factors(" << start << " + i), " << count << " times: ";
+    t1 = std::chrono::high_resolution_clock::now();
+    for (auto &i : ints) {
+        std::vector<SymEngine::RCP<const SymEngine::Integer>> primes;
+        SymEngine::prime_factors(primes, *i);
+    }
+    t2 = std::chrono::high_resolution_clock::now();
+    cout << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                .count()
+         << "ms" << endl;
+
+    SymEngine::vec_integer_class primes;
+    std::vector<size_t> offsets;
+    cout << "prime_factors_batch: ";
+    t1 = std::chrono::high_resolution_clock::now();
+    SymEngine::prime_factors_batch(primes, offsets, n);
+    t2 = std::chrono::high_resolution_clock::now();
+    cout << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                .count()
+         << "ms" << endl;
+}
+void bench_batch()
+{
+    _bench_batch("1000000000000000", 20000);
+    _bench_batch("1000000000000000000000000", 20000);
+    cout << endl;
+}
+
+void _bench_bernoulli_harmonic(const unsigned long n)
+{
+    cout << "bernoulli(" << n << "): ";
+    auto t1 = std::chrono::high_resolution_clock::now();
+    SymEngine::bernoulli(n);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    cout << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                .count()
+         << "ms" << endl;
+
+    cout << "harmonic(" << n << "): ";
+    t1 = std::chrono::high_resolution_clock::now();
+    SymEngine::harmonic(n);
+    t2 = std::chrono::high_resolution_clock::now();
+    cout << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                .count()
+         << "ms" << endl;
+}
+void bench_bernoulli_harmonic()
+{
+    _bench_bernoulli_harmonic(1000);
+    _bench_bernoulli_harmonic(10000);
+    _bench_bernoulli_harmonic(100000);
+    cout << endl;
+}
+
+void _bench_discrete_log(const char *prime, unsigned long g, unsigned count)
+{
+    SymEngine::integer_class p(prime), b;
+    SymEngine::vec_integer_class a, x;
+    for (unsigned long i = 1; i <= count; i++) {
+        SymEngine::mp_powm(b, SymEngine::integer_class(g),
+                           SymEngine::integer_class(i * 987654321987), p);
+        a.push_back(b);
+    }
+
+    cout << "discrete_log(a, " << g << ", " << prime << "), " << count
+         << " times: ";
+    auto t1 = std::chrono::high_resolution_clock::now();
+    SymEngine::RCP<const SymEngine::Integer> r;
+    for (auto &i : a)
+        SymEngine::discrete_log(SymEngine::outArg(r), *integer(i),
+                                *integer(g), *integer(p));
+    auto t2 = std::chrono::high_resolution_clock::now();
+    cout << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                .count()
+         << "ms" << endl;
+
+    cout << "discrete_log_batch: ";
+    t1 = std::chrono::high_resolution_clock::now();
+    SymEngine::discrete_log_batch(x, a, SymEngine::integer_class(g), p);
+    t2 = std::chrono::high_resolution_clock::now();
+    cout << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                .count()
+         << "ms" << endl;
+}
+void bench_discrete_log()
+{
+    _bench_discrete_log("1000000000000000003", 2, 100);
+    _bench_discrete_log("2835234296501697128601200562200991079102847", 5,
+                        100);
+    cout << endl;
+}
+
 int main()
 {
+    bench_sieve();
     bench_mertens();
     bench_mobius();
     bench_prime_factor_multiplicities();
     bench_mp_sqrt();
+    bench_batch();
+    bench_bernoulli_harmonic();
+    bench_discrete_log();
+    bench_factor();
 }
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include <iostream>
+#include <chrono>
+
+#include <symengine/basic.h>
+#include <symengine/integer.h>
+#include <symengine/matrix.h>
+
+using SymEngine::Basic;
+using SymEngine::Integer;
+using SymEngine::RCP;
+using SymEngine::integer;
+using SymEngine::vec_basic;
+using SymEngine::CSRMatrix;
+
+int main(int argc, char *argv[])
+{
+    SymEngine::print_stack_on_segfault();
+
+    // Pentadiagonal matrix with integer entries
+    unsigned n = 1000;
+    std::vector<unsigned> i, j;
+    vec_basic x;
+    for (unsigned r = 0; r < n; r++) {
+        for (unsigned c = (r < 2 ? 0 : r - 2); c < std::min(n, r + 3); c++) {
+            i.push_back(r);
+            j.push_back(c);
+            x.push_back(integer((r * 7 + c * 3) % 11 - 5));
+        }
+    }
+    CSRMatrix A = CSRMatrix::from_coo(n, n, i, j, x);
+    CSRMatrix C(n, n);
+
+    std::cout << "Multiplying Two Sparse Matrices; matrix dimensions: " << n
+              << " x " << n << ", pentadiagonal" << std::endl;
+
+    unsigned N = 100;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (unsigned k = 0; k < N; k++)
+        A.mul_matrix(A, C);
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    std::cout << std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1)
+                         .count()
+                     / N
+              << " microseconds" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include <iostream>
+#include <chrono>
+
+#include <symengine/basic.h>
+#include <symengine/matrix.h>
+#include <symengine/symbol.h>
+
+using SymEngine::Basic;
+using SymEngine::RCP;
+using SymEngine::symbol;
+using SymEngine::vec_basic;
+using SymEngine::CSRMatrix;
+using SymEngine::DenseMatrix;
+
+int main(int argc, char *argv[])
+{
+    SymEngine::print_stack_on_segfault();
+
+    // Tridiagonal matrix of symbols times a dense matrix of symbols
+    unsigned n = 1000, m = 4;
+    std::vector<unsigned> i, j;
+    vec_basic x;
+    for (unsigned r = 0; r < n; r++) {
+        for (unsigned c = (r < 1 ? 0 : r - 1); c < std::min(n, r + 2); c++) {
+            i.push_back(r);
+            j.push_back(c);
+            x.push_back(symbol("a" + std::to_string(r - c + 1)));
+        }
+    }
+    CSRMatrix A = CSRMatrix::from_coo(n, n, i, j, x);
+    DenseMatrix B(n, m), C(n, m);
+    for (unsigned r = 0; r < n; r++)
+        for (unsigned c = 0; c < m; c++)
+            B.set(r, c, symbol("x" + std::to_string((r + c) % 10)));
+
+    std::cout << "Multiplying Sparse and Dense Matrices; matrix dimensions: "
+              << n << " x " << n << " and " << n << " x " << m << std::endl;
+
+    unsigned N = 100;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (unsigned k = 0; k < N; k++)
+        A.mul_matrix(B, C);
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    std::cout << std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1)
+                         .count()
+                     / N
+              << " microseconds" << std::endl;
+
+    return 0;
+}
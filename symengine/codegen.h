@@ -3,6 +3,7 @@
 
 #include <symengine/visitor.h>
 #include <symengine/printer.h>
+#include <symengine/cse.h>
 #include <symengine/symengine_exception.h>
 
 namespace SymEngine
@@ -183,6 +184,40 @@ std::string ccode(const Basic &x)
     CodePrinter c;
     return c.apply(x);
 }
+
+//! C code evaluating the program `p` and storing the outputs in `out`.
+//! Temporaries with disjoint live ranges share the same variable.
+inline std::string ccode(const StraightLineProgram &p)
+{
+    CodePrinter c;
+    const vec_pair &instructions = p.get_instructions();
+    const std::vector<unsigned> &registers = p.get_registers();
+
+    // Each register is named after the first temporary stored in it
+    vec_basic names(p.get_nregisters());
+    map_basic_basic subs;
+    for (unsigned i = 0; i < instructions.size(); i++) {
+        if (names[registers[i]].is_null())
+            names[registers[i]] = instructions[i].first;
+        subs[instructions[i].first] = names[registers[i]];
+    }
+
+    std::ostringstream s;
+    for (unsigned i = 0; i < names.size(); i++) {
+        s << (i == 0 ? "double " : ", ") << c.apply(names[i]);
+        if (i == names.size() - 1)
+            s << ";\n";
+    }
+    for (unsigned i = 0; i < instructions.size(); i++) {
+        s << c.apply(names[registers[i]]) << " = "
+          << c.apply(instructions[i].second->subs(subs)) << ";\n";
+    }
+    const vec_basic &outputs = p.get_outputs();
+    for (unsigned i = 0; i < outputs.size(); i++) {
+        s << "out[" << i << "] = " << c.apply(outputs[i]->subs(subs)) << ";\n";
+    }
+    return s.str();
+}
 }
 
 #endif // SYMENGINE_CODEGEN_H
@@ -1,4 +1,4 @@
-#include <symengine/basic.h>
+#include <symengine/cse.h>
 #include <symengine/add.h>
 #include <symengine/mul.h>
 #include <symengine/functions.h>
@@ -74,54 +74,46 @@ public:
        are the number of arguments said function has in common with `argset`.
        Entries have at least 2 items in common.
     */
-    std::map<unsigned, unsigned>
+    std::unordered_map<unsigned, unsigned>
     get_common_arg_candidates(std::set<unsigned> &argset, unsigned min_func_i)
     {
-        std::map<unsigned, unsigned> count_map;
-        std::vector<std::set<unsigned>> funcsets;
+        std::unordered_map<unsigned, unsigned> count_map;
+        // Only pointers to the sets are collected, copying them made this
+        // quadratic for arguments shared by many functions.
+        std::vector<const std::set<unsigned> *> funcsets;
         for (unsigned arg : argset) {
-            funcsets.push_back(arg_to_funcset[arg]);
+            funcsets.push_back(&arg_to_funcset[arg]);
         }
         // Sorted by size to make best use of the performance hack below.
         std::sort(funcsets.begin(), funcsets.end(),
-                  [](const std::set<unsigned> &a, const std::set<unsigned> &b) {
-                      return a.size() < b.size();
+                  [](const std::set<unsigned> *a, const std::set<unsigned> *b) {
+                      return a->size() < b->size();
                   });
 
-        for (unsigned i = 0; i < funcsets.size(); i++) {
-            auto &funcset = funcsets[i];
-            for (unsigned func_i : funcset) {
-                if (func_i >= min_func_i) {
-                    count_map[func_i] += 1;
-                }
+        if (funcsets.empty())
+            return count_map;
+
+        // The sets are sorted, so skip the functions already processed.
+        for (unsigned i = 0; i + 1 < funcsets.size(); i++) {
+            auto &funcset = *funcsets[i];
+            for (auto it = funcset.lower_bound(min_func_i); it != funcset.end();
+                 ++it) {
+                count_map[*it] += 1;
             }
         }
 
-        /*auto &largest_funcset = funcsets[funcsets.size() - 1];
-
-        // We pick the smaller of the two containers to iterate over to
-        // reduce the number of items we have to look at.
-
-        if (largest_funcset.size() < count_map.size()) {
-            for (unsigned func_i : largest_funcset) {
-                if (count_map[func_i] < 1) {
-                    continue;
-                }
-                if (count_map.find(func_i) != count_map.end()) {
-                    count_map[func_i] += 1;
-                }
+        // A function with at least 2 arguments in common is in one of the
+        // smaller sets already, so the largest set is only probed for the
+        // functions counted so far. Walking it instead made this quadratic
+        // for an argument shared by many functions.
+        auto &largest_funcset = *funcsets.back();
+        for (auto &count_map_pair : count_map) {
+            if (largest_funcset.find(count_map_pair.first)
+                != largest_funcset.end()) {
+                count_map_pair.second += 1;
             }
-        } else {
-            for (auto &count_map_pair : count_map) {
-                unsigned func_i = count_map_pair.first;
-                if (count_map[func_i] < 1) {
-                    continue;
-                }
-                if (largest_funcset.find(func_i) != largest_funcset.end()) {
-                    count_map[func_i] += 1;
-                }
-            }
-        }*/
+        }
+
         auto iter = count_map.begin();
         for (; iter != count_map.end();) {
             if (iter->second >= 2) {
@@ -192,9 +184,10 @@ std::vector<unsigned> set_diff(const std::set<unsigned> &a,
 
 void add_to_sorted_vec(std::vector<unsigned> &vec, unsigned number)
 {
-    if (std::find(vec.begin(), vec.end(), number) == vec.end()) {
+    auto it = std::lower_bound(vec.begin(), vec.end(), number);
+    if (it == vec.end() or *it != number) {
         // Add number if not found
-        vec.insert(std::upper_bound(vec.begin(), vec.end(), number), number);
+        vec.insert(it, number);
     }
 }
 
@@ -214,7 +207,7 @@ void match_common_args(const std::string &func_class, const vec_basic &funcs_,
     auto arg_tracker = FuncArgTracker(funcs);
 
     std::set<unsigned> changed;
-    std::map<unsigned, unsigned> common_arg_candidates_counts;
+    std::unordered_map<unsigned, unsigned> common_arg_candidates_counts;
 
     for (unsigned i = 0; i < funcs.size(); i++) {
         common_arg_candidates_counts = arg_tracker.get_common_arg_candidates(
@@ -298,7 +291,7 @@ void match_common_args(const std::string &func_class, const vec_basic &funcs_,
                 changed.insert(k);
             }
         }
-        if (std::find(changed.begin(), changed.end(), i) != changed.end()) {
+        if (changed.find(i) != changed.end()) {
             opt_subs[funcs[i].first] = function_symbol(
                 func_class, arg_tracker.get_args_in_value_order(
                                 arg_tracker.func_to_argset[i]));
@@ -313,7 +306,7 @@ public:
     umap_basic_basic &opt_subs;
     set_basic adds;
     set_basic muls;
-    set_basic seen_subexp;
+    uset_basic seen_subexp;
     OptsCSEVisitor(umap_basic_basic &opt_subs_) : opt_subs(opt_subs_)
     {
     }
@@ -423,8 +416,8 @@ class RebuildVisitor : public BaseVisitor<RebuildVisitor, TransformVisitor>
 private:
     umap_basic_basic &subs;
     umap_basic_basic &opt_subs;
-    set_basic &to_eliminate;
-    set_basic &excluded_symbols;
+    uset_basic &to_eliminate;
+    uset_basic &excluded_symbols;
     vec_pair &replacements;
     unsigned next_symbol_index = 0;
 
@@ -432,7 +425,7 @@ public:
     using TransformVisitor::result_;
     using TransformVisitor::bvisit;
     RebuildVisitor(umap_basic_basic &subs_, umap_basic_basic &opt_subs_,
-                   set_basic &to_eliminate_, set_basic &excluded_symbols_,
+                   uset_basic &to_eliminate_, uset_basic &excluded_symbols_,
                    vec_pair &replacements_)
         : subs(subs_), opt_subs(opt_subs_), to_eliminate(to_eliminate_),
           excluded_symbols(excluded_symbols_), replacements(replacements_)
@@ -496,9 +489,9 @@ public:
 void tree_cse(vec_pair &replacements, vec_basic &reduced_exprs,
               const vec_basic &exprs, umap_basic_basic &opt_subs)
 {
-    set_basic to_eliminate;
-    set_basic seen_subexp;
-    set_basic excluded_symbols;
+    uset_basic to_eliminate;
+    uset_basic seen_subexp;
+    uset_basic excluded_symbols;
 
     std::function<void(RCP<const Basic> & expr)> find_repeated;
     find_repeated = [&](RCP<const Basic> expr) -> void {
@@ -554,4 +547,68 @@ void cse(vec_pair &replacements, vec_basic &reduced_exprs,
     // Main CSE algorithm.
     tree_cse(replacements, reduced_exprs, exprs, opt_subs);
 }
+
+StraightLineProgram::StraightLineProgram(const vec_basic &inputs,
+                                         const vec_basic &outputs)
+    : inputs_(inputs)
+{
+    cse(instructions_, outputs_, outputs);
+
+    const unsigned n = numeric_cast<unsigned>(instructions_.size());
+    umap_basic_uint temporaries;
+    for (unsigned i = 0; i < n; i++) {
+        insert(temporaries, instructions_[i].first, i);
+    }
+
+    // A temporary that is never read dies right after it is assigned
+    last_use_.resize(n);
+    for (unsigned i = 0; i < n; i++) {
+        last_use_[i] = i;
+    }
+    auto mark_uses = [&](const Basic &b, unsigned pos) {
+        for (const auto &s : free_symbols(b)) {
+            auto it = temporaries.find(s);
+            if (it != temporaries.end()) {
+                last_use_[it->second] = pos;
+            }
+        }
+    };
+    for (unsigned i = 0; i < n; i++) {
+        mark_uses(*instructions_[i].second, i);
+    }
+    for (auto &e : outputs_) {
+        mark_uses(*e, n);
+    }
+
+    // Linear scan register allocation. The operands dying at instruction `i`
+    // are released before its result is allocated, as the right hand side is
+    // evaluated before the assignment.
+    std::vector<std::vector<unsigned>> dying(n);
+    for (unsigned i = 0; i < n; i++) {
+        if (last_use_[i] < n) {
+            dying[last_use_[i]].push_back(i);
+        }
+    }
+    std::priority_queue<unsigned, std::vector<unsigned>,
+                        std::greater<unsigned>>
+        free_registers;
+    registers_.resize(n);
+    nregisters_ = 0;
+    for (unsigned i = 0; i < n; i++) {
+        for (unsigned t : dying[i]) {
+            if (t != i) {
+                free_registers.push(registers_[t]);
+            }
+        }
+        if (free_registers.empty()) {
+            registers_[i] = nregisters_++;
+        } else {
+            registers_[i] = free_registers.top();
+            free_registers.pop();
+        }
+        if (last_use_[i] == i) {
+            free_registers.push(registers_[i]);
+        }
+    }
+}
 }
@@ -0,0 +1,65 @@
+/**
+ *  \file cse.h
+ *  Straight-line programs built by common subexpression elimination
+ *
+ **/
+
+#ifndef SYMENGINE_CSE_H
+#define SYMENGINE_CSE_H
+
+#include <symengine/basic.h>
+
+namespace SymEngine
+{
+
+//! A straight-line program evaluating `outputs` in terms of `inputs`.
+//! Instruction `i` assigns `get_instructions()[i].second`, which only refers
+//! to the inputs and to earlier temporaries, to the temporary symbol
+//! `get_instructions()[i].first`. The outputs are expressed in terms of the
+//! inputs and the temporaries.
+class StraightLineProgram
+{
+private:
+    vec_basic inputs_;
+    vec_pair instructions_;
+    vec_basic outputs_;
+    std::vector<unsigned> last_use_;
+    std::vector<unsigned> registers_;
+    unsigned nregisters_;
+
+public:
+    //! Runs `cse` on `outputs` and computes the liveness of the temporaries
+    StraightLineProgram(const vec_basic &inputs, const vec_basic &outputs);
+
+    inline const vec_basic &get_inputs() const
+    {
+        return inputs_;
+    }
+    inline const vec_pair &get_instructions() const
+    {
+        return instructions_;
+    }
+    inline const vec_basic &get_outputs() const
+    {
+        return outputs_;
+    }
+    //! Index of the last instruction reading temporary `i`. It is the number
+    //! of instructions if the temporary is read by one of the outputs.
+    inline const std::vector<unsigned> &get_last_use() const
+    {
+        return last_use_;
+    }
+    //! Register holding temporary `i`. Temporaries with disjoint live ranges
+    //! share a register.
+    inline const std::vector<unsigned> &get_registers() const
+    {
+        return registers_;
+    }
+    inline unsigned get_nregisters() const
+    {
+        return nregisters_;
+    }
+};
+}
+
+#endif
@@ -1,14 +1,33 @@
 #include <symengine/matrix.h>
 #include <symengine/add.h>
 #include <symengine/pow.h>
+#include <symengine/real_double.h>
+#include <symengine/eval_double.h>
 #include <symengine/subs.h>
 #include <symengine/symengine_exception.h>
 #include <symengine/polys/uexprpoly.h>
+#include <symengine/polys/uintpoly.h>
+#include <symengine/polys/basic_conversions.h>
 #include <symengine/solve.h>
+#include <symengine/ntheory.h>
+#include <symengine/visitor.h>
+
+#include <random>
+#if defined(WITH_SYMENGINE_THREAD_SAFE)
+#include <mutex>
+#endif
 
 namespace SymEngine
 {
 
+// Element domains of the numeric fast paths defined further down, which
+// the methods and products below dispatch on
+namespace
+{
+enum class NumericDomain { Generic, Integer, Rational, Double };
+NumericDomain numeric_domain(const vec_basic &m);
+} // namespace
+
 // Constructors
 DenseMatrix::DenseMatrix()
 {
@@ -53,11 +72,20 @@ void DenseMatrix::set(unsigned i, unsigned j, const RCP<const Basic> &e)
 
 unsigned DenseMatrix::rank() const
 {
+    const NumericDomain domain = numeric_domain(m_);
+    if (domain == NumericDomain::Integer or domain == NumericDomain::Rational)
+        return rank_multimodular(*this);
     throw NotImplementedError("Not Implemented");
 }
 
 RCP<const Basic> DenseMatrix::det() const
 {
+    if (row_ >= 16) {
+        const NumericDomain domain = numeric_domain(m_);
+        if (domain == NumericDomain::Integer
+            or domain == NumericDomain::Rational)
+            return det_multimodular(*this);
+    }
     return det_bareis(*this);
 }
 
@@ -235,6 +263,32 @@ void sjacobian(const DenseMatrix &A, const DenseMatrix &x, DenseMatrix &result)
     }
 }
 
+void hessian(const RCP<const Basic> &f, const DenseMatrix &x,
+             DenseMatrix &result)
+{
+    SYMENGINE_ASSERT(x.col_ == 1);
+    SYMENGINE_ASSERT(x.row_ == result.nrows() and x.row_ == result.ncols());
+
+    unsigned n = x.row_;
+    vec_basic grad(n);
+    for (unsigned i = 0; i < n; i++) {
+        if (not is_a<Symbol>(*(x.m_[i])))
+            throw SymEngineException("'x' must contain Symbols only");
+        grad[i] = f->diff(rcp_static_cast<const Symbol>(x.m_[i]));
+    }
+
+// Only the upper triangle is differentiated, so the rows get shorter as `i`
+// increases and are handed out dynamically to balance the load.
+#pragma omp parallel for schedule(dynamic)
+    for (unsigned i = 0; i < n; i++) {
+        for (unsigned j = i; j < n; j++) {
+            result.m_[i * n + j]
+                = grad[i]->diff(rcp_static_cast<const Symbol>(x.m_[j]));
+            result.m_[j * n + i] = result.m_[i * n + j];
+        }
+    }
+}
+
 // ---------------------------- Diff -------------------------------------//
 
 void diff(const DenseMatrix &A, const RCP<const Symbol> &x, DenseMatrix &result)
@@ -327,21 +381,288 @@ void add_dense_scalar(const DenseMatrix &A, const RCP<const Basic> &k,
 }
 
 // ------------------------------- Matrix Multiplication ---------------------//
+// Sum of a[i * a_stride] * b[i * b_stride] for i < n. The terms are collected
+// into a single Add dictionary and numeric products are folded into the
+// coefficient, so the sum is canonicalized only once.
+static RCP<const Basic> dot_product(const RCP<const Basic> *a,
+                                    unsigned a_stride,
+                                    const RCP<const Basic> *b,
+                                    unsigned b_stride, unsigned n)
+{
+    umap_basic_num d;
+    RCP<const Number> coef = zero;
+    for (unsigned i = 0; i < n; i++, a += a_stride, b += b_stride) {
+        if (is_a_Number(**a) and is_a_Number(**b)) {
+            iaddnum(outArg(coef), mulnum(rcp_static_cast<const Number>(*a),
+                                         rcp_static_cast<const Number>(*b)));
+        } else {
+            Add::coef_dict_add_term(outArg(coef), d, one, mul(*a, *b));
+        }
+    }
+    return Add::from_dict(coef, std::move(d));
+}
+
+// Products of matrices of Integers and Rationals are computed on arrays of
+// integer_class. Rows of the left factor and columns of the right factor are
+// scaled by the lcm of their denominators, so only one division per entry of
+// the product is needed at the end.
+namespace
+{
+
+// Row-major matrix of integer_class
+struct IntegerMatrix {
+    unsigned row, col;
+    std::vector<integer_class> m;
+
+    IntegerMatrix(unsigned row, unsigned col)
+        : row(row), col(col), m((size_t)row * col)
+    {
+    }
+    integer_class &operator()(unsigned i, unsigned j)
+    {
+        return m[(size_t)i * col + j];
+    }
+    const integer_class &operator()(unsigned i, unsigned j) const
+    {
+        return m[(size_t)i * col + j];
+    }
+};
+
+// Copy of the r x c block of `A` whose top left entry is A(i, j)
+IntegerMatrix block(const IntegerMatrix &A, unsigned i, unsigned j, unsigned r,
+                    unsigned c)
+{
+    IntegerMatrix B(r, c);
+    for (unsigned s = 0; s < r; s++)
+        for (unsigned t = 0; t < c; t++)
+            B(s, t) = A(i + s, j + t);
+    return B;
+}
+
+IntegerMatrix operator+(const IntegerMatrix &A, const IntegerMatrix &B)
+{
+    IntegerMatrix C(A.row, A.col);
+    for (size_t i = 0; i < C.m.size(); i++)
+        C.m[i] = A.m[i] + B.m[i];
+    return C;
+}
+
+IntegerMatrix operator-(const IntegerMatrix &A, const IntegerMatrix &B)
+{
+    IntegerMatrix C(A.row, A.col);
+    for (size_t i = 0; i < C.m.size(); i++)
+        C.m[i] = A.m[i] - B.m[i];
+    return C;
+}
+
+// C += A * B. C is computed in tiles so that the panel of B read by a tile
+// stays in cache, and tiles of rows are split among threads.
+void mul_classical(const IntegerMatrix &A, const IntegerMatrix &B,
+                   IntegerMatrix &C)
+{
+    const unsigned row = A.row, inner = A.col, col = B.col;
+    const unsigned block = 32;
+    const unsigned nblocks = (row + block - 1) / block;
+#pragma omp parallel for schedule(dynamic)                                     \
+    if (nblocks > 1 and (unsigned long)row * col * inner > 100000)
+    for (unsigned rb = 0; rb < nblocks; rb++) {
+        const unsigned r_end = std::min(row, (rb + 1) * block);
+        for (unsigned kb = 0; kb < inner; kb += block) {
+            const unsigned k_end = std::min(inner, kb + block);
+            for (unsigned cb = 0; cb < col; cb += block) {
+                const unsigned c_end = std::min(col, cb + block);
+                for (unsigned r = rb * block; r < r_end; r++) {
+                    for (unsigned k = kb; k < k_end; k++) {
+                        const integer_class &a = A(r, k);
+                        if (a == 0)
+                            continue;
+                        for (unsigned c = cb; c < c_end; c++)
+                            mp_addmul(C(r, c), a, B(k, c));
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Dimension below which the additions of a Strassen-Winograd step cost more
+// than the multiplications they save. Multiplications get relatively more
+// expensive as the entries grow, so the threshold drops with their size.
+unsigned winograd_threshold(const IntegerMatrix &A, const IntegerMatrix &B)
+{
+    integer_class m(0), b;
+    for (const auto &x : A.m)
+        if (mp_abs(x) > m)
+            m = mp_abs(x);
+    for (const auto &x : B.m)
+        if (mp_abs(x) > m)
+            m = mp_abs(x);
+    mp_pow_ui(b, integer_class(2), 128);
+    if (m < b)
+        return 128;
+    mp_pow_ui(b, integer_class(2), 1024);
+    return m < b ? 64 : 32;
+}
+
+// A * B by the Strassen-Winograd recursion, which needs 7 products of half
+// the size and 15 additions. An odd last row or column is peeled off and
+// handled by the classical method. The 7 products of the top level run in
+// parallel. Products with a dimension below `threshold` are computed by the
+// classical method.
+IntegerMatrix mul_winograd(const IntegerMatrix &A, const IntegerMatrix &B,
+                           unsigned threshold)
+{
+    const unsigned m = A.row, k = A.col, n = B.col;
+    IntegerMatrix C(m, n);
+    if (std::min(m, std::min(k, n)) < threshold) {
+        mul_classical(A, B, C);
+        return C;
+    }
+    const unsigned h = m / 2, l = k / 2, w = n / 2;
+    const IntegerMatrix A11 = block(A, 0, 0, h, l), A12 = block(A, 0, l, h, l),
+                        A21 = block(A, h, 0, h, l), A22 = block(A, h, l, h, l);
+    const IntegerMatrix B11 = block(B, 0, 0, l, w), B12 = block(B, 0, w, l, w),
+                        B21 = block(B, l, 0, l, w), B22 = block(B, l, w, l, w);
+
+    const IntegerMatrix S1 = A21 + A22, S2 = S1 - A11, S3 = A11 - A21,
+                        S4 = A12 - S2;
+    const IntegerMatrix T1 = B12 - B11, T2 = B22 - T1, T3 = B22 - B12,
+                        T4 = T2 - B21;
+
+    const IntegerMatrix *X[7] = {&A11, &A12, &S4, &A22, &S1, &S2, &S3};
+    const IntegerMatrix *Y[7] = {&B11, &B21, &B22, &T4, &T1, &T2, &T3};
+    std::vector<IntegerMatrix> P(7, IntegerMatrix(0, 0));
+#pragma omp parallel for schedule(dynamic)
+    for (unsigned i = 0; i < 7; i++)
+        P[i] = mul_winograd(*X[i], *Y[i], threshold);
+
+    const IntegerMatrix U2 = P[0] + P[5], U3 = U2 + P[6];
+    const IntegerMatrix C11 = P[0] + P[1], C12 = U2 + P[4] + P[2],
+                        C21 = U3 - P[3], C22 = U3 + P[4];
+    for (unsigned i = 0; i < h; i++) {
+        for (unsigned j = 0; j < w; j++) {
+            C(i, j) = C11(i, j);
+            C(i, j + w) = C12(i, j);
+            C(i + h, j) = C21(i, j);
+            C(i + h, j + w) = C22(i, j);
+        }
+    }
+
+    if (k % 2 == 1) {
+        for (unsigned i = 0; i < 2 * h; i++)
+            for (unsigned j = 0; j < 2 * w; j++)
+                mp_addmul(C(i, j), A(i, k - 1), B(k - 1, j));
+    }
+    if (n % 2 == 1) {
+        for (unsigned i = 0; i < 2 * h; i++)
+            for (unsigned t = 0; t < k; t++)
+                mp_addmul(C(i, n - 1), A(i, t), B(t, n - 1));
+    }
+    if (m % 2 == 1) {
+        for (unsigned j = 0; j < n; j++)
+            for (unsigned t = 0; t < k; t++)
+                mp_addmul(C(m - 1, j), A(m - 1, t), B(t, j));
+    }
+    return C;
+}
+
+// Computes C = A * B, where A is row x inner and B is inner x col, if both
+// have Integer and Rational entries only. Returns false otherwise.
+bool mul_numeric(const vec_basic &A, const vec_basic &B, unsigned row,
+                 unsigned inner, unsigned col, vec_basic &C)
+{
+    const NumericDomain da = numeric_domain(A), db = numeric_domain(B);
+    if ((da != NumericDomain::Integer and da != NumericDomain::Rational)
+        or (db != NumericDomain::Integer and db != NumericDomain::Rational))
+        return false;
+
+    std::vector<integer_class> row_den(row, integer_class(1)),
+        col_den(col, integer_class(1));
+    for (unsigned i = 0; i < row; i++)
+        for (unsigned j = 0; j < inner; j++)
+            if (is_a<Rational>(*A[i * inner + j]))
+                mp_lcm(row_den[i], row_den[i],
+                       get_den(down_cast<const Rational &>(*A[i * inner + j])
+                                   .as_rational_class()));
+    for (unsigned i = 0; i < inner; i++)
+        for (unsigned j = 0; j < col; j++)
+            if (is_a<Rational>(*B[i * col + j]))
+                mp_lcm(col_den[j], col_den[j],
+                       get_den(down_cast<const Rational &>(*B[i * col + j])
+                                   .as_rational_class()));
+
+    IntegerMatrix a(row, inner), b(inner, col);
+    for (unsigned i = 0; i < row; i++) {
+        for (unsigned j = 0; j < inner; j++) {
+            const Basic &e = *A[i * inner + j];
+            if (is_a<Integer>(e)) {
+                a(i, j) = down_cast<const Integer &>(e).as_integer_class()
+                          * row_den[i];
+            } else {
+                const rational_class &q
+                    = down_cast<const Rational &>(e).as_rational_class();
+                a(i, j) = get_num(q) * (row_den[i] / get_den(q));
+            }
+        }
+    }
+    for (unsigned i = 0; i < inner; i++) {
+        for (unsigned j = 0; j < col; j++) {
+            const Basic &e = *B[i * col + j];
+            if (is_a<Integer>(e)) {
+                b(i, j) = down_cast<const Integer &>(e).as_integer_class()
+                          * col_den[j];
+            } else {
+                const rational_class &q
+                    = down_cast<const Rational &>(e).as_rational_class();
+                b(i, j) = get_num(q) * (col_den[j] / get_den(q));
+            }
+        }
+    }
+
+    const IntegerMatrix c = mul_winograd(a, b, winograd_threshold(a, b));
+    rational_class q;
+    for (unsigned i = 0; i < row; i++) {
+        for (unsigned j = 0; j < col; j++) {
+            if (row_den[i] == 1 and col_den[j] == 1) {
+                C[i * col + j] = integer(c(i, j));
+            } else {
+                q = rational_class(c(i, j), row_den[i] * col_den[j]);
+                canonicalize(q);
+                C[i * col + j] = Rational::from_mpq(q);
+            }
+        }
+    }
+    return true;
+}
+} // namespace
+
 void mul_dense_dense(const DenseMatrix &A, const DenseMatrix &B, DenseMatrix &C)
 {
     SYMENGINE_ASSERT(A.col_ == B.row_ and C.row_ == A.row_
                      and C.col_ == B.col_);
 
-    unsigned row = A.row_, col = B.col_;
+    unsigned row = A.row_, col = B.col_, inner = A.col_;
 
     if (&A != &C and &B != &C) {
-        for (unsigned r = 0; r < row; r++) {
-            for (unsigned c = 0; c < col; c++) {
-                C.m_[r * col + c] = zero; // Integer Zero
-                for (unsigned k = 0; k < A.col_; k++)
-                    C.m_[r * col + c]
-                        = add(C.m_[r * col + c],
-                              mul(A.m_[r * A.col_ + k], B.m_[k * col + c]));
+        if (mul_numeric(A.m_, B.m_, row, inner, col, C.m_))
+            return;
+        // C is computed in tiles so that the rows of A and the panel of B
+        // read by a tile stay in cache. Tiles of rows are independent and
+        // are split among threads when the product is large enough.
+        const unsigned block = 32;
+        const unsigned nblocks = (row + block - 1) / block;
+#pragma omp parallel for schedule(dynamic)                                     \
+    if (nblocks > 1 and (unsigned long)row * col * inner > 100000)
+        for (unsigned rb = 0; rb < nblocks; rb++) {
+            const unsigned r_end = std::min(row, (rb + 1) * block);
+            for (unsigned cb = 0; cb < col; cb += block) {
+                const unsigned c_end = std::min(col, cb + block);
+                for (unsigned r = rb * block; r < r_end; r++) {
+                    for (unsigned c = cb; c < c_end; c++) {
+                        C.m_[r * col + c] = dot_product(
+                            &A.m_[r * inner], 1, &B.m_[c], col, inner);
+                    }
+                }
             }
         }
     } else {
@@ -506,6 +827,320 @@ void column_exchange_dense(DenseMatrix &A, unsigned i, unsigned j)
         std::swap(A.m_[k * col + i], A.m_[k * col + j]);
 }
 
+// ------------------------------ Numeric Fast Paths -------------------------//
+
+// Matrices whose entries are all Integers and Rationals, or all RealDoubles,
+// are eliminated on arrays of integer_class, rational_class or double and
+// converted back to Basic once at the end. The kernels follow the operation
+// order of the generic algorithms below, so both paths agree. A kernel gives
+// up and the generic algorithm runs whenever it would divide by zero.
+namespace
+{
+
+NumericDomain numeric_domain(const vec_basic &m)
+{
+    size_t nrational = 0, ndouble = 0;
+    for (const auto &e : m) {
+        if (is_a<Rational>(*e)) {
+            nrational++;
+        } else if (is_a<RealDouble>(*e)) {
+            ndouble++;
+        } else if (not is_a<Integer>(*e)) {
+            return NumericDomain::Generic;
+        }
+    }
+    if (m.empty() or (ndouble > 0 and ndouble < m.size()))
+        return NumericDomain::Generic;
+    if (ndouble > 0)
+        return NumericDomain::Double;
+    return nrational > 0 ? NumericDomain::Rational : NumericDomain::Integer;
+}
+
+template <typename T>
+struct Numeric;
+
+template <>
+struct Numeric<integer_class> {
+    static integer_class from_basic(const Basic &b)
+    {
+        return down_cast<const Integer &>(b).as_integer_class();
+    }
+    static RCP<const Basic> to_basic(const integer_class &x)
+    {
+        return integer(x);
+    }
+    static bool is_zero(const integer_class &x)
+    {
+        return x == 0;
+    }
+    // a = a / b, only when the division is exact
+    static bool div(integer_class &a, const integer_class &b)
+    {
+        if (b == 0)
+            return false;
+        integer_class q, r;
+        mp_tdiv_qr(q, r, a, b);
+        if (r != 0)
+            return false;
+        a = std::move(q);
+        return true;
+    }
+};
+
+template <>
+struct Numeric<rational_class> {
+    static rational_class from_basic(const Basic &b)
+    {
+        if (is_a<Integer>(b))
+            return rational_class(
+                down_cast<const Integer &>(b).as_integer_class());
+        return down_cast<const Rational &>(b).as_rational_class();
+    }
+    static RCP<const Basic> to_basic(const rational_class &x)
+    {
+        return Rational::from_mpq(x);
+    }
+    static bool is_zero(const rational_class &x)
+    {
+        return x == 0;
+    }
+    static bool div(rational_class &a, const rational_class &b)
+    {
+        if (b == 0)
+            return false;
+        a /= b;
+        return true;
+    }
+};
+
+template <>
+struct Numeric<double> {
+    static double from_basic(const Basic &b)
+    {
+        return down_cast<const RealDouble &>(b).i;
+    }
+    static RCP<const Basic> to_basic(double x)
+    {
+        return real_double(x);
+    }
+    // A RealDouble never compares equal to the Integer zero the generic
+    // algorithms test pivots against.
+    static bool is_zero(double x)
+    {
+        return false;
+    }
+    // div(a, b) is evaluated as a * b**(-1)
+    static bool div(double &a, double b)
+    {
+        if (b == 0.0)
+            return false;
+        a *= 1.0 / b;
+        return true;
+    }
+};
+
+template <typename T, typename Kernel>
+bool run_numeric(const vec_basic &m, vec_basic &out, Kernel &kernel)
+{
+    std::vector<T> v;
+    v.reserve(m.size());
+    for (const auto &e : m)
+        v.push_back(Numeric<T>::from_basic(*e));
+    if (not kernel(v))
+        return false;
+    out.resize(v.size());
+    for (size_t i = 0; i < v.size(); i++)
+        out[i] = Numeric<T>::to_basic(v[i]);
+    return true;
+}
+
+// Runs `kernel` on the entries of `m` and stores the result in `out`. Returns
+// false, leaving `out` untouched, if `m` is not numeric or the kernel gave up.
+// Integer matrices are promoted to rational_class unless `integer_exact` says
+// that the kernel only performs exact integer divisions.
+template <typename Kernel>
+bool numeric_dispatch(const vec_basic &m, vec_basic &out, Kernel &kernel,
+                      bool integer_exact)
+{
+    switch (numeric_domain(m)) {
+        case NumericDomain::Integer:
+            if (integer_exact)
+                return run_numeric<integer_class>(m, out, kernel);
+            return run_numeric<rational_class>(m, out, kernel);
+        case NumericDomain::Rational:
+            return run_numeric<rational_class>(m, out, kernel);
+        case NumericDomain::Double:
+            return run_numeric<double>(m, out, kernel);
+        default:
+            return false;
+    }
+}
+
+// Numeric `fraction_free_gaussian_elimination` and `fraction_free_LU`. The
+// latter keeps the entries below the diagonal.
+struct FractionFreeElimination {
+    unsigned row, col;
+    bool zero_below;
+
+    template <typename T>
+    bool operator()(std::vector<T> &b) const
+    {
+        T t;
+        for (unsigned i = 0; i + 1 < col; i++) {
+            for (unsigned j = i + 1; j < row; j++) {
+                for (unsigned k = i + 1; k < col; k++) {
+                    t = b[j * col + i] * b[i * col + k];
+                    b[j * col + k] = b[i * col + i] * b[j * col + k] - t;
+                    if (i > 0
+                        and not Numeric<T>::div(b[j * col + k],
+                                                b[(i - 1) * col + i - 1]))
+                        return false;
+                }
+                if (zero_below)
+                    b[j * col + i] = T(0);
+            }
+        }
+        return true;
+    }
+};
+
+// Numeric `LU` and `pivoted_LU`, storing L below the diagonal of U
+struct LUDecomposition {
+    unsigned n;
+    permutelist *pl;
+
+    template <typename T>
+    bool operator()(std::vector<T> &u) const
+    {
+        permutelist swaps;
+        for (unsigned j = 0; j < n; j++) {
+            for (unsigned i = 0; i < j; i++)
+                for (unsigned k = 0; k < i; k++)
+                    u[i * n + j] -= u[i * n + k] * u[k * n + j];
+            unsigned p = n;
+            for (unsigned i = j; i < n; i++) {
+                for (unsigned k = 0; k < j; k++)
+                    u[i * n + j] -= u[i * n + k] * u[k * n + j];
+                if (p == n and not Numeric<T>::is_zero(u[i * n + j]))
+                    p = i;
+            }
+            if (pl != nullptr) {
+                if (p == n)
+                    throw SymEngineException("Matrix is rank deficient");
+                if (p != j) {
+                    std::swap_ranges(u.begin() + p * n, u.begin() + p * n + n,
+                                     u.begin() + j * n);
+                    swaps.push_back({p, j});
+                }
+            }
+            T scale(1);
+            if (not Numeric<T>::div(scale, u[j * n + j]))
+                return false;
+            for (unsigned i = j + 1; i < n; i++)
+                u[i * n + j] *= scale;
+        }
+        if (pl != nullptr)
+            pl->insert(pl->end(), swaps.begin(), swaps.end());
+        return true;
+    }
+};
+
+// Numeric `det_bareis` for n > 3
+struct BareissDeterminant {
+    unsigned n;
+    RCP<const Basic> det;
+
+    template <typename T>
+    bool operator()(std::vector<T> &b)
+    {
+        bool negate = false;
+        T t;
+        for (unsigned k = 0; k + 1 < n; k++) {
+            if (Numeric<T>::is_zero(b[k * n + k])) {
+                unsigned i = k + 1;
+                while (i < n and Numeric<T>::is_zero(b[i * n + k]))
+                    i++;
+                if (i == n) {
+                    det = zero;
+                    return true;
+                }
+                std::swap_ranges(b.begin() + i * n, b.begin() + i * n + n,
+                                 b.begin() + k * n);
+                negate = not negate;
+            }
+            for (unsigned i = k + 1; i < n; i++) {
+                for (unsigned j = k + 1; j < n; j++) {
+                    t = b[i * n + k] * b[k * n + j];
+                    b[i * n + j] = b[k * n + k] * b[i * n + j] - t;
+                    if (k > 0
+                        and not Numeric<T>::div(b[i * n + j],
+                                                b[(k - 1) * n + k - 1]))
+                        return false;
+                }
+            }
+        }
+        T d = b[n * n - 1];
+        det = Numeric<T>::to_basic(negate ? T(-d) : d);
+        return true;
+    }
+};
+
+// Inverse of an exact matrix by Gauss-Jordan elimination on [A | I]. The
+// inverse is unique, so it matches every generic inversion algorithm.
+struct ExactInverse {
+    unsigned n;
+
+    template <typename T>
+    bool operator()(std::vector<T> &a) const
+    {
+        std::vector<T> inv(n * n, T(0));
+        for (unsigned i = 0; i < n; i++)
+            inv[i * n + i] = T(1);
+        for (unsigned j = 0; j < n; j++) {
+            unsigned p = j;
+            while (p < n and Numeric<T>::is_zero(a[p * n + j]))
+                p++;
+            if (p == n)
+                return false;
+            if (p != j) {
+                std::swap_ranges(a.begin() + p * n, a.begin() + p * n + n,
+                                 a.begin() + j * n);
+                std::swap_ranges(inv.begin() + p * n,
+                                 inv.begin() + p * n + n, inv.begin() + j * n);
+            }
+            T scale(1);
+            Numeric<T>::div(scale, a[j * n + j]);
+            for (unsigned k = 0; k < n; k++) {
+                a[j * n + k] *= scale;
+                inv[j * n + k] *= scale;
+            }
+            for (unsigned i = 0; i < n; i++) {
+                if (i == j or Numeric<T>::is_zero(a[i * n + j]))
+                    continue;
+                const T f = a[i * n + j];
+                for (unsigned k = 0; k < n; k++) {
+                    a[i * n + k] -= f * a[j * n + k];
+                    inv[i * n + k] -= f * inv[j * n + k];
+                }
+            }
+        }
+        a.swap(inv);
+        return true;
+    }
+};
+
+// Stores the inverse of the n x n matrix `a` in `out` if `a` is an invertible
+// exact matrix
+bool exact_inverse(const vec_basic &a, unsigned n, vec_basic &out)
+{
+    if (numeric_domain(a) == NumericDomain::Double)
+        return false;
+    ExactInverse kernel{n};
+    return numeric_dispatch(a, out, kernel, false);
+}
+
+} // namespace
+
 // ------------------------------ Gaussian Elimination -----------------------//
 void pivoted_gaussian_elimination(const DenseMatrix &A, DenseMatrix &B,
                                   permutelist &pl)
@@ -553,6 +1188,15 @@ void fraction_free_gaussian_elimination(const DenseMatrix &A, DenseMatrix &B)
     SYMENGINE_ASSERT(A.row_ == B.row_ and A.col_ == B.col_);
 
     unsigned col = A.col_;
+
+    FractionFreeElimination kernel{A.row_, col, true};
+    if (numeric_dispatch(A.m_, B.m_, kernel, true)) {
+        for (unsigned i = 0; i + 1 < col; i++)
+            for (unsigned j = i + 1; j < A.row_; j++)
+                B.m_[j * col + i] = zero;
+        return;
+    }
+
     B.m_ = A.m_;
 
     for (unsigned i = 0; i < col - 1; i++)
@@ -569,21 +1213,25 @@ void fraction_free_gaussian_elimination(const DenseMatrix &A, DenseMatrix &B)
         }
 }
 
-// Pivoted version of `fraction_free_gaussian_elimination`
+// Pivoted version of `fraction_free_gaussian_elimination`. Columns without a
+// pivot are skipped, and the divisor of each step is the previous pivot.
 void pivoted_fraction_free_gaussian_elimination(const DenseMatrix &A,
-                                                DenseMatrix &B, permutelist &pl)
+                                                DenseMatrix &B, permutelist &pl,
+                                                PivotStrategy strategy,
+                                                ZeroTest zero_test)
 {
     SYMENGINE_ASSERT(A.row_ == B.row_ and A.col_ == B.col_);
 
     unsigned col = A.col_, row = A.row_;
     unsigned index = 0, i, k, j;
+    RCP<const Basic> d;
     B.m_ = A.m_;
 
     for (i = 0; i < col - 1; i++) {
         if (index == row)
             break;
 
-        k = pivot(B, index, i);
+        k = pivot(B, index, i, strategy, zero_test);
         if (k == row)
             continue;
         if (k != index) {
@@ -591,18 +1239,18 @@ void pivoted_fraction_free_gaussian_elimination(const DenseMatrix &A,
             pl.push_back({k, index});
         }
 
-        for (j = i + 1; j < row; j++) {
+        for (j = index + 1; j < row; j++) {
             for (k = i + 1; k < col; k++) {
                 B.m_[j * col + k]
-                    = sub(mul(B.m_[i * col + i], B.m_[j * col + k]),
-                          mul(B.m_[j * col + i], B.m_[i * col + k]));
-                if (i > 0)
-                    B.m_[j * col + k]
-                        = div(B.m_[j * col + k], B.m_[i * col - col + i - 1]);
+                    = sub(mul(B.m_[index * col + i], B.m_[j * col + k]),
+                          mul(B.m_[j * col + i], B.m_[index * col + k]));
+                if (index > 0)
+                    B.m_[j * col + k] = div(B.m_[j * col + k], d);
             }
             B.m_[j * col + i] = zero;
         }
 
+        d = B.m_[index * col + i];
         index++;
     }
 }
@@ -680,7 +1328,9 @@ void fraction_free_gauss_jordan_elimination(const DenseMatrix &A,
 
 void pivoted_fraction_free_gauss_jordan_elimination(const DenseMatrix &A,
                                                     DenseMatrix &B,
-                                                    permutelist &pl)
+                                                    permutelist &pl,
+                                                    PivotStrategy strategy,
+                                                    ZeroTest zero_test)
 {
     SYMENGINE_ASSERT(A.row_ == B.row_ and A.col_ == B.col_);
 
@@ -694,7 +1344,7 @@ void pivoted_fraction_free_gauss_jordan_elimination(const DenseMatrix &A,
         if (index == row)
             break;
 
-        k = pivot(B, index, i);
+        k = pivot(B, index, i, strategy, zero_test);
         if (k == row)
             continue;
         if (k != index) {
@@ -702,38 +1352,629 @@ void pivoted_fraction_free_gauss_jordan_elimination(const DenseMatrix &A,
             pl.push_back({k, index});
         }
 
-        if (i > 0)
-            d = B.m_[i * col - col + i - 1];
         for (j = 0; j < row; j++) {
-            if (j != i)
+            if (j != index)
                 for (k = 0; k < col; k++) {
                     if (k != i) {
                         B.m_[j * col + k]
-                            = sub(mul(B.m_[i * col + i], B.m_[j * col + k]),
-                                  mul(B.m_[j * col + i], B.m_[i * col + k]));
-                        if (i > 0)
+                            = sub(mul(B.m_[index * col + i], B.m_[j * col + k]),
+                                  mul(B.m_[j * col + i],
+                                      B.m_[index * col + k]));
+                        if (index > 0)
                             B.m_[j * col + k] = div(B.m_[j * col + k], d);
                     }
                 }
         }
 
         for (j = 0; j < row; j++)
-            if (j != i)
+            if (j != index)
                 B.m_[j * col + i] = zero;
 
+        d = B.m_[index * col + i];
         index++;
     }
 }
 
-unsigned pivot(DenseMatrix &B, unsigned r, unsigned c)
+namespace
+{
+
+// Number of nodes in the expression tree of `e`
+size_t expression_size(const Basic &e)
+{
+    size_t n = 1;
+    for (const auto &a : e.get_args())
+        n += expression_size(*a);
+    return n;
+}
+
+// Bound on the absolute value of `e` at `point`, obtained by replacing every
+// sum by the sum of the absolute values of its terms. A value of `e` that is
+// small compared to this bound comes from cancellation. A bound on the base
+// of a negative power bounds the power from below, so that base is
+// evaluated instead.
+double probe_magnitude(const RCP<const Basic> &e, const map_basic_basic &point)
+{
+    double m;
+    if (is_a<Add>(*e)) {
+        m = 0;
+        for (const auto &a : e->get_args())
+            m += probe_magnitude(a, point);
+    } else if (is_a<Mul>(*e)) {
+        m = 1;
+        for (const auto &a : e->get_args())
+            m *= probe_magnitude(a, point);
+    } else if (is_a<Pow>(*e)
+               and is_a_Number(*down_cast<const Pow &>(*e).get_exp())) {
+        const Pow &p = down_cast<const Pow &>(*e);
+        const double power = eval_double(*p.get_exp());
+        const double base
+            = power < 0 ? std::abs(eval_double(*p.get_base()->subs(point)))
+                        : probe_magnitude(p.get_base(), point);
+        m = std::pow(base, power);
+    } else {
+        m = std::abs(eval_double(*e->subs(point)));
+    }
+    return m;
+}
+
+// Zero test of `ZeroTest::NumericProbe`. The free symbols of `e` are set to
+// pseudo-random values in [1/2, 2] and `e` is nonzero if one of the values is
+// not small compared to `probe_magnitude`. The points are the same on every
+// call, so the test is deterministic.
+bool probe_is_zero(const RCP<const Basic> &e)
+{
+    if (is_a_Number(*e))
+        return down_cast<const Number &>(*e).is_zero();
+    const set_basic symbols = free_symbols(*e);
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> dist(0.5, 2.0);
+    bool evaluated = false;
+    try {
+        for (unsigned trial = 0; trial < 3; trial++) {
+            map_basic_basic point;
+            for (const auto &x : symbols)
+                point[x] = real_double(dist(gen));
+            const double v = eval_double(*e->subs(point));
+            const double m = probe_magnitude(e, point);
+            if (not std::isfinite(v) or not std::isfinite(m))
+                continue;
+            evaluated = true;
+            if (std::abs(v) > 1e-10 * m)
+                return false;
+        }
+    } catch (SymEngineException &) {
+        return false;
+    }
+    return evaluated;
+}
+} // namespace
+
+unsigned pivot(DenseMatrix &B, unsigned r, unsigned c, PivotStrategy strategy,
+               ZeroTest zero_test)
 {
-    unsigned k = r;
+    const unsigned row = B.row_, col = B.col_;
+    auto is_zero = [&](const RCP<const Basic> &e) {
+        return zero_test == ZeroTest::Structural ? eq(*e, *zero)
+                                                 : probe_is_zero(e);
+    };
 
-    if (eq(*(B.m_[r * B.col_ + c]), *zero))
-        for (k = r; k < B.row_; k++)
-            if (neq(*(B.m_[k * B.col_ + c]), *zero))
+    if (strategy == PivotStrategy::FirstNonzero) {
+        unsigned k = r;
+        while (k < row and is_zero(B.m_[k * col + c]))
+            k++;
+        return k;
+    }
+
+    unsigned best = row;
+    size_t best_count = 0, best_size = 0;
+    for (unsigned k = r; k < row; k++) {
+        const RCP<const Basic> &e = B.m_[k * col + c];
+        if (is_zero(e))
+            continue;
+        size_t count = 0;
+        if (strategy == PivotStrategy::Markowitz)
+            for (unsigned j = c + 1; j < col; j++)
+                if (neq(*B.m_[k * col + j], *zero))
+                    count++;
+        const size_t size = expression_size(*e);
+        if (best == row or count < best_count
+            or (count == best_count and size < best_size)) {
+            best = k;
+            best_count = count;
+            best_size = size;
+        }
+    }
+    return best;
+}
+
+// ------------------------------ Multi-modular Methods ----------------------//
+
+namespace
+{
+
+// The first `count` primes below 2**31, in decreasing order. Residues modulo
+// these primes multiply without overflowing 64 bits. Candidates are tested by
+// trial division with the primes below 46341 and the result is cached; the
+// cache is shared between threads and guarded by a mutex in thread safe
+// builds.
+std::vector<uint64_t> modular_primes(size_t count)
+{
+    static std::vector<uint64_t> primes;
+    static std::vector<unsigned> small;
+#if defined(WITH_SYMENGINE_THREAD_SAFE)
+    static std::mutex lock;
+    std::lock_guard<std::mutex> guard(lock);
+#endif
+    if (small.empty()) {
+        // Sieve::generate_primes keeps an unguarded cache of its own
+        std::vector<bool> composite(46342, false);
+        for (unsigned q = 2; q < composite.size(); q++) {
+            if (composite[q])
+                continue;
+            small.push_back(q);
+            for (unsigned k = q * q; k < composite.size(); k += q)
+                composite[k] = true;
+        }
+    }
+    uint64_t c = primes.empty() ? 2147483647 : primes.back() - 2;
+    while (primes.size() < count) {
+        bool is_prime = true;
+        for (unsigned q : small) {
+            if (uint64_t(q) * q > c)
+                break;
+            if (c % q == 0) {
+                is_prime = false;
                 break;
-    return k;
+            }
+        }
+        if (is_prime)
+            primes.push_back(c);
+        c -= 2;
+    }
+    return std::vector<uint64_t>(primes.begin(), primes.begin() + count);
+}
+
+uint64_t inverse_mod(uint64_t a, uint64_t p)
+{
+    uint64_t r = 1, e = p - 2;
+    while (e > 0) {
+        if (e & 1)
+            r = r * a % p;
+        a = a * a % p;
+        e >>= 1;
+    }
+    return r;
+}
+
+// Scales each row of the Integer/Rational matrix `m` by the lcm of its
+// denominators. Returns false if `m` has other entries. `scale` is the
+// product of the row factors.
+bool to_integer_rows(const vec_basic &m, unsigned row, unsigned col,
+                     std::vector<integer_class> &a, integer_class &scale)
+{
+    const NumericDomain domain = numeric_domain(m);
+    if (domain != NumericDomain::Integer and domain != NumericDomain::Rational)
+        return false;
+    a.resize(m.size());
+    scale = 1;
+    integer_class l;
+    for (unsigned i = 0; i < row; i++) {
+        l = 1;
+        for (unsigned j = 0; j < col; j++) {
+            if (is_a<Rational>(*m[i * col + j]))
+                mp_lcm(l, l, get_den(down_cast<const Rational &>(
+                                         *m[i * col + j])
+                                         .as_rational_class()));
+        }
+        for (unsigned j = 0; j < col; j++) {
+            const Basic &e = *m[i * col + j];
+            if (is_a<Integer>(e)) {
+                a[i * col + j]
+                    = down_cast<const Integer &>(e).as_integer_class() * l;
+            } else {
+                const rational_class &q
+                    = down_cast<const Rational &>(e).as_rational_class();
+                a[i * col + j] = get_num(q) * (l / get_den(q));
+            }
+        }
+        scale *= l;
+    }
+    return true;
+}
+
+void reduce_mod(const std::vector<integer_class> &a, uint64_t p,
+                std::vector<uint64_t> &r)
+{
+    const integer_class P(p);
+    integer_class t;
+    r.resize(a.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        mp_fdiv_r(t, a[i], P);
+        r[i] = mp_get_ui(t);
+    }
+}
+
+// Row echelon form of `a` modulo `p`, reduced if `reduced` is true. Returns
+// the pivot columns and, for square matrices, stores the determinant in `det`.
+std::vector<unsigned> echelon_mod(std::vector<uint64_t> &a, unsigned row,
+                                  unsigned col, uint64_t p, bool reduced,
+                                  uint64_t &det)
+{
+    std::vector<unsigned> pivots;
+    det = 1;
+    unsigned r = 0;
+    for (unsigned c = 0; c < col and r < row; c++) {
+        unsigned k = r;
+        while (k < row and a[k * col + c] == 0)
+            k++;
+        if (k == row)
+            continue;
+        if (k != r) {
+            std::swap_ranges(a.begin() + k * col, a.begin() + k * col + col,
+                             a.begin() + r * col);
+            det = p - det;
+        }
+        det = det * a[r * col + c] % p;
+        const uint64_t inv = inverse_mod(a[r * col + c], p);
+        if (reduced) {
+            for (unsigned j = c; j < col; j++)
+                a[r * col + j] = a[r * col + j] * inv % p;
+        }
+        for (unsigned i = reduced ? 0 : r + 1; i < row; i++) {
+            if (i == r or a[i * col + c] == 0)
+                continue;
+            uint64_t f = a[i * col + c];
+            if (not reduced)
+                f = f * inv % p;
+            f = p - f;
+            for (unsigned j = c; j < col; j++)
+                a[i * col + j] = (a[i * col + j] + f * a[r * col + j]) % p;
+        }
+        pivots.push_back(c);
+        r++;
+    }
+    if (row != col or r < row)
+        det = 0;
+    return pivots;
+}
+
+// Adds the residues `r` modulo `p` to the residues `x` modulo `m` by CRT
+void crt_combine(std::vector<integer_class> &x, integer_class &m,
+                 const std::vector<uint64_t> &r, uint64_t p)
+{
+    const integer_class P(p);
+    integer_class t;
+    mp_fdiv_r(t, m, P);
+    const uint64_t minv = inverse_mod(mp_get_ui(t), p);
+    for (size_t i = 0; i < x.size(); i++) {
+        mp_fdiv_r(t, x[i], P);
+        const uint64_t d = (r[i] + p - mp_get_ui(t)) % p * minv % p;
+        mp_addmul(x[i], m, integer_class(d));
+    }
+    m *= P;
+}
+
+// Finds the fraction q with |num(q)|, den(q) <= sqrt(m / 2) congruent to `u`
+// modulo `m`, if there is one
+bool rational_reconstruction(rational_class &q, const integer_class &u,
+                             const integer_class &m)
+{
+    const integer_class bound = mp_sqrt(m / 2);
+    integer_class r0 = m, r1, t0 = 0, t1 = 1, quo, tmp;
+    mp_fdiv_r(r1, u, m);
+    while (r1 > bound) {
+        mp_fdiv_q(quo, r0, r1);
+        tmp = r0 - quo * r1;
+        r0 = r1;
+        r1 = tmp;
+        tmp = t0 - quo * t1;
+        t0 = t1;
+        t1 = tmp;
+    }
+    if (mp_abs(t1) > bound)
+        return false;
+    mp_gcd(tmp, r1, t1);
+    if (tmp != 1)
+        return false;
+    // boost::rational rejects negative denominators
+    if (t1 < 0) {
+        r1 = -r1;
+        t1 = -t1;
+    }
+    q = rational_class(r1, t1);
+    canonicalize(q);
+    return true;
+}
+
+// Reduced row echelon form over Q of the integer matrix `a`, reconstructed
+// from its images modulo word-size primes. Primes giving a lower rank or a
+// later pivot pattern than the others are unlucky and dropped. Images are
+// computed in parallel in batches of growing size, and after each batch the
+// reconstruction is accepted as soon as `check` confirms it. Only columns
+// `first` and later of the pivot rows are reconstructed into `rref`.
+template <typename Check>
+void rref_multimodular(const std::vector<integer_class> &a, unsigned row,
+                       unsigned col, unsigned first,
+                       std::vector<unsigned> &pivots,
+                       std::vector<rational_class> &rref, const Check &check)
+{
+    const unsigned width = col - first;
+    std::vector<integer_class> x;
+    integer_class m(1);
+    size_t used = 0, batch = 1;
+    pivots.clear();
+    bool have_pattern = false;
+    while (true) {
+        const std::vector<uint64_t> primes = modular_primes(used + batch);
+        std::vector<std::vector<uint64_t>> images(batch);
+        std::vector<std::vector<unsigned>> patterns(batch);
+#pragma omp parallel for schedule(dynamic)
+        for (size_t i = 0; i < batch; i++) {
+            uint64_t det;
+            reduce_mod(a, primes[used + i], images[i]);
+            patterns[i] = echelon_mod(images[i], row, col, primes[used + i],
+                                      true, det);
+        }
+        for (size_t i = 0; i < batch; i++) {
+            const std::vector<unsigned> &pat = patterns[i];
+            if (have_pattern) {
+                if (pat.size() < pivots.size()
+                    or (pat.size() == pivots.size() and pat > pivots))
+                    continue;
+                if (pat != pivots)
+                    have_pattern = false;
+            }
+            if (not have_pattern) {
+                pivots = pat;
+                have_pattern = true;
+                x.assign(pivots.size() * width, integer_class(0));
+                m = 1;
+            }
+            std::vector<uint64_t> &img = images[i];
+            for (unsigned r = 0; r < pivots.size(); r++)
+                std::copy(img.begin() + r * col + first,
+                          img.begin() + r * col + col,
+                          img.begin() + r * width);
+            img.resize(pivots.size() * width);
+            crt_combine(x, m, img, primes[used + i]);
+        }
+        used += batch;
+        batch = used / 4 + 1;
+
+        rref.resize(x.size());
+        bool ok = true;
+        for (size_t i = 0; i < x.size() and ok; i++)
+            ok = rational_reconstruction(rref[i], x[i], m);
+        if (ok and check(pivots, rref))
+            return;
+    }
+}
+
+// Whether a * v == 0 for the integer matrix `a` and each rational vector v
+// listed in the columns of the col x k matrix `v` (row-major)
+bool annihilates(const std::vector<integer_class> &a, unsigned row,
+                 unsigned col, const std::vector<rational_class> &v,
+                 unsigned k, const std::vector<integer_class> &b)
+{
+    integer_class den(1), s;
+    for (const auto &q : v)
+        mp_lcm(den, den, get_den(q));
+    std::vector<integer_class> w(v.size());
+    for (size_t i = 0; i < v.size(); i++)
+        w[i] = get_num(v[i]) * (den / get_den(v[i]));
+    for (unsigned i = 0; i < row; i++) {
+        for (unsigned j = 0; j < k; j++) {
+            s = 0;
+            for (unsigned l = 0; l < col; l++)
+                mp_addmul(s, a[i * col + l], w[l * k + j]);
+            if (b.empty() ? s != 0 : s != den * b[i * k + j])
+                return false;
+        }
+    }
+    return true;
+}
+
+// Basis of the nullspace from the reduced row echelon form, one vector per
+// column of the col x (col - rank) result
+std::vector<rational_class>
+nullspace_from_rref(unsigned col, const std::vector<unsigned> &pivots,
+                    const std::vector<rational_class> &rref)
+{
+    std::vector<unsigned> free;
+    for (unsigned c = 0, i = 0; c < col; c++) {
+        if (i < pivots.size() and pivots[i] == c)
+            i++;
+        else
+            free.push_back(c);
+    }
+    const unsigned k = numeric_cast<unsigned>(free.size());
+    std::vector<rational_class> v(col * k, rational_class(0));
+    for (unsigned j = 0; j < k; j++) {
+        v[free[j] * k + j] = 1;
+        for (unsigned i = 0; i < pivots.size(); i++)
+            v[pivots[i] * k + j] = -rref[i * col + free[j]];
+    }
+    return v;
+}
+
+} // namespace
+
+RCP<const Basic> det_multimodular(const DenseMatrix &A)
+{
+    SYMENGINE_ASSERT(A.row_ == A.col_);
+
+    const unsigned n = A.row_;
+    std::vector<integer_class> a;
+    integer_class scale;
+    if (not to_integer_rows(A.m_, n, n, a, scale))
+        throw SymEngineException("Matrix must contain Integers or Rationals");
+    if (n == 0)
+        return one;
+
+    // Hadamard's bound on the square of the determinant, from the rows and
+    // from the columns
+    integer_class hr(1), hc(1), s;
+    for (unsigned i = 0; i < n; i++) {
+        s = 0;
+        for (unsigned j = 0; j < n; j++)
+            mp_addmul(s, a[i * n + j], a[i * n + j]);
+        hr *= s;
+        s = 0;
+        for (unsigned j = 0; j < n; j++)
+            mp_addmul(s, a[j * n + i], a[j * n + i]);
+        hc *= s;
+    }
+    const integer_class h = std::min(hr, hc);
+    if (h == 0)
+        return zero;
+
+    // The symmetric residue is the determinant once m**2 > 4 * h
+    std::vector<uint64_t> primes;
+    size_t count = 0;
+    integer_class m(1);
+    while (m * m <= 4 * h) {
+        if (count == primes.size())
+            primes = modular_primes(2 * count + 8);
+        m *= primes[count++];
+    }
+    primes.resize(count);
+    std::vector<uint64_t> dets(count);
+#pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < count; i++) {
+        std::vector<uint64_t> r;
+        reduce_mod(a, primes[i], r);
+        echelon_mod(r, n, n, primes[i], false, dets[i]);
+    }
+
+    std::vector<integer_class> d(1, integer_class(0));
+    m = 1;
+    for (size_t i = 0; i < count; i++)
+        crt_combine(d, m, {dets[i]}, primes[i]);
+    if (2 * d[0] > m)
+        d[0] -= m;
+    rational_class q(d[0], scale);
+    canonicalize(q);
+    return Rational::from_mpq(std::move(q));
+}
+
+void nullspace_multimodular(const DenseMatrix &A, DenseMatrix &result)
+{
+    const unsigned row = A.row_, col = A.col_;
+    std::vector<integer_class> a;
+    integer_class scale;
+    if (not to_integer_rows(A.m_, row, col, a, scale))
+        throw SymEngineException("Matrix must contain Integers or Rationals");
+
+    std::vector<unsigned> pivots;
+    std::vector<rational_class> rref;
+    rref_multimodular(a, row, col, 0, pivots, rref,
+                      [&](const std::vector<unsigned> &p,
+                          const std::vector<rational_class> &r) {
+                          const unsigned k
+                              = col - numeric_cast<unsigned>(p.size());
+                          return annihilates(a, row, col,
+                                             nullspace_from_rref(col, p, r), k,
+                                             {});
+                      });
+
+    const std::vector<rational_class> v
+        = nullspace_from_rref(col, pivots, rref);
+    const unsigned k = col - numeric_cast<unsigned>(pivots.size());
+    result = DenseMatrix(col, k);
+    for (unsigned i = 0; i < v.size(); i++)
+        result.m_[i] = Rational::from_mpq(v[i]);
+}
+
+unsigned rank_multimodular(const DenseMatrix &A)
+{
+    const unsigned row = A.row_, col = A.col_;
+    std::vector<integer_class> a;
+    integer_class scale;
+    if (not to_integer_rows(A.m_, row, col, a, scale))
+        throw SymEngineException("Matrix must contain Integers or Rationals");
+
+    // The rank modulo a prime never exceeds the rank over Q
+    const uint64_t p = modular_primes(1)[0];
+    std::vector<uint64_t> r;
+    uint64_t det;
+    reduce_mod(a, p, r);
+    const std::vector<unsigned> pivots
+        = echelon_mod(r, row, col, p, false, det);
+    const unsigned rank = numeric_cast<unsigned>(pivots.size());
+    if (rank == std::min(row, col))
+        return rank;
+
+    DenseMatrix N;
+    nullspace_multimodular(A, N);
+    return col - N.col_;
+}
+
+// Solves A x = b for the n x n matrix `A` and the n x k matrix `b`. Returns
+// false if A is singular or if A and b are not exact.
+static bool try_solve_multimodular(const vec_basic &A, const vec_basic &b,
+                                   unsigned n, unsigned k, vec_basic &x)
+{
+    const unsigned col = n + k;
+    vec_basic ab(n * col);
+    for (unsigned i = 0; i < n; i++) {
+        std::copy(A.begin() + i * n, A.begin() + i * n + n,
+                  ab.begin() + i * col);
+        std::copy(b.begin() + i * k, b.begin() + i * k + k,
+                  ab.begin() + i * col + n);
+    }
+    std::vector<integer_class> a;
+    integer_class scale;
+    if (not to_integer_rows(ab, n, col, a, scale))
+        return false;
+    if (n == 0)
+        return true;
+
+    std::vector<integer_class> ai(n * n), bi(n * k);
+    for (unsigned i = 0; i < n; i++) {
+        std::copy(a.begin() + i * col, a.begin() + i * col + n,
+                  ai.begin() + i * n);
+        std::copy(a.begin() + i * col + n, a.begin() + i * col + col,
+                  bi.begin() + i * k);
+    }
+
+    // A nonzero determinant modulo one prime proves that A is nonsingular
+    const uint64_t p = modular_primes(1)[0];
+    std::vector<uint64_t> r;
+    uint64_t det;
+    reduce_mod(ai, p, r);
+    echelon_mod(r, n, n, p, false, det);
+    if (det == 0 and eq(*det_multimodular(DenseMatrix(n, n, A)), *zero))
+        return false;
+
+    // The reduced row echelon form of [A | b] is [I | A**-1 * b], so only
+    // its last k columns are reconstructed
+    std::vector<unsigned> pivots;
+    std::vector<rational_class> v;
+    rref_multimodular(a, n, col, n, pivots, v,
+                      [&](const std::vector<unsigned> &pl,
+                          const std::vector<rational_class> &rr) {
+                          return pl.size() == n and pl.back() == n - 1
+                                 and annihilates(ai, n, n, rr, k, bi);
+                      });
+
+    for (unsigned i = 0; i < v.size(); i++)
+        x[i] = Rational::from_mpq(v[i]);
+    return true;
+}
+
+void solve_multimodular(const DenseMatrix &A, const DenseMatrix &b,
+                        DenseMatrix &x)
+{
+    SYMENGINE_ASSERT(A.row_ == A.col_ and b.row_ == A.row_);
+    SYMENGINE_ASSERT(x.row_ == b.row_ and x.col_ == b.col_);
+
+    if (numeric_domain(A.m_) == NumericDomain::Generic
+        or numeric_domain(A.m_) == NumericDomain::Double
+        or numeric_domain(b.m_) == NumericDomain::Generic
+        or numeric_domain(b.m_) == NumericDomain::Double)
+        throw SymEngineException("Matrix must contain Integers or Rationals");
+    if (not try_solve_multimodular(A.m_, b.m_, A.row_, b.col_, x.m_))
+        throw SymEngineException("Matrix is rank deficient");
 }
 
 // --------------------------- Solve Ax = b  ---------------------------------//
@@ -908,6 +2149,11 @@ void fraction_free_LU_solve(const DenseMatrix &A, const DenseMatrix &b,
 
 void LU_solve(const DenseMatrix &A, const DenseMatrix &b, DenseMatrix &x)
 {
+    // Large exact systems are solved modulo word-size primes instead
+    if (A.row_ >= 16
+        and try_solve_multimodular(A.m_, b.m_, A.row_, b.col_, x.m_))
+        return;
+
     DenseMatrix L = DenseMatrix(A.nrows(), A.ncols());
     DenseMatrix U = DenseMatrix(A.nrows(), A.ncols());
     DenseMatrix x_ = DenseMatrix(b.nrows(), b.ncols());
@@ -963,6 +2209,10 @@ void fraction_free_LU(const DenseMatrix &A, DenseMatrix &LU)
     unsigned n = A.row_;
     unsigned i, j, k;
 
+    FractionFreeElimination kernel{n, n, false};
+    if (numeric_dispatch(A.m_, LU.m_, kernel, true))
+        return;
+
     LU.m_ = A.m_;
 
     for (i = 0; i < n - 1; i++)
@@ -989,24 +2239,29 @@ void LU(const DenseMatrix &A, DenseMatrix &L, DenseMatrix &U)
     unsigned i, j, k;
     RCP<const Basic> scale;
 
-    U.m_ = A.m_;
+    LUDecomposition kernel{n, nullptr};
+    if (not numeric_dispatch(A.m_, U.m_, kernel, false)) {
+        U.m_ = A.m_;
+
+        for (j = 0; j < n; j++) {
+            for (i = 0; i < j; i++)
+                for (k = 0; k < i; k++)
+                    U.m_[i * n + j]
+                        = sub(U.m_[i * n + j],
+                              mul(U.m_[i * n + k], U.m_[k * n + j]));
+
+            for (i = j; i < n; i++) {
+                for (k = 0; k < j; k++)
+                    U.m_[i * n + j]
+                        = sub(U.m_[i * n + j],
+                              mul(U.m_[i * n + k], U.m_[k * n + j]));
+            }
 
-    for (j = 0; j < n; j++) {
-        for (i = 0; i < j; i++)
-            for (k = 0; k < i; k++)
-                U.m_[i * n + j] = sub(U.m_[i * n + j],
-                                      mul(U.m_[i * n + k], U.m_[k * n + j]));
+            scale = div(one, U.m_[j * n + j]);
 
-        for (i = j; i < n; i++) {
-            for (k = 0; k < j; k++)
-                U.m_[i * n + j] = sub(U.m_[i * n + j],
-                                      mul(U.m_[i * n + k], U.m_[k * n + j]));
+            for (i = j + 1; i < n; i++)
+                U.m_[i * n + j] = mul(U.m_[i * n + j], scale);
         }
-
-        scale = div(one, U.m_[j * n + j]);
-
-        for (i = j + 1; i < n; i++)
-            U.m_[i * n + j] = mul(U.m_[i * n + j], scale);
     }
 
     for (i = 0; i < n; i++) {
@@ -1033,6 +2288,10 @@ void pivoted_LU(const DenseMatrix &A, DenseMatrix &LU, permutelist &pl)
     RCP<const Basic> scale;
     int pivot;
 
+    LUDecomposition kernel{n, &pl};
+    if (numeric_dispatch(A.m_, LU.m_, kernel, false))
+        return;
+
     LU.m_ = A.m_;
 
     for (j = 0; j < n; j++) {
@@ -1302,6 +2561,11 @@ RCP<const Basic> det_bareis(const DenseMatrix &A)
                            mul(mul(A.m_[1], A.m_[3]), A.m_[8])),
                        mul(mul(A.m_[0], A.m_[5]), A.m_[7])));
     } else {
+        BareissDeterminant kernel{n, zero};
+        vec_basic tmp;
+        if (numeric_dispatch(A.m_, tmp, kernel, true))
+            return kernel.det;
+
         DenseMatrix B = DenseMatrix(n, n, A.m_);
         unsigned i, sign = 1;
         RCP<const Basic> d;
@@ -1434,10 +2698,163 @@ void char_poly(const DenseMatrix &A, DenseMatrix &B)
     B = polys[polys.size() - 1];
 }
 
+// ------------------------ Evaluation and Interpolation ---------------------//
+
+namespace
+{
+
+// Replaces the values at 0, 1, ..., d of a polynomial of degree at most d,
+// stored `stride` apart in `v`, by its coefficients. The polynomial has
+// integer coefficients, so all divided differences are exact.
+void interpolate_integer(integer_class *v, unsigned d, size_t stride)
+{
+    for (unsigned k = 1; k <= d; k++)
+        for (unsigned i = d; i >= k; i--)
+            v[i * stride] = (v[i * stride] - v[(i - 1) * stride]) / k;
+
+    // Newton form to monomials by Horner's scheme, q = q * (x - k) + c_k
+    std::vector<integer_class> q(d + 1, integer_class(0));
+    q[0] = v[d * stride];
+    for (unsigned k = d; k-- > 0;) {
+        for (unsigned j = d - k; j > 0; j--)
+            q[j] = q[j - 1] - k * q[j];
+        q[0] = v[k * stride] - k * q[0];
+    }
+    for (unsigned i = 0; i <= d; i++)
+        v[i * stride] = q[i];
+}
+
+} // namespace
+
+RCP<const MIntPoly> det_interpolation(const DenseMatrix &A,
+                                      const set_basic &gens)
+{
+    SYMENGINE_ASSERT(A.row_ == A.col_);
+
+    const unsigned n = A.row_;
+    const unsigned m = numeric_cast<unsigned>(gens.size());
+    std::vector<MIntDict> entries;
+    entries.reserve(n * n);
+    for (const auto &e : A.m_) {
+        set_basic g = gens;
+        entries.push_back(from_basic<MIntPoly>(e, g, true)->get_poly());
+    }
+
+    // The degree in each generator is bounded by the sum of the largest
+    // degrees of the rows, and by that of the columns
+    std::vector<unsigned> bound(m), row_max(n * m, 0), col_max(n * m, 0);
+    for (unsigned i = 0; i < n; i++) {
+        for (unsigned j = 0; j < n; j++) {
+            for (const auto &t : entries[i * n + j].dict_) {
+                for (unsigned v = 0; v < m; v++) {
+                    unsigned &r = row_max[i * m + v], &c = col_max[j * m + v];
+                    r = std::max(r, t.first[v]);
+                    c = std::max(c, t.first[v]);
+                }
+            }
+        }
+    }
+    size_t npoints = 1;
+    for (unsigned v = 0; v < m; v++) {
+        unsigned r = 0, c = 0;
+        for (unsigned i = 0; i < n; i++) {
+            r += row_max[i * m + v];
+            c += col_max[i * m + v];
+        }
+        bound[v] = std::min(r, c);
+        npoints *= bound[v] + 1;
+    }
+
+    // Determinants at the points of the grid {0, ..., bound[v]}, the last
+    // generator varying fastest
+    std::vector<integer_class> values(npoints);
+#pragma omp parallel for schedule(dynamic)
+    for (size_t k = 0; k < npoints; k++) {
+        std::vector<std::vector<integer_class>> powers(m);
+        size_t r = k;
+        for (unsigned v = m; v-- > 0;) {
+            const unsigned t = numeric_cast<unsigned>(r % (bound[v] + 1));
+            r /= bound[v] + 1;
+            powers[v].resize(bound[v] + 1);
+            powers[v][0] = 1;
+            for (unsigned e = 1; e <= bound[v]; e++)
+                powers[v][e] = powers[v][e - 1] * t;
+        }
+        std::vector<integer_class> a(n * n, integer_class(0));
+        integer_class c;
+        for (unsigned e = 0; e < n * n; e++) {
+            for (const auto &t : entries[e].dict_) {
+                c = t.second;
+                for (unsigned v = 0; v < m; v++)
+                    c *= powers[v][t.first[v]];
+                a[e] += c;
+            }
+        }
+        if (n == 0) {
+            values[k] = 1;
+        } else {
+            BareissDeterminant kernel{n, zero};
+            kernel(a);
+            values[k]
+                = down_cast<const Integer &>(*kernel.det).as_integer_class();
+        }
+    }
+
+    // Interpolate along one generator at a time
+    size_t stride = npoints;
+    for (unsigned v = 0; v < m; v++) {
+        const size_t block = stride;
+        stride /= bound[v] + 1;
+        for (size_t outer = 0; outer < npoints; outer += block)
+            for (size_t inner = 0; inner < stride; inner++)
+                interpolate_integer(&values[outer + inner], bound[v], stride);
+    }
+
+    umap_uvec_mpz d;
+    for (size_t k = 0; k < npoints; k++) {
+        if (values[k] == 0)
+            continue;
+        vec_uint exps(m);
+        size_t r = k;
+        for (unsigned v = m; v-- > 0;) {
+            exps[v] = numeric_cast<unsigned>(r % (bound[v] + 1));
+            r /= bound[v] + 1;
+        }
+        d[exps] = values[k];
+    }
+    return MIntPoly::from_container(gens, MIntDict(std::move(d), m));
+}
+
+RCP<const UIntPoly> det_interpolation(const DenseMatrix &A,
+                                      const RCP<const Basic> &gen)
+{
+    RCP<const MIntPoly> p = det_interpolation(A, set_basic({gen}));
+    std::map<unsigned, integer_class> d;
+    for (const auto &t : p->get_poly().dict_)
+        d[t.first[0]] = t.second;
+    return UIntPoly::from_dict(gen, std::move(d));
+}
+
+RCP<const UIntPoly> char_poly_interpolation(const DenseMatrix &A,
+                                            const RCP<const Basic> &x)
+{
+    SYMENGINE_ASSERT(A.row_ == A.col_);
+
+    const unsigned n = A.row_;
+    DenseMatrix B(n, n);
+    for (unsigned i = 0; i < n; i++)
+        for (unsigned j = 0; j < n; j++)
+            B.m_[i * n + j] = i == j ? sub(x, A.m_[i * n + j])
+                                     : neg(A.m_[i * n + j]);
+    return det_interpolation(B, x);
+}
+
 void inverse_fraction_free_LU(const DenseMatrix &A, DenseMatrix &B)
 {
     SYMENGINE_ASSERT(A.row_ == A.col_ and B.row_ == B.col_
                      and B.row_ == A.row_);
+    if (exact_inverse(A.m_, A.row_, B.m_))
+        return;
 
     unsigned n = A.row_, i;
     DenseMatrix LU = DenseMatrix(n, n);
@@ -1478,6 +2895,8 @@ void inverse_LU(const DenseMatrix &A, DenseMatrix &B)
 {
     SYMENGINE_ASSERT(A.row_ == A.col_ and B.row_ == B.col_
                      and B.row_ == A.row_);
+    if (exact_inverse(A.m_, A.row_, B.m_))
+        return;
     DenseMatrix e = DenseMatrix(A.row_, A.col_);
     eye(e);
     LU_solve(A, e, B);
@@ -1487,6 +2906,8 @@ void inverse_pivoted_LU(const DenseMatrix &A, DenseMatrix &B)
 {
     SYMENGINE_ASSERT(A.row_ == A.col_ and B.row_ == B.col_
                      and B.row_ == A.row_);
+    if (exact_inverse(A.m_, A.row_, B.m_))
+        return;
     DenseMatrix e = DenseMatrix(A.row_, A.col_);
     eye(e);
     pivoted_LU_solve(A, e, B);
@@ -1496,6 +2917,8 @@ void inverse_gauss_jordan(const DenseMatrix &A, DenseMatrix &B)
 {
     SYMENGINE_ASSERT(A.row_ == A.col_ and B.row_ == B.col_
                      and B.row_ == A.row_);
+    if (exact_inverse(A.m_, A.row_, B.m_))
+        return;
 
     unsigned n = A.row_;
     DenseMatrix e = DenseMatrix(n, n);
@@ -9,6 +9,7 @@
 #include <symengine/mp_class.h>
 #include <algorithm>
 #include <cstdint>
+#include <unordered_set>
 
 namespace SymEngine
 {
@@ -42,6 +43,8 @@ typedef std::vector<integer_class> vec_integer_class;
 typedef std::vector<RCP<const Symbol>> vec_sym;
 typedef std::set<RCP<const Basic>, RCPBasicKeyLess> set_basic;
 typedef std::multiset<RCP<const Basic>, RCPBasicKeyLess> multiset_basic;
+typedef std::unordered_set<RCP<const Basic>, RCPBasicHash, RCPBasicKeyEq>
+    uset_basic;
 typedef std::map<vec_uint, unsigned long long int> map_vec_uint;
 typedef std::map<vec_uint, integer_class> map_vec_mpz;
 typedef std::map<RCP<const Basic>, RCP<const Number>, RCPBasicKeyLess>
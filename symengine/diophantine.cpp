@@ -6,39 +6,259 @@
 namespace SymEngine
 {
 
-bool order(const DenseMatrix &t, const std::vector<DenseMatrix> &basis,
-           unsigned k)
+namespace
 {
-    bool eq = true;
+// Nearest integer to a / b for b > 0
+integer_class round_div(const integer_class &a, const integer_class &b)
+{
+    integer_class q;
+    mp_fdiv_q(q, 2 * a + b, 2 * b);
+    return q;
+}
 
-    for (unsigned j = 0; j < t.ncols(); j++) {
-        SYMENGINE_ASSERT(is_a<Integer>(*t.get(0, j)));
-        integer_class t_
-            = down_cast<const Integer &>(*t.get(0, j)).as_integer_class();
+integer_class dot(const vec_integer_class &a, const vec_integer_class &b)
+{
+    integer_class s(0);
+    for (size_t i = 0; i < a.size(); i++)
+        s += a[i] * b[i];
+    return s;
+}
 
-        SYMENGINE_ASSERT(is_a<Integer>(*basis[k].get(0, j)));
-        integer_class b_ = down_cast<const Integer &>(*basis[k].get(0, j))
-                               .as_integer_class();
+// The rows of A that are linearly independent over the rationals, found by
+// fraction-free Gaussian elimination
+std::vector<vec_integer_class>
+independent_rows(const std::vector<vec_integer_class> &A)
+{
+    std::vector<vec_integer_class> rows, echelon;
+    std::vector<size_t> pivots;
+    integer_class g;
+    for (const vec_integer_class &a : A) {
+        vec_integer_class r = a;
+        for (size_t k = 0; k < echelon.size(); k++) {
+            const vec_integer_class &e = echelon[k];
+            const size_t c = pivots[k];
+            if (r[c] == 0)
+                continue;
+            // r = e[c] r - r[c] e, divided by the content
+            integer_class f = r[c];
+            for (size_t j = 0; j < r.size(); j++)
+                r[j] = e[c] * r[j] - f * e[j];
+            g = 0;
+            for (const integer_class &x : r)
+                mp_gcd(g, g, x);
+            if (g > 1)
+                for (integer_class &x : r)
+                    mp_divexact(x, x, g);
+        }
+        size_t c = 0;
+        while (c < r.size() and r[c] == 0)
+            c++;
+        if (c == r.size())
+            continue;
+        echelon.push_back(std::move(r));
+        pivots.push_back(c);
+        rows.push_back(a);
+    }
+    return rows;
+}
 
-        if (t_ < b_) {
-            return false;
+inline bool in_range(int64_t d, int64_t limit)
+{
+    return d <= limit and d >= -limit;
+}
+
+inline bool in_range(const integer_class &, const integer_class &)
+{
+    return true;
+}
+
+// Breadth first search of Contejean and Devie for the minimal solutions of
+// Ax = 0 in nonnegative integers, where column j of A is cols[j]. A vector x
+// that is not a solution is only extended to x + e_j if its defect Ax and
+// A e_j make an obtuse angle, and not if x + e_j is at least a solution
+// already found. The components frozen for x are never incremented again,
+// so that no vector is visited twice. With T = int64_t, returns false as
+// soon as a defect leaves [-limit, limit].
+template <typename T>
+bool contejean_devie(std::vector<vec_integer_class> &basis,
+                     const std::vector<std::vector<T>> &cols, const T &limit)
+{
+    // The vectors of a level, with their defects and frozen components, one
+    // after the other
+    struct Level {
+        std::vector<unsigned long> x;
+        std::vector<T> defect;
+        std::vector<bool> frozen;
+    };
+    const size_t q = cols.size(), p = cols[0].size();
+    std::vector<std::vector<unsigned long>> found;
+    // by_value[j][v] lists the solutions found with component j equal to v
+    std::vector<std::vector<std::vector<size_t>>> by_value(q);
+    Level level, next;
+    for (size_t j = 0; j < q; j++) {
+        for (size_t i = 0; i < q; i++) {
+            level.x.push_back(i == j);
+            level.frozen.push_back(i < j);
+        }
+        level.defect.insert(level.defect.end(), cols[j].begin(),
+                            cols[j].end());
+    }
+    std::vector<bool> frozen(q);
+    T s;
+    while (not level.x.empty()) {
+        const size_t size = level.x.size() / q;
+        std::vector<bool> solution(size);
+        // The solutions of a level are found before the next level is
+        // pruned with them
+        for (size_t n = 0; n < size; n++) {
+            auto d = level.defect.begin() + n * p;
+            solution[n]
+                = std::all_of(d, d + p, [](const T &t) { return t == 0; });
+            if (not solution[n])
+                continue;
+            const unsigned long *x = &level.x[n * q];
+            for (size_t j = 0; j < q; j++) {
+                if (by_value[j].size() <= x[j])
+                    by_value[j].resize(x[j] + 1);
+                by_value[j][x[j]].push_back(found.size());
+            }
+            found.push_back(std::vector<unsigned long>(x, x + q));
         }
-        if (t_ > b_) {
-            eq = false;
+        next.x.clear();
+        next.defect.clear();
+        next.frozen.clear();
+        for (size_t n = 0; n < size; n++) {
+            if (solution[n])
+                continue;
+            const unsigned long *x = &level.x[n * q];
+            const T *d = &level.defect[n * p];
+            for (size_t j = 0; j < q; j++)
+                frozen[j] = level.frozen[n * q + j];
+            for (size_t j = 0; j < q; j++) {
+                if (frozen[j])
+                    continue;
+                s = 0;
+                for (size_t i = 0; i < p; i++)
+                    s += d[i] * cols[j][i];
+                if (s >= 0)
+                    continue;
+                // x is not at least any solution found, so x + e_j is at
+                // least b only if b[j] == x[j] + 1 and b <= x elsewhere
+                bool dominated = false;
+                if (x[j] + 1 < by_value[j].size()) {
+                    for (size_t k : by_value[j][x[j] + 1]) {
+                        const auto &b = found[k];
+                        dominated = true;
+                        for (size_t i = 0; i < q and dominated; i++)
+                            dominated = i == j or b[i] <= x[i];
+                        if (dominated)
+                            break;
+                    }
+                }
+                if (dominated)
+                    continue;
+                next.x.insert(next.x.end(), x, x + q);
+                next.x[next.x.size() - q + j]++;
+                for (size_t i = 0; i < p; i++) {
+                    next.defect.push_back(d[i] + cols[j][i]);
+                    if (not in_range(next.defect.back(), limit))
+                        return false;
+                }
+                next.frozen.insert(next.frozen.end(), frozen.begin(),
+                                   frozen.end());
+                frozen[j] = true;
+            }
         }
+        std::swap(level, next);
     }
-
-    return not eq;
+    for (const auto &x : found) {
+        vec_integer_class b;
+        for (unsigned long c : x)
+            b.push_back(integer_class(c));
+        basis.push_back(std::move(b));
+    }
+    return true;
 }
+} // anonymous namespace
 
-bool is_minimum(const DenseMatrix &t, const std::vector<DenseMatrix> &basis,
-                unsigned n)
+// References : Cohen H., A course in computational algebraic number theory
+// (1996), Algorithm 2.6.7, which keeps the Gram-Schmidt coefficients as the
+// integers lambda[k][j] = d[j + 1] mu[k][j] and d[k] = the Gram determinant of
+// the first k vectors.
+void lll_reduce(std::vector<vec_integer_class> &b, const rational_class &delta)
 {
-    if (n == 0) {
-        return true;
+    const size_t n = b.size();
+    if (n == 0)
+        return;
+    const integer_class &a = get_num(delta), &c = get_den(delta);
+    std::vector<vec_integer_class> lambda(n, vec_integer_class(n));
+    vec_integer_class d(n + 1);
+    d[0] = 1;
+    d[1] = dot(b[0], b[0]);
+    if (d[1] == 0)
+        throw SymEngineException("lll_reduce: linearly dependent vectors");
+
+    // b[k] -= round(mu[k][l]) b[l]
+    auto reduce = [&](size_t k, size_t l) {
+        if (2 * mp_abs(lambda[k][l]) <= d[l + 1])
+            return;
+        integer_class q = round_div(lambda[k][l], d[l + 1]);
+        for (size_t i = 0; i < b[k].size(); i++)
+            b[k][i] -= q * b[l][i];
+        lambda[k][l] -= q * d[l + 1];
+        for (size_t i = 0; i < l; i++)
+            lambda[k][i] -= q * lambda[l][i];
+    };
+    auto swap = [&](size_t k, size_t kmax) {
+        std::swap(b[k], b[k - 1]);
+        for (size_t j = 0; j + 1 < k; j++)
+            std::swap(lambda[k][j], lambda[k - 1][j]);
+        const integer_class l = lambda[k][k - 1];
+        integer_class B = (d[k - 1] * d[k + 1] + l * l) / d[k], t;
+        for (size_t i = k + 1; i <= kmax; i++) {
+            t = lambda[i][k];
+            lambda[i][k] = (d[k + 1] * lambda[i][k - 1] - l * t) / d[k];
+            lambda[i][k - 1] = (B * t + l * lambda[i][k]) / d[k + 1];
+        }
+        d[k] = std::move(B);
+    };
+
+    integer_class u;
+    for (size_t k = 1, kmax = 0; k < n;) {
+        if (k > kmax) {
+            kmax = k;
+            for (size_t j = 0; j <= k; j++) {
+                u = dot(b[k], b[j]);
+                for (size_t i = 0; i < j; i++)
+                    u = (d[i + 1] * u - lambda[k][i] * lambda[j][i]) / d[i];
+                if (j < k)
+                    lambda[k][j] = u;
+                else
+                    d[k + 1] = u;
+            }
+            if (d[k + 1] == 0)
+                throw SymEngineException(
+                    "lll_reduce: linearly dependent vectors");
+        }
+        reduce(k, k - 1);
+        // Lovasz condition d[k + 1] d[k - 1] >= (delta d[k]**2 -
+        // lambda[k][k - 1]**2)
+        if (c * d[k + 1] * d[k - 1]
+            < a * d[k] * d[k] - c * lambda[k][k - 1] * lambda[k][k - 1]) {
+            swap(k, kmax);
+            if (k > 1)
+                k--;
+        } else {
+            for (size_t l = k - 1; l-- > 0;)
+                reduce(k, l);
+            k++;
+        }
     }
+}
 
-    return not order(t, basis, n - 1) and is_minimum(t, basis, n - 1);
+void lll_reduce(std::vector<vec_integer_class> &basis)
+{
+    lll_reduce(basis, rational_class(integer_class(3), integer_class(4)));
 }
 
 // Solve the diophantine system Ax = 0 and return a basis set for solutions
@@ -48,92 +268,76 @@ bool is_minimum(const DenseMatrix &t, const std::vector<DenseMatrix> &basis,
 // Systems of Linear Diophantine Equations. Information and computation,
 // 113(1):143-172,
 // August 1994.
-void homogeneous_lde(std::vector<DenseMatrix> &basis, const DenseMatrix &A)
+void homogeneous_lde(std::vector<vec_integer_class> &basis,
+                     const std::vector<vec_integer_class> &A)
 {
-    unsigned p = A.nrows();
-    unsigned q = A.ncols();
-    long n;
-
-    SYMENGINE_ASSERT(p > 0 and q > 1);
-
-    DenseMatrix row_zero(1, q);
-    zeros(row_zero);
+    SYMENGINE_ASSERT(A.size() > 0 and A[0].size() > 1);
+    const size_t q = A[0].size();
 
-    DenseMatrix col_zero(p, 1);
-    zeros(col_zero);
-
-    std::vector<DenseMatrix> P;
-    P.push_back(row_zero);
-
-    std::vector<std::vector<bool>> Frozen(q, std::vector<bool>(q, true));
-    for (unsigned j = 0; j < q; j++) {
-        Frozen[0][j] = false;
+    // The same solutions are those of a basis of the lattice spanned by the
+    // rows of A, which LLL makes short and nearly orthogonal. Without a
+    // nonzero rational solution, there is no work left.
+    std::vector<vec_integer_class> rows = independent_rows(A);
+    if (rows.size() == q)
+        return;
+    if (rows.empty()) {
+        for (size_t j = 0; j < q; j++) {
+            basis.push_back(vec_integer_class(q, integer_class(0)));
+            basis.back()[j] = 1;
+        }
+        return;
     }
+    lll_reduce(rows);
 
-    std::vector<bool> F(q, false);
-
-    DenseMatrix t, transpose, product, T;
-    RCP<const Integer> dot;
-
-    product = DenseMatrix(p, 1);
-    transpose = DenseMatrix(q, 1);
-
-    while (P.size() > 0) {
-        n = P.size() - 1;
-        t = P[n];
-        P.pop_back();
-
-        t.transpose(transpose);
-        A.mul_matrix(transpose, product);
-
-        if (product.eq(col_zero) and not t.eq(row_zero)) {
-            basis.push_back(t);
-        } else {
-            for (unsigned i = 0; i < q; i++) {
-                F[i] = Frozen[n][i];
-            }
-
-            T = t;
-            for (unsigned i = 0; i < q; i++) {
-                SYMENGINE_ASSERT(is_a<Integer>(*T.get(0, i)));
-                T.set(0, i,
-                      down_cast<const Integer &>(*T.get(0, i)).addint(*one));
-
-                if (i > 0) {
-                    SYMENGINE_ASSERT(is_a<Integer>(*T.get(0, i - 1)));
-                    T.set(0, i - 1, down_cast<const Integer &>(*T.get(0, i - 1))
-                                        .subint(*one));
-                }
-
-                dot = zero;
-                for (unsigned j = 0; j < p; j++) {
-                    SYMENGINE_ASSERT(is_a<Integer>(*product.get(j, 0)));
-                    RCP<const Integer> p_j0
-                        = rcp_static_cast<const Integer>(product.get(j, 0));
-
-                    SYMENGINE_ASSERT(is_a<Integer>(*A.get(j, i)));
-                    RCP<const Integer> A_ji
-                        = rcp_static_cast<const Integer>(A.get(j, i));
-
-                    dot = dot->addint(*p_j0->mulint(*A_ji));
-                }
+    // Run on words while the defects are small enough for the scalar
+    // products not to overflow
+    const size_t p = rows.size();
+    integer_class m(0);
+    for (const vec_integer_class &r : rows)
+        for (const integer_class &x : r)
+            if (mp_abs(x) > m)
+                m = mp_abs(x);
+    const integer_class limit
+        = ((integer_class(1) << 62) / integer_class(p)) / m;
+    if (mp_fits_slong_p(limit) and limit > m) {
+        std::vector<std::vector<int64_t>> cols(q, std::vector<int64_t>(p));
+        for (size_t j = 0; j < q; j++)
+            for (size_t i = 0; i < p; i++)
+                cols[j][i] = mp_get_si(rows[i][j]);
+        std::vector<vec_integer_class> b;
+        if (contejean_devie<int64_t>(b, cols, mp_get_si(limit))) {
+            basis.insert(basis.end(), b.begin(), b.end());
+            return;
+        }
+    }
+    std::vector<vec_integer_class> cols(q, vec_integer_class(p));
+    for (size_t j = 0; j < q; j++)
+        for (size_t i = 0; i < p; i++)
+            cols[j][i] = rows[i][j];
+    contejean_devie<integer_class>(basis, cols, integer_class(0));
+}
 
-                if (F[i] == false
-                    and ((dot->is_negative()
-                          and is_minimum(T, basis,
-                                         numeric_cast<unsigned>(basis.size())))
-                         or t.eq(row_zero))) {
-                    P.push_back(T);
-                    n = n + 1;
+void homogeneous_lde(std::vector<DenseMatrix> &basis, const DenseMatrix &A)
+{
+    unsigned p = A.nrows();
+    unsigned q = A.ncols();
 
-                    for (unsigned j = 0; j < q; j++) {
-                        Frozen[n - 1][j] = F[j];
-                    }
+    SYMENGINE_ASSERT(p > 0 and q > 1);
 
-                    F[i] = true;
-                }
-            }
+    std::vector<vec_integer_class> rows(p, vec_integer_class(q)), b;
+    for (unsigned i = 0; i < p; i++) {
+        for (unsigned j = 0; j < q; j++) {
+            SYMENGINE_ASSERT(is_a<Integer>(*A.get(i, j)));
+            rows[i][j]
+                = down_cast<const Integer &>(*A.get(i, j)).as_integer_class();
         }
     }
+    homogeneous_lde(b, rows);
+    for (const vec_integer_class &x : b) {
+        DenseMatrix t(1, q);
+        for (unsigned j = 0; j < q; j++)
+            t.set(0, j, integer(x[j]));
+        basis.push_back(t);
+    }
 }
 }
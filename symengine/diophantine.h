@@ -14,6 +14,17 @@ namespace SymEngine
 
 // Solve the diophantine system Ax = 0 and return a basis set for solutions
 void homogeneous_lde(std::vector<DenseMatrix> &basis, const DenseMatrix &A);
+// Same as above, for A given by its rows and x >= 0 as integer vectors
+void homogeneous_lde(std::vector<vec_integer_class> &basis,
+                     const std::vector<vec_integer_class> &A);
+
+//! LLL-reduces the basis of a lattice in place, with the Lovasz constant
+//! `delta` in (1/4, 1]. The vectors must be linearly independent. All the
+//! arithmetic is exact.
+void lll_reduce(std::vector<vec_integer_class> &basis,
+                const rational_class &delta);
+//! LLL-reduces the basis with delta = 3/4
+void lll_reduce(std::vector<vec_integer_class> &basis);
 }
 
 #endif
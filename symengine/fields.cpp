@@ -5,6 +5,8 @@
 #include <symengine/pow.h>
 #include <symengine/symengine_exception.h>
 
+#include <cmath>
+
 namespace SymEngine
 {
 GaloisField::GaloisField(const RCP<const Basic> &var, GaloisFieldDict &&dict)
@@ -178,6 +180,957 @@ void GaloisFieldDict::gf_istrip()
     }
 }
 
+// ------------------------- Word-size Moduli --------------------------------//
+
+// When the modulus fits in a machine word, multiplication, division, gcd,
+// powers and composition are computed on vectors of uint64_t coefficients in
+// [0, p). The factoring routines are built on these and use the same path.
+// Sums of products are accumulated in 128 bits and reduced once per
+// coefficient of the result, instead of once per product.
+//
+// Large operands use subquadratic algorithms: Karatsuba and NTT products,
+// division by Newton iteration on the reversed divisor and the half-gcd.
+// References :
+//     1.) J. von zur Gathen, J. Gerhard, Modern Computer Algebra, 1999,
+//     chapters 8, 9 and 11
+//     2.) C. K. Yap, Fundamental Problems of Algorithmic Algebra, 2000,
+//     chapter 2
+namespace
+{
+
+#ifdef __SIZEOF_INT128__
+
+typedef unsigned __int128 uint128_t;
+typedef std::vector<uint64_t> word_vec;
+
+// Arithmetic modulo p < 2**Bits. For Bits == 32 products fit in 64 bits and
+// are reduced by Barrett's method. For Bits == 62 products need 128 bits, and
+// `terms` of them can be added before the accumulator has to be reduced.
+template <unsigned Bits>
+class WordModulus
+{
+private:
+    uint64_t p_, barrett_;
+
+public:
+    static const unsigned terms = Bits <= 32 ? 0xffffffffu : 16;
+
+    explicit WordModulus(uint64_t p) : p_(p), barrett_(~uint64_t(0) / p)
+    {
+    }
+    uint64_t p() const
+    {
+        return p_;
+    }
+    uint64_t reduce(uint128_t x) const
+    {
+        if ((x >> 64) == 0)
+            return (uint64_t)x % p_;
+        return (uint64_t)(x % p_);
+    }
+    uint64_t mul(uint64_t a, uint64_t b) const
+    {
+        if (Bits > 32)
+            return (uint64_t)((uint128_t)a * b % p_);
+        const uint64_t x = a * b;
+        uint64_t r = x - (uint64_t)(((uint128_t)x * barrett_) >> 64) * p_;
+        while (r >= p_)
+            r -= p_;
+        return r;
+    }
+    uint64_t add(uint64_t a, uint64_t b) const
+    {
+        const uint64_t s = a + b;
+        return s >= p_ ? s - p_ : s;
+    }
+    uint64_t sub(uint64_t a, uint64_t b) const
+    {
+        return a >= b ? a - b : a + p_ - b;
+    }
+    uint64_t neg(uint64_t a) const
+    {
+        return a == 0 ? 0 : p_ - a;
+    }
+    uint64_t pow(uint64_t a, uint64_t n) const
+    {
+        uint64_t r = 1;
+        for (; n > 0; n >>= 1) {
+            if (n & 1)
+                r = mul(r, a);
+            a = mul(a, a);
+        }
+        return r;
+    }
+};
+
+// Below these sizes the quadratic algorithms are faster. The NTT threshold
+// is per prime of the transform. The half-gcd recurses down to degree
+// hgcd_threshold, but is only faster than the Euclidean algorithm from
+// degree gcd_threshold.
+const size_t karatsuba_threshold = 32;
+const size_t ntt_threshold = 256;
+const size_t newton_threshold = 800;
+const size_t hgcd_threshold = 300;
+const size_t gcd_threshold = 3000;
+
+void strip(word_vec &a)
+{
+    while (not a.empty() and a.back() == 0)
+        a.pop_back();
+}
+
+// Degree, with -1 for the zero polynomial
+long deg(const word_vec &a)
+{
+    return (long)a.size() - 1;
+}
+
+word_vec to_words(const std::vector<integer_class> &a)
+{
+    word_vec w(a.size());
+    for (size_t i = 0; i < a.size(); i++)
+        w[i] = mp_get_ui(a[i]);
+    return w;
+}
+
+std::vector<integer_class> from_words(const word_vec &w)
+{
+    std::vector<integer_class> a(w.size());
+    for (size_t i = 0; i < w.size(); i++)
+        a[i] = integer_class((unsigned long)w[i]);
+    return a;
+}
+
+// Inverse of a modulo p by the extended Euclidean algorithm, for p < 2**63
+// and a coprime to p
+uint64_t word_inverse(uint64_t a, uint64_t p)
+{
+    int64_t s0 = 0, s1 = 1;
+    uint64_t r0 = p, r1 = a % p;
+    while (r1 != 0) {
+        const uint64_t q = r0 / r1;
+        const int64_t s = s0 - (int64_t)q * s1;
+        s0 = s1;
+        s1 = s;
+        const uint64_t r = r0 - q * r1;
+        r0 = r1;
+        r1 = r;
+    }
+    return s0 < 0 ? (uint64_t)(s0 + (int64_t)p) : (uint64_t)s0;
+}
+
+// c[0, na + nb - 1) = a * b by the schoolbook method
+template <unsigned Bits>
+void mul_basecase(const WordModulus<Bits> &F, const uint64_t *a, size_t na,
+                  const uint64_t *b, size_t nb, uint64_t *c)
+{
+    for (size_t k = 0; k < na + nb - 1; k++) {
+        const size_t lo = k + 1 > nb ? k + 1 - nb : 0, hi = std::min(k, na - 1);
+        uint128_t acc = 0;
+        unsigned n = 0;
+        for (size_t i = lo; i <= hi; i++) {
+            acc += (uint128_t)a[i] * b[k - i];
+            if (++n == WordModulus<Bits>::terms) {
+                acc = F.reduce(acc);
+                n = 0;
+            }
+        }
+        c[k] = F.reduce(acc);
+    }
+}
+
+// c[0, 2 * n - 1) = a * b, where a and b have n coefficients
+template <unsigned Bits>
+void karatsuba(const WordModulus<Bits> &F, const uint64_t *a,
+               const uint64_t *b, size_t n, uint64_t *c)
+{
+    if (n < karatsuba_threshold) {
+        mul_basecase(F, a, n, b, n, c);
+        return;
+    }
+    // a = a0 + a1 x**h with a0 of length h and a1 of length k >= h
+    const size_t h = n / 2, k = n - h;
+    word_vec sa(k), sb(k), z1(2 * k - 1);
+    for (size_t i = 0; i < k; i++) {
+        sa[i] = i < h ? F.add(a[i], a[h + i]) : a[h + i];
+        sb[i] = i < h ? F.add(b[i], b[h + i]) : b[h + i];
+    }
+    karatsuba(F, a, b, h, c);
+    c[2 * h - 1] = 0;
+    karatsuba(F, a + h, b + h, k, c + 2 * h);
+    karatsuba(F, sa.data(), sb.data(), k, z1.data());
+    // z1 = (a0 + a1)(b0 + b1) - a0 b0 - a1 b1
+    for (size_t i = 0; i < 2 * h - 1; i++)
+        z1[i] = F.sub(z1[i], c[i]);
+    for (size_t i = 0; i < 2 * k - 1; i++)
+        z1[i] = F.sub(z1[i], c[2 * h + i]);
+    for (size_t i = 0; i < 2 * k - 1; i++)
+        c[h + i] = F.add(c[h + i], z1[i]);
+}
+
+// Primes q = c * 2**e + 1 below 2**31 with e >= 23, by decreasing size, and
+// a primitive root of each. Products of length up to 2**23 are computed
+// modulo as many of them as the size of their coefficients requires.
+const uint64_t ntt_primes[][2] = {{2013265921, 31},
+                                  {1224736769, 3},
+                                  {998244353, 3},
+                                  {469762049, 3},
+                                  {167772161, 3}};
+const unsigned ntt_nprimes = 5;
+const size_t ntt_max_length = size_t(1) << 23;
+
+typedef std::vector<uint32_t> ntt_vec;
+
+// Arithmetic modulo q < 2**31 by Montgomery's reduction, which needs no
+// division: redc(x) = x / 2**32 mod q for x < q 2**32.
+class NTTPrime
+{
+private:
+    uint32_t q_, qinv_;
+
+public:
+    explicit NTTPrime(uint32_t q) : q_(q), qinv_(q)
+    {
+        // qinv = -1 / q mod 2**32, by Newton iteration
+        for (unsigned i = 0; i < 4; i++)
+            qinv_ *= 2 - q * qinv_;
+        qinv_ = -qinv_;
+    }
+    uint32_t q() const
+    {
+        return q_;
+    }
+    // The reductions avoid branches, which the random data of a transform
+    // would mispredict: x + q [x < 0] for x in (-q, q)
+    uint32_t fix(uint32_t x) const
+    {
+        return x + (q_ & (0 - (x >> 31)));
+    }
+    uint32_t redc(uint64_t x) const
+    {
+        const uint32_t m = (uint32_t)x * qinv_;
+        return fix((uint32_t)((x + (uint64_t)m * q_) >> 32) - q_);
+    }
+    // x 2**32 mod q
+    uint32_t to_mont(uint64_t x) const
+    {
+        return (uint32_t)((x % q_ << 32) % q_);
+    }
+    uint32_t add(uint32_t a, uint32_t b) const
+    {
+        return fix(a + b - q_);
+    }
+    uint32_t sub(uint32_t a, uint32_t b) const
+    {
+        return fix(a - b);
+    }
+    uint32_t pow(uint64_t a, uint64_t n) const
+    {
+        uint64_t r = 1;
+        for (a %= q_; n > 0; n >>= 1) {
+            if (n & 1)
+                r = r * a % q_;
+            a = a * a % q_;
+        }
+        return (uint32_t)r;
+    }
+};
+
+// Twiddle factors for a transform of length n, a power of 2: w[h + j] =
+// r**j 2**32 mod q for 0 <= j < h, where r is a primitive root of unity of
+// order 2 h, or its inverse, so that each level reads them contiguously
+void ntt_twiddles(const NTTPrime &Q, uint64_t g, size_t n, bool inverse,
+                  ntt_vec &w)
+{
+    uint32_t r = Q.pow(g, (Q.q() - 1) / n);
+    if (inverse)
+        r = Q.pow(r, Q.q() - 2);
+    const uint64_t rm = Q.to_mont(r);
+    w.resize(std::max(n, size_t(2)));
+    w[n / 2] = Q.to_mont(1);
+    for (size_t j = n / 2 + 1; j < n; j++)
+        w[j] = Q.redc(w[j - 1] * rm);
+    for (size_t h = n / 4; h >= 1; h /= 2)
+        for (size_t j = 0; j < h; j++)
+            w[h + j] = w[2 * (h + j)];
+}
+
+// Forward transform of length a.size(), a power of 2, by decimation in
+// frequency. The output is in bit-reversed order, which the inverse
+// transform expects.
+void ntt_forward(const NTTPrime &Q, uint64_t g, ntt_vec &a)
+{
+    const size_t n = a.size();
+    ntt_vec w;
+    ntt_twiddles(Q, g, n, false, w);
+    for (size_t half = n / 2; half >= 1; half /= 2) {
+        const uint32_t *wh = &w[half];
+        for (size_t i = 0; i < n; i += 2 * half) {
+            uint32_t *x = &a[i], *y = &a[i + half];
+            for (size_t j = 0; j < half; j++) {
+                const uint32_t u = x[j], v = y[j];
+                x[j] = Q.add(u, v);
+                y[j] = Q.redc((uint64_t)Q.sub(u, v) * wh[j]);
+            }
+        }
+    }
+}
+
+// Inverse transform by decimation in time, without the division by the
+// length
+void ntt_inverse(const NTTPrime &Q, uint64_t g, ntt_vec &a)
+{
+    const size_t n = a.size();
+    ntt_vec w;
+    ntt_twiddles(Q, g, n, true, w);
+    for (size_t half = 1; half < n; half *= 2) {
+        const uint32_t *wh = &w[half];
+        for (size_t i = 0; i < n; i += 2 * half) {
+            uint32_t *x = &a[i], *y = &a[i + half];
+            for (size_t j = 0; j < half; j++) {
+                const uint32_t u = x[j], v = Q.redc((uint64_t)y[j] * wh[j]);
+                x[j] = Q.add(u, v);
+                y[j] = Q.sub(u, v);
+            }
+        }
+    }
+}
+
+// Number of NTT primes whose product exceeds the coefficients of a * b, at
+// most min(na, nb) (p - 1)**2, or 0 if there are not enough of them
+template <unsigned Bits>
+unsigned ntt_nprimes_for(const WordModulus<Bits> &F, size_t na, size_t nb)
+{
+    double bits = std::log2((double)std::min(na, nb))
+                  + 2 * std::log2((double)(F.p() - 1)) + 1;
+    for (unsigned k = 0; k < ntt_nprimes; k++) {
+        bits -= std::log2((double)ntt_primes[k][0]);
+        if (bits < 0)
+            return k + 1;
+    }
+    return 0;
+}
+
+// a * b by transforms modulo k primes and Garner's form of the Chinese
+// remainder theorem
+template <unsigned Bits>
+word_vec ntt_mul(const WordModulus<Bits> &F, const word_vec &a,
+                 const word_vec &b, unsigned k)
+{
+    const size_t nc = a.size() + b.size() - 1;
+    size_t n = 1;
+    while (n < nc)
+        n <<= 1;
+    const bool square = a == b;
+    std::vector<ntt_vec> res(k);
+#pragma omp parallel for if (n >= 1 << 16)
+    for (unsigned t = 0; t < k; t++) {
+        const NTTPrime Q((uint32_t)ntt_primes[t][0]);
+        const uint64_t g = ntt_primes[t][1];
+        ntt_vec fa(n, 0), fb;
+        for (size_t i = 0; i < a.size(); i++)
+            fa[i] = (uint32_t)(a[i] % Q.q());
+        ntt_forward(Q, g, fa);
+        if (not square) {
+            fb.assign(n, 0);
+            for (size_t i = 0; i < b.size(); i++)
+                fb[i] = (uint32_t)(b[i] % Q.q());
+            ntt_forward(Q, g, fb);
+        }
+        const ntt_vec &f = square ? fa : fb;
+        // The pointwise products are divided by 2**32, which the scaling by
+        // 2**64 / n undoes
+        const uint64_t scale = Q.to_mont(Q.to_mont(Q.pow(n, Q.q() - 2)));
+        for (size_t i = 0; i < n; i++)
+            fa[i] = Q.redc((uint64_t)fa[i] * f[i]);
+        ntt_inverse(Q, g, fa);
+        for (size_t i = 0; i < nc; i++)
+            fa[i] = Q.redc((uint64_t)fa[i] * scale);
+        res[t].swap(fa);
+    }
+
+    // prod[t][s] is q_0 ... q_{s-1} modulo q_t, or modulo p for t == k
+    uint64_t prod[ntt_nprimes + 1][ntt_nprimes], inv[ntt_nprimes];
+    for (unsigned t = 0; t <= k; t++) {
+        const uint64_t m = t < k ? ntt_primes[t][0] : F.p();
+        prod[t][0] = 1 % m;
+        for (unsigned s = 1; s < std::min(t + 1, k); s++)
+            prod[t][s] = (uint64_t)((uint128_t)prod[t][s - 1]
+                                    * (ntt_primes[s - 1][0] % m) % m);
+    }
+    std::vector<WordModulus<32>> Q;
+    for (unsigned t = 0; t < k; t++) {
+        inv[t] = word_inverse(prod[t][t], ntt_primes[t][0]);
+        Q.push_back(WordModulus<32>(ntt_primes[t][0]));
+    }
+    // Residues below 2**32 need no reduction before a product
+    word_vec c(nc);
+    uint64_t v[ntt_nprimes];
+    for (size_t i = 0; i < nc; i++) {
+        // c[i] = v[0] + v[1] q_0 + v[2] q_0 q_1 + ... with v[t] < q_t
+        for (unsigned t = 0; t < k; t++) {
+            uint64_t x = 0;
+            for (unsigned s = 0; s < t; s++)
+                x = Q[t].add(x, Q[t].mul(v[s], prod[t][s]));
+            v[t] = Q[t].mul(Q[t].sub(res[t][i], x), inv[t]);
+        }
+        uint64_t x = 0;
+        for (unsigned t = 0; t < k; t++)
+            x = F.add(x, F.mul(v[t], prod[k][t]));
+        c[i] = x;
+    }
+    return c;
+}
+
+// Product of `a` and `b`, which may be zero
+template <unsigned Bits>
+word_vec word_mul(const WordModulus<Bits> &F, const word_vec &a,
+                  const word_vec &b)
+{
+    if (a.empty() or b.empty())
+        return word_vec();
+    const word_vec &x = a.size() >= b.size() ? a : b;
+    const word_vec &y = a.size() >= b.size() ? b : a;
+    const size_t nx = x.size(), ny = y.size();
+    word_vec c(nx + ny - 1, 0);
+    unsigned k;
+    if (ny < karatsuba_threshold) {
+        mul_basecase(F, x.data(), nx, y.data(), ny, c.data());
+    } else if (nx + ny - 1 <= ntt_max_length
+               and (k = ntt_nprimes_for(F, nx, ny)) != 0
+               and ny >= ntt_threshold * k) {
+        c = ntt_mul(F, x, y, k);
+    } else {
+        // x is cut into blocks of the length of y
+        word_vec t(2 * ny - 1);
+        for (size_t off = 0; off < nx; off += ny) {
+            const size_t len = std::min(ny, nx - off);
+            if (len == ny) {
+                karatsuba(F, x.data() + off, y.data(), ny, t.data());
+            } else {
+                const word_vec xs(x.begin() + off, x.end());
+                t = word_mul(F, xs, y);
+                // The product comes back without its zero top coefficients
+                t.resize(len + ny - 1, 0);
+            }
+            for (size_t i = 0; i < len + ny - 1; i++)
+                c[off + i] = F.add(c[off + i], t[i]);
+        }
+    }
+    strip(c);
+    return c;
+}
+
+// a * b modulo x**n
+template <unsigned Bits>
+word_vec word_mul_trunc(const WordModulus<Bits> &F, const word_vec &a,
+                        const word_vec &b, size_t n)
+{
+    word_vec c = word_mul(
+        F, word_vec(a.begin(), a.begin() + std::min(n, a.size())),
+        word_vec(b.begin(), b.begin() + std::min(n, b.size())));
+    if (c.size() > n) {
+        c.resize(n);
+        strip(c);
+    }
+    return c;
+}
+
+template <unsigned Bits>
+word_vec word_add(const WordModulus<Bits> &F, const word_vec &a,
+                  const word_vec &b)
+{
+    word_vec c(std::max(a.size(), b.size()), 0);
+    for (size_t i = 0; i < c.size(); i++)
+        c[i] = F.add(i < a.size() ? a[i] : 0, i < b.size() ? b[i] : 0);
+    strip(c);
+    return c;
+}
+
+template <unsigned Bits>
+word_vec word_sub(const WordModulus<Bits> &F, const word_vec &a,
+                  const word_vec &b)
+{
+    word_vec c(std::max(a.size(), b.size()), 0);
+    for (size_t i = 0; i < c.size(); i++)
+        c[i] = F.sub(i < a.size() ? a[i] : 0, i < b.size() ? b[i] : 0);
+    strip(c);
+    return c;
+}
+
+// Inverse of the power series f modulo x**n by Newton iteration, for an
+// invertible f[0]. Each step doubles the precision: g = g (2 - f g).
+template <unsigned Bits>
+word_vec series_inverse(const WordModulus<Bits> &F, const word_vec &f,
+                        size_t n)
+{
+    word_vec g(1, word_inverse(f[0], F.p()));
+    for (size_t k = 1; k < n;) {
+        k = std::min(2 * k, n);
+        word_vec e = word_mul_trunc(F, f, g, k);
+        for (auto &c : e)
+            c = F.neg(c);
+        if (e.empty())
+            e.push_back(0);
+        e[0] = F.add(e[0], 2 % F.p());
+        g = word_mul_trunc(F, g, e, k);
+    }
+    return g;
+}
+
+// Division with remainder by a fixed nonzero polynomial b. Small cases use
+// long division. Otherwise the quotient of a is the reversal of rev(a) /
+// rev(b) modulo x**m, where m is its length, and the inverse of rev(b) is
+// computed once and kept for the following divisions.
+template <unsigned Bits>
+class WordDivisor
+{
+private:
+    const WordModulus<Bits> &F_;
+    word_vec b_, nb_, rev_inv_;
+    uint64_t inv_;
+
+    // As in GaloisFieldDict::gf_div, each coefficient of the output is
+    // a[it] - sum of out[it - j + db] * b[j], times `inv` for the quotient
+    void divrem_basecase(const word_vec &a, word_vec *quo, word_vec *rem) const
+    {
+        const size_t da = a.size() - 1, db = b_.size() - 1;
+        word_vec out(a);
+        for (size_t it = da + 1; it-- != 0;) {
+            const size_t lo = db + it > da ? db + it - da : 0;
+            const size_t hi = std::min(it + 1, db);
+            uint128_t acc = out[it];
+            unsigned n = 0;
+            for (size_t j = lo; j < hi; j++) {
+                acc += (uint128_t)out[it - j + db] * nb_[j];
+                if (++n == WordModulus<Bits>::terms) {
+                    acc = F_.reduce(acc);
+                    n = 0;
+                }
+            }
+            out[it] = F_.reduce(acc);
+            if (it >= db)
+                out[it] = F_.mul(out[it], inv_);
+        }
+        if (quo) {
+            quo->assign(out.begin() + db, out.end());
+            strip(*quo);
+        }
+        if (rem) {
+            out.resize(db);
+            strip(out);
+            rem->swap(out);
+        }
+    }
+
+public:
+    WordDivisor(const WordModulus<Bits> &F, const word_vec &b)
+        : F_(F), b_(b), nb_(b.size() - 1),
+          inv_(word_inverse(b.back(), F.p()))
+    {
+        for (size_t j = 0; j + 1 < b.size(); j++)
+            nb_[j] = F.neg(b[j]);
+    }
+
+    const word_vec &get_poly() const
+    {
+        return b_;
+    }
+
+    void divrem(const word_vec &a, word_vec *quo, word_vec *rem)
+    {
+        if (a.size() < b_.size()) {
+            if (quo)
+                quo->clear();
+            if (rem)
+                *rem = a;
+            return;
+        }
+        const size_t db = b_.size() - 1, m = a.size() - db;
+        if (db < newton_threshold or m < newton_threshold) {
+            divrem_basecase(a, quo, rem);
+            return;
+        }
+        if (rev_inv_.size() < m) {
+            // Precision of at least db, so that the division of a product
+            // of two remainders needs a single inversion
+            const size_t prec = std::max(m, db);
+            word_vec rb(std::min(prec, b_.size()));
+            for (size_t i = 0; i < rb.size(); i++)
+                rb[i] = b_[db - i];
+            rev_inv_ = series_inverse(F_, rb, prec);
+            rev_inv_.resize(prec, 0);
+        }
+        word_vec ra(m);
+        for (size_t i = 0; i < m; i++)
+            ra[i] = a[a.size() - 1 - i];
+        word_vec rq = word_mul_trunc(F_, ra, rev_inv_, m);
+        rq.resize(m, 0);
+        word_vec q(rq.rbegin(), rq.rend());
+        strip(q);
+        if (rem) {
+            word_vec qb = word_mul_trunc(F_, q, b_, db);
+            word_vec r(db);
+            for (size_t i = 0; i < db; i++)
+                r[i] = F_.sub(a[i], i < qb.size() ? qb[i] : 0);
+            strip(r);
+            rem->swap(r);
+        }
+        if (quo)
+            quo->swap(q);
+    }
+};
+
+// Remainder of `a` by the nonzero `b`
+template <unsigned Bits>
+word_vec word_rem(const WordModulus<Bits> &F, const word_vec &a,
+                  const word_vec &b)
+{
+    word_vec r;
+    WordDivisor<Bits>(F, b).divrem(a, nullptr, &r);
+    return r;
+}
+
+// 2 x 2 matrix of polynomials
+struct WordMatrix {
+    word_vec m[2][2];
+};
+
+WordMatrix identity_matrix()
+{
+    WordMatrix I;
+    I.m[0][0] = I.m[1][1] = word_vec(1, 1);
+    return I;
+}
+
+template <unsigned Bits>
+WordMatrix matrix_mul(const WordModulus<Bits> &F, const WordMatrix &A,
+                      const WordMatrix &B)
+{
+    WordMatrix C;
+    for (unsigned i = 0; i < 2; i++)
+        for (unsigned j = 0; j < 2; j++)
+            C.m[i][j] = word_add(F, word_mul(F, A.m[i][0], B.m[0][j]),
+                                 word_mul(F, A.m[i][1], B.m[1][j]));
+    return C;
+}
+
+// (a, b) = M (a, b)
+template <unsigned Bits>
+void matrix_apply(const WordModulus<Bits> &F, const WordMatrix &M,
+                  word_vec &a, word_vec &b)
+{
+    word_vec c = word_add(F, word_mul(F, M.m[0][0], a),
+                          word_mul(F, M.m[0][1], b));
+    b = word_add(F, word_mul(F, M.m[1][0], a), word_mul(F, M.m[1][1], b));
+    a.swap(c);
+}
+
+// One step of the Euclidean algorithm: (a, b) = (b, a mod b) and
+// M = [[0, 1], [1, -q]] M, where q is the quotient
+template <unsigned Bits>
+void euclid_step(const WordModulus<Bits> &F, word_vec &a, word_vec &b,
+                 WordMatrix &M)
+{
+    word_vec q, r;
+    WordDivisor<Bits>(F, b).divrem(a, &q, &r);
+    for (unsigned j = 0; j < 2; j++) {
+        word_vec t = word_sub(F, M.m[0][j], word_mul(F, q, M.m[1][j]));
+        M.m[0][j].swap(M.m[1][j]);
+        M.m[1][j].swap(t);
+    }
+    a.swap(b);
+    b.swap(r);
+}
+
+// Half-gcd of a and b with deg a > deg b. Returns the matrix M of the
+// Euclidean steps with M (a, b) = (c, d) and deg d < ceil(deg a / 2) <=
+// deg c. The quotients only depend on the leading coefficients, so the
+// first half of the steps is found from a and b divided by x**m, and the
+// second half from the remainders divided by x**k.
+template <unsigned Bits>
+WordMatrix hgcd(const WordModulus<Bits> &F, const word_vec &a,
+                const word_vec &b)
+{
+    const long m = (deg(a) + 1) / 2;
+    if (deg(b) < m)
+        return identity_matrix();
+    word_vec c = a, d = b;
+    WordMatrix R;
+    if (deg(a) < (long)hgcd_threshold) {
+        R = identity_matrix();
+        while (deg(d) >= m)
+            euclid_step(F, c, d, R);
+        return R;
+    }
+
+    R = hgcd(F, word_vec(a.begin() + m, a.end()),
+             word_vec(b.begin() + m, b.end()));
+    matrix_apply(F, R, c, d);
+    if (deg(d) < m)
+        return R;
+    euclid_step(F, c, d, R);
+    if (deg(d) < m)
+        return R;
+    const long k = 2 * m - deg(c);
+    const WordMatrix S = hgcd(F, word_vec(c.begin() + k, c.end()),
+                              word_vec(d.begin() + k, d.end()));
+    return matrix_mul(F, S, R);
+}
+
+// Monic gcd of `a` and `b`
+template <unsigned Bits>
+word_vec word_gcd(const WordModulus<Bits> &F, word_vec a, word_vec b)
+{
+    if (a.size() < b.size())
+        a.swap(b);
+    word_vec r;
+    while (not b.empty()) {
+        if (deg(b) >= (long)gcd_threshold and deg(a) > deg(b)) {
+            matrix_apply(F, hgcd(F, a, b), a, b);
+            if (b.empty())
+                break;
+        }
+        r = word_rem(F, a, b);
+        a.swap(b);
+        b.swap(r);
+    }
+    if (not a.empty() and a.back() != 1) {
+        const uint64_t inv = word_inverse(a.back(), F.p());
+        for (auto &c : a)
+            c = F.mul(c, inv);
+    }
+    return a;
+}
+
+// Calls `kernel` with the WordModulus of `modulo` if it is below 2**62 and
+// fits in an unsigned long. Returns false otherwise.
+template <typename Kernel>
+bool word_dispatch(const integer_class &modulo, Kernel &kernel)
+{
+    if (modulo <= 1 or not mp_fits_ulong_p(modulo))
+        return false;
+    const uint64_t p = mp_get_ui(modulo);
+    if ((p >> 32) == 0)
+        kernel(WordModulus<32>(p));
+    else if ((p >> 62) == 0)
+        kernel(WordModulus<62>(p));
+    else
+        return false;
+    return true;
+}
+
+struct WordMul {
+    const std::vector<integer_class> &a, &b;
+    std::vector<integer_class> &c;
+
+    template <unsigned Bits>
+    void operator()(const WordModulus<Bits> &F)
+    {
+        c = from_words(word_mul(F, to_words(a), to_words(b)));
+    }
+};
+
+struct WordDivRem {
+    const std::vector<integer_class> &a, &b;
+    std::vector<integer_class> *quo, *rem;
+
+    template <unsigned Bits>
+    void operator()(const WordModulus<Bits> &F)
+    {
+        word_vec q, r;
+        WordDivisor<Bits>(F, to_words(b))
+            .divrem(to_words(a), quo ? &q : nullptr, rem ? &r : nullptr);
+        if (quo)
+            *quo = from_words(q);
+        if (rem)
+            *rem = from_words(r);
+    }
+};
+
+// Monic gcd, as in GaloisFieldDict::gf_gcd
+struct WordGcd {
+    const std::vector<integer_class> &a, &b;
+    std::vector<integer_class> &g;
+
+    template <unsigned Bits>
+    void operator()(const WordModulus<Bits> &F)
+    {
+        g = from_words(word_gcd(F, to_words(a), to_words(b)));
+    }
+};
+
+// f**n % m for n > 2, as in GaloisFieldDict::gf_pow_mod
+struct WordPowMod {
+    const std::vector<integer_class> &f, &m;
+    unsigned long n;
+    std::vector<integer_class> &out;
+
+    template <unsigned Bits>
+    void operator()(const WordModulus<Bits> &F)
+    {
+        WordDivisor<Bits> M(F, to_words(m));
+        word_vec in = to_words(f), h(1, 1), t;
+        while (true) {
+            if (n & 1) {
+                t = word_mul(F, h, in);
+                M.divrem(t, nullptr, &h);
+            }
+            n >>= 1;
+            if (n == 0)
+                break;
+            t = word_mul(F, in, in);
+            M.divrem(t, nullptr, &in);
+        }
+        out = from_words(h);
+    }
+};
+
+// g(h) % m by Horner's rule, as in GaloisFieldDict::gf_compose_mod
+struct WordComposeMod {
+    const std::vector<integer_class> &g, &h, &m;
+    std::vector<integer_class> &out;
+
+    template <unsigned Bits>
+    void operator()(const WordModulus<Bits> &F)
+    {
+        WordDivisor<Bits> M(F, to_words(m));
+        const word_vec wg = to_words(g), wh = to_words(h);
+        word_vec r, t;
+        M.divrem(word_vec(1, wg.back()), nullptr, &r);
+        for (size_t i = wg.size() - 1; i-- > 0;) {
+            t = word_mul(F, r, wh);
+            if (t.empty())
+                t.push_back(0);
+            t[0] = F.add(t[0], wg[i]);
+            strip(t);
+            M.divrem(t, nullptr, &r);
+        }
+        out = from_words(r);
+    }
+};
+
+// h**i % m for 1 <= i < n, as in GaloisFieldDict::gf_frobenius_monomial_base
+struct WordPowers {
+    const std::vector<integer_class> &h, &m;
+    std::vector<GaloisFieldDict> &out;
+
+    template <unsigned Bits>
+    void operator()(const WordModulus<Bits> &F)
+    {
+        WordDivisor<Bits> M(F, to_words(m));
+        const word_vec wh = to_words(h);
+        word_vec r = wh, t;
+        for (size_t i = 1; i < out.size(); i++) {
+            out[i].dict_ = from_words(r);
+            if (i + 1 < out.size()) {
+                t = word_mul(F, r, wh);
+                M.divrem(t, nullptr, &r);
+            }
+        }
+    }
+};
+
+// g**p % f = sum of g[i] * b[i], where b[i] = x**(i p) % f, as in
+// GaloisFieldDict::gf_frobenius_map. `g` has degree below that of f.
+struct WordFrobeniusMap {
+    const std::vector<integer_class> &g;
+    const std::vector<GaloisFieldDict> &b;
+    std::vector<integer_class> &out;
+
+    template <unsigned Bits>
+    void operator()(const WordModulus<Bits> &F)
+    {
+        size_t n = 1;
+        for (size_t i = 1; i < g.size(); i++)
+            n = std::max(n, b[i].get_dict().size());
+        std::vector<uint128_t> acc(n, 0);
+        acc[0] = mp_get_ui(g[0]);
+        unsigned terms = 0;
+        for (size_t i = 1; i < g.size(); i++) {
+            const uint64_t c = mp_get_ui(g[i]);
+            if (c == 0)
+                continue;
+            const std::vector<integer_class> &row = b[i].get_dict();
+            for (size_t j = 0; j < row.size(); j++)
+                acc[j] += (uint128_t)c * mp_get_ui(row[j]);
+            if (++terms == WordModulus<Bits>::terms) {
+                for (auto &x : acc)
+                    x = F.reduce(x);
+                terms = 0;
+            }
+        }
+        word_vec w(n);
+        for (size_t j = 0; j < n; j++)
+            w[j] = F.reduce(acc[j]);
+        strip(w);
+        out = from_words(w);
+    }
+};
+
+#else
+
+template <typename Kernel>
+bool word_dispatch(const integer_class &modulo, Kernel &kernel)
+{
+    return false;
+}
+
+struct WordMul {
+    const std::vector<integer_class> &a, &b;
+    std::vector<integer_class> &c;
+};
+
+struct WordDivRem {
+    const std::vector<integer_class> &a, &b;
+    std::vector<integer_class> *quo, *rem;
+};
+
+struct WordGcd {
+    const std::vector<integer_class> &a, &b;
+    std::vector<integer_class> &g;
+};
+
+struct WordPowMod {
+    const std::vector<integer_class> &f, &m;
+    unsigned long n;
+    std::vector<integer_class> &out;
+};
+
+struct WordComposeMod {
+    const std::vector<integer_class> &g, &h, &m;
+    std::vector<integer_class> &out;
+};
+
+struct WordPowers {
+    const std::vector<integer_class> &h, &m;
+    std::vector<GaloisFieldDict> &out;
+};
+
+struct WordFrobeniusMap {
+    const std::vector<integer_class> &g;
+    const std::vector<GaloisFieldDict> &b;
+    std::vector<integer_class> &out;
+};
+
+#endif
+} // namespace
+
+bool GaloisFieldDict::word_divrem(const GaloisFieldDict &a,
+                                  const GaloisFieldDict &b,
+                                  GaloisFieldDict *quo, GaloisFieldDict *rem)
+{
+    WordDivRem kernel{a.dict_, b.dict_, quo ? &quo->dict_ : nullptr,
+                      rem ? &rem->dict_ : nullptr};
+    if (not word_dispatch(a.modulo_, kernel))
+        return false;
+    if (quo)
+        quo->modulo_ = a.modulo_;
+    if (rem)
+        rem->modulo_ = a.modulo_;
+    return true;
+}
+
 GaloisFieldDict GaloisFieldDict::mul(const GaloisFieldDict &a,
                                      const GaloisFieldDict &b)
 {
@@ -189,6 +1142,11 @@ GaloisFieldDict GaloisFieldDict::mul(const GaloisFieldDict &a,
         return b;
 
     GaloisFieldDict p;
+    p.modulo_ = a.modulo_;
+    WordMul kernel{a.dict_, b.dict_, p.dict_};
+    if (word_dispatch(a.modulo_, kernel))
+        return p;
+
     p.dict_.resize(a.degree() + b.degree() + 1, integer_class(0));
     p.modulo_ = a.modulo_;
     for (unsigned int i = 0; i <= a.degree(); i++)
@@ -226,7 +1184,7 @@ void GaloisFieldDict::gf_div(const GaloisFieldDict &o,
     if (deg_dividend < deg_divisor) {
         *quo = GaloisFieldDict::from_vec(dict_out, modulo_);
         *rem = GaloisFieldDict::from_vec(dict_, modulo_);
-    } else {
+    } else if (not word_divrem(*this, o, quo.get(), rem.get())) {
         dict_out = dict_;
         integer_class inv;
         mp_invert(inv, *(dict_divisor.rbegin()), modulo_);
@@ -341,6 +1299,11 @@ GaloisFieldDict GaloisFieldDict::gf_gcd(const GaloisFieldDict &o) const
 {
     if (modulo_ != o.modulo_)
         throw SymEngineException("Error: field must be same.");
+    GaloisFieldDict h;
+    h.modulo_ = modulo_;
+    WordGcd kernel{dict_, o.dict_, h.dict_};
+    if (word_dispatch(modulo_, kernel))
+        return h;
     GaloisFieldDict f = down_cast<const GaloisFieldDict &>(*this);
     GaloisFieldDict g = o;
     GaloisFieldDict temp_out;
@@ -490,6 +1453,11 @@ GaloisFieldDict GaloisFieldDict::gf_compose_mod(const GaloisFieldDict &g,
         return g;
     GaloisFieldDict out
         = GaloisFieldDict::from_vec({*(g.dict_.rbegin())}, modulo_);
+    if (g.dict_.size() >= 2 and not dict_.empty()) {
+        WordComposeMod kernel{g.dict_, h.dict_, dict_, out.dict_};
+        if (word_dispatch(modulo_, kernel))
+            return out;
+    }
     if (g.dict_.size() >= 2) {
         for (auto i = g.dict_.size() - 2;; --i) {
             out *= h;
@@ -516,6 +1484,13 @@ GaloisFieldDict GaloisFieldDict::gf_pow_mod(const GaloisFieldDict &f,
     if (n == 2) {
         return f.gf_sqr() % (*this);
     }
+    if (not dict_.empty()) {
+        GaloisFieldDict out;
+        out.modulo_ = modulo_;
+        WordPowMod kernel{f.dict_, dict_, n, out.dict_};
+        if (word_dispatch(modulo_, kernel))
+            return out;
+    }
     GaloisFieldDict h = GaloisFieldDict::from_vec({1_z}, modulo_);
     auto mod = n;
     while (true) {
@@ -550,6 +1525,11 @@ std::vector<GaloisFieldDict> GaloisFieldDict::gf_frobenius_monomial_base() const
     } else if (n > 1) {
         b[1] = gf_pow_mod(GaloisFieldDict::from_vec({0_z, 1_z}, modulo_),
                           mp_get_ui(modulo_));
+        for (unsigned i = 2; i < n; ++i)
+            b[i].modulo_ = modulo_;
+        WordPowers kernel{b[1].dict_, dict_, b};
+        if (word_dispatch(modulo_, kernel))
+            return b;
         for (unsigned i = 2; i < n; ++i) {
             b[i] = b[i - 1] * b[1];
             b[i] %= (*this);
@@ -573,6 +1553,10 @@ GaloisFieldDict::gf_frobenius_map(const GaloisFieldDict &g,
         return temp_out;
     }
     m = temp_out.degree();
+    out.modulo_ = modulo_;
+    WordFrobeniusMap kernel{temp_out.dict_, b, out.dict_};
+    if (word_dispatch(modulo_, kernel))
+        return out;
     out = GaloisFieldDict::from_vec({temp_out.dict_[0]}, modulo_);
     for (unsigned i = 1; i <= m; ++i) {
         auto v = b[i];
@@ -646,7 +1630,11 @@ GaloisFieldDict::gf_ddf_zassenhaus() const
             factors.push_back({h, i});
             f /= h;
             g %= f;
-            b = f.gf_frobenius_monomial_base();
+            // x**(j p) % f is the remainder of x**(j p) modulo the old f,
+            // which f divides
+            b.resize(f.degree());
+            for (auto &e : b)
+                e %= f;
         }
         ++i;
     }
@@ -59,6 +59,11 @@ public:
     GaloisFieldDict &operator=(const GaloisFieldDict &) = default;
     void gf_div(const GaloisFieldDict &o, const Ptr<GaloisFieldDict> &quo,
                 const Ptr<GaloisFieldDict> &rem) const;
+    // Quotient and remainder of `a` by the nonzero `b`, computed on machine
+    // words. Either output may be null or alias `a`.
+    // Returns false if `modulo_` does not fit in a word.
+    static bool word_divrem(const GaloisFieldDict &a, const GaloisFieldDict &b,
+                            GaloisFieldDict *quo, GaloisFieldDict *rem);
 
     GaloisFieldDict gf_lshift(const integer_class n) const;
     void gf_rshift(const integer_class n, const Ptr<GaloisFieldDict> &quo,
@@ -403,6 +408,8 @@ public:
             dict_.clear();
             return down_cast<GaloisFieldDict &>(*this);
         }
+        if (word_divrem(*this, other, this, nullptr))
+            return down_cast<GaloisFieldDict &>(*this);
         dict_out.swap(dict_);
         dict_.resize(deg_dividend - deg_divisor + 1);
         integer_class coeff;
@@ -467,6 +474,8 @@ public:
         if (deg_dividend < deg_divisor) {
             return down_cast<GaloisFieldDict &>(*this);
         }
+        if (word_divrem(*this, other, nullptr, this))
+            return down_cast<GaloisFieldDict &>(*this);
         dict_out.swap(dict_);
         dict_.resize(deg_divisor);
         integer_class coeff;
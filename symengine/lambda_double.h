@@ -2,6 +2,7 @@
 #define SYMENGINE_LAMBDA_DOUBLE_H
 
 #include <symengine/eval_double.h>
+#include <symengine/cse.h>
 #include <symengine/symengine_exception.h>
 #include <symengine/visitor.h>
 
@@ -27,8 +28,9 @@ protected:
     std::map<RCP<const Basic>, unsigned, RCPBasicKeyLess>
         cse_intermediate_fns_map;
     std::vector<fn> cse_intermediate_fns;
+    std::vector<unsigned> cse_intermediate_registers;
     fn result_;
-    vec_basic symbols;
+    std::map<RCP<const Basic>, unsigned, RCPBasicKeyLess> symbols;
 
 public:
     void init(const vec_basic &x, const Basic &b, bool cse = false)
@@ -42,30 +44,32 @@ public:
     {
         results.clear();
         cse_intermediate_fns.clear();
-        symbols = inputs;
+        cse_intermediate_registers.clear();
+        symbols.clear();
+        for (unsigned i = 0; i < inputs.size(); ++i)
+            symbols.insert(std::make_pair(inputs[i], i));
         if (not cse) {
             for (auto &p : outputs) {
                 results.push_back(apply(*p));
             }
         } else {
-            vec_basic reduced_exprs;
-            vec_pair replacements;
             // cse the outputs
-            SymEngine::cse(replacements, reduced_exprs, outputs);
-            for (auto &rep : replacements) {
-                auto res = apply(*(rep.second));
-                // Store the replacement symbol values in a dictionary for
-                // faster
-                // lookup for initialization
-                cse_intermediate_fns_map[rep.first]
-                    = cse_intermediate_fns.size();
+            StraightLineProgram prog(inputs, outputs);
+            const vec_pair &instructions = prog.get_instructions();
+            for (unsigned i = 0; i < instructions.size(); i++) {
+                auto res = apply(*(instructions[i].second));
+                // Store the register of the replacement symbol in a
+                // dictionary for faster lookup for initialization
+                cse_intermediate_fns_map[instructions[i].first]
+                    = prog.get_registers()[i];
                 // Store it in a vector for faster use in call
                 cse_intermediate_fns.push_back(res);
+                cse_intermediate_registers.push_back(prog.get_registers()[i]);
             }
-            cse_intermediate_results.resize(cse_intermediate_fns.size());
+            cse_intermediate_results.resize(prog.get_nregisters());
             // Generate functions for all the reduced exprs and save it
-            for (unsigned i = 0; i < outputs.size(); i++) {
-                results.push_back(apply(*reduced_exprs[i]));
+            for (auto &e : prog.get_outputs()) {
+                results.push_back(apply(*e));
             }
             // We don't need the cse_intermediate_fns_map anymore
             cse_intermediate_fns_map.clear();
@@ -90,7 +94,8 @@ public:
     {
         if (cse_intermediate_fns.size() > 0) {
             for (unsigned i = 0; i < cse_intermediate_fns.size(); ++i) {
-                cse_intermediate_results[i] = cse_intermediate_fns[i](inps);
+                cse_intermediate_results[cse_intermediate_registers[i]]
+                    = cse_intermediate_fns[i](inps);
             }
         }
         for (unsigned i = 0; i < results.size(); ++i) {
@@ -101,11 +106,11 @@ public:
 
     void bvisit(const Symbol &x)
     {
-        for (unsigned i = 0; i < symbols.size(); ++i) {
-            if (eq(x, *symbols[i])) {
-                result_ = [=](const T *x) { return x[i]; };
-                return;
-            }
+        auto s = symbols.find(x.rcp_from_this());
+        if (s != symbols.end()) {
+            unsigned i = s->second;
+            result_ = [=](const T *x) { return x[i]; };
+            return;
         }
         auto it = cse_intermediate_fns_map.find(x.rcp_from_this());
         if (it != cse_intermediate_fns_map.end()) {
@@ -143,28 +148,56 @@ public:
     }
 #endif
 
+    // Unit coefficients, a zero constant term and exponents 1 and 2 are
+    // special cased, they are common in Jacobians and cost a call each
     void bvisit(const Add &x)
     {
-        fn tmp = apply(*x.get_coef());
+        fn tmp;
         fn tmp1, tmp2;
         for (const auto &p : x.get_dict()) {
             tmp1 = apply(*(p.first));
-            tmp2 = apply(*(p.second));
-            tmp = [=](const T *x) { return tmp(x) + tmp1(x) * tmp2(x); };
+            if (not p.second->is_one()) {
+                tmp2 = apply(*(p.second));
+                tmp1 = [=](const T *x) { return tmp2(x) * tmp1(x); };
+            }
+            if (tmp) {
+                tmp = [=](const T *x) { return tmp(x) + tmp1(x); };
+            } else {
+                tmp = tmp1;
+            }
+        }
+        if (not x.get_coef()->is_zero()) {
+            tmp2 = apply(*x.get_coef());
+            tmp = [=](const T *x) { return tmp2(x) + tmp(x); };
         }
         result_ = tmp;
     }
 
     void bvisit(const Mul &x)
     {
-        fn tmp = apply(*x.get_coef());
+        fn tmp;
         fn tmp1, tmp2;
         for (const auto &p : x.get_dict()) {
             tmp1 = apply(*(p.first));
-            tmp2 = apply(*(p.second));
-            tmp = [=](const T *x) {
-                return tmp(x) * std::pow(tmp1(x), tmp2(x));
-            };
+            if (eq(*p.second, *integer(2))) {
+                tmp2 = tmp1;
+                tmp1 = [=](const T *x) {
+                    T b = tmp2(x);
+                    return b * b;
+                };
+            } else if (not eq(*p.second, *one)) {
+                tmp2 = apply(*(p.second));
+                tmp1 = [=](const T *x) { return std::pow(tmp1(x), tmp2(x)); };
+            }
+            if (tmp) {
+                tmp = [=](const T *x) { return tmp(x) * tmp1(x); };
+            } else {
+                tmp = tmp1;
+            }
+        }
+        if (not x.get_coef()->is_one()) {
+            tmp2 = apply(*x.get_coef());
+            tmp = [=](const T *x) { return tmp2(x) * tmp(x); };
         }
         result_ = tmp;
     }
@@ -0,0 +1,140 @@
+#include <symengine/lambda_matrix.h>
+
+namespace SymEngine
+{
+
+namespace
+{
+
+// Number of systems solved together. The systems are interleaved so that the
+// loops over them are innermost, have a fixed trip count and are vectorized.
+const unsigned lanes = 8;
+
+// Solves `lanes` interleaved systems A X = B in place by LU decomposition with
+// partial pivoting. Entry (i, j) of system l is a[(i * n + j) * lanes + l] for
+// A and b[(i * nrhs + j) * lanes + l] for B, which is overwritten by X. For
+// N > 0 the size is the constant N, so the compiler unrolls the loops over
+// rows and columns; N == 0 is the kernel for any size `n_`.
+template <unsigned N>
+void lu_solve_lanes(unsigned n_, unsigned nrhs, double *a, double *b)
+{
+    const unsigned n = N > 0 ? N : n_;
+    // Work on local arrays, which do not alias the matrices
+    double largest[lanes], inv[lanes], f[lanes], x[lanes];
+    unsigned p[lanes];
+    for (unsigned k = 0; k < n; k++) {
+        double *ak = &a[k * n * lanes];
+        for (unsigned l = 0; l < lanes; l++) {
+            largest[l] = std::abs(ak[k * lanes + l]);
+            p[l] = k;
+        }
+        for (unsigned i = k + 1; i < n; i++) {
+            const double *aik = &a[(i * n + k) * lanes];
+            for (unsigned l = 0; l < lanes; l++) {
+                const double v = std::abs(aik[l]);
+                p[l] = v > largest[l] ? i : p[l];
+                largest[l] = v > largest[l] ? v : largest[l];
+            }
+        }
+        // Rows are exchanged system by system. This touches 2 * n entries per
+        // system, while exchanges by selects would touch every remaining row.
+        for (unsigned l = 0; l < lanes; l++) {
+            if (p[l] == k)
+                continue;
+            for (unsigned j = k; j < n; j++)
+                std::swap(ak[j * lanes + l], a[(p[l] * n + j) * lanes + l]);
+            for (unsigned j = 0; j < nrhs; j++)
+                std::swap(b[(k * nrhs + j) * lanes + l],
+                          b[(p[l] * nrhs + j) * lanes + l]);
+        }
+
+        for (unsigned l = 0; l < lanes; l++)
+            inv[l] = 1.0 / ak[k * lanes + l];
+        for (unsigned i = k + 1; i < n; i++) {
+            double *ai = &a[i * n * lanes];
+            for (unsigned l = 0; l < lanes; l++)
+                f[l] = ai[k * lanes + l] * inv[l];
+            for (unsigned j = k + 1; j < n; j++)
+                for (unsigned l = 0; l < lanes; l++)
+                    ai[j * lanes + l] -= f[l] * ak[j * lanes + l];
+            for (unsigned j = 0; j < nrhs; j++) {
+                double *bi = &b[(i * nrhs + j) * lanes];
+                const double *bk = &b[(k * nrhs + j) * lanes];
+                for (unsigned l = 0; l < lanes; l++)
+                    x[l] = bi[l] - f[l] * bk[l];
+                for (unsigned l = 0; l < lanes; l++)
+                    bi[l] = x[l];
+            }
+        }
+        // The back substitution multiplies by the inverse of the pivot
+        for (unsigned l = 0; l < lanes; l++)
+            ak[k * lanes + l] = inv[l];
+    }
+
+    for (unsigned i = n; i-- > 0;) {
+        const double *ai = &a[i * n * lanes];
+        for (unsigned j = 0; j < nrhs; j++) {
+            double *bi = &b[(i * nrhs + j) * lanes];
+            for (unsigned l = 0; l < lanes; l++)
+                x[l] = bi[l];
+            for (unsigned t = i + 1; t < n; t++)
+                for (unsigned l = 0; l < lanes; l++)
+                    x[l] -= ai[t * lanes + l] * b[(t * nrhs + j) * lanes + l];
+            for (unsigned l = 0; l < lanes; l++)
+                bi[l] = x[l] * ai[i * lanes + l];
+        }
+    }
+}
+
+typedef void (*LUSolveKernel)(unsigned, unsigned, double *, double *);
+
+const LUSolveKernel lu_solve_kernels[] = {
+    lu_solve_lanes<0>,  lu_solve_lanes<1>,  lu_solve_lanes<2>,
+    lu_solve_lanes<3>,  lu_solve_lanes<4>,  lu_solve_lanes<5>,
+    lu_solve_lanes<6>,  lu_solve_lanes<7>,  lu_solve_lanes<8>,
+    lu_solve_lanes<9>,  lu_solve_lanes<10>, lu_solve_lanes<11>,
+    lu_solve_lanes<12>,
+};
+} // namespace
+
+void batch_LU_solve(unsigned n, unsigned nrhs, size_t batch, double *A,
+                    double *B)
+{
+    const LUSolveKernel solve
+        = n < 13 ? lu_solve_kernels[n] : lu_solve_lanes<0>;
+    const size_t nA = (size_t)n * n, nB = (size_t)n * nrhs;
+    const long nchunks = (long)((batch + lanes - 1) / lanes);
+#pragma omp parallel if (nchunks > 1)
+    {
+        std::vector<double> a(nA * lanes), b(nB * lanes);
+#pragma omp for schedule(static)
+        for (long c = 0; c < nchunks; c++) {
+            const size_t first = (size_t)c * lanes;
+            const unsigned count
+                = (unsigned)std::min<size_t>(lanes, batch - first);
+            // Lanes without a system solve the identity
+            for (unsigned l = 0; l < lanes; l++) {
+                if (l < count) {
+                    const double *As = &A[(first + l) * nA];
+                    const double *Bs = &B[(first + l) * nB];
+                    for (size_t i = 0; i < nA; i++)
+                        a[i * lanes + l] = As[i];
+                    for (size_t i = 0; i < nB; i++)
+                        b[i * lanes + l] = Bs[i];
+                } else {
+                    for (size_t i = 0; i < nA; i++)
+                        a[i * lanes + l] = i % (n + 1) == 0 ? 1.0 : 0.0;
+                    for (size_t i = 0; i < nB; i++)
+                        b[i * lanes + l] = 0.0;
+                }
+            }
+            solve(n, nrhs, a.data(), b.data());
+            for (unsigned l = 0; l < count; l++) {
+                double *Bs = &B[(first + l) * nB];
+                for (size_t i = 0; i < nB; i++)
+                    Bs[i] = b[i * lanes + l];
+            }
+        }
+    }
+}
+}
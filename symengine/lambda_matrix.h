@@ -0,0 +1,145 @@
+/**
+ *  \file lambda_matrix.h
+ *  Compiled numeric evaluation of symbolic matrices
+ *
+ **/
+
+#ifndef SYMENGINE_LAMBDA_MATRIX_H
+#define SYMENGINE_LAMBDA_MATRIX_H
+
+#include <symengine/lambda_double.h>
+#include <symengine/matrix.h>
+
+namespace SymEngine
+{
+
+//! Evaluates all entries of a symbolic matrix at numeric values of `inputs`.
+//! Entries that are zero are not compiled, and the others share a single
+//! common subexpression elimination. `Visitor` is LambdaRealDoubleVisitor or
+//! LLVMDoubleVisitor.
+template <typename Visitor = LambdaRealDoubleVisitor>
+class LambdaMatrix
+{
+private:
+    Visitor visitor_;
+    // Position in the output of each compiled entry, and of each zero entry
+    std::vector<unsigned> positions_, zeros_;
+    std::vector<double> values_;
+    // Whether the compiled entries are the whole output, in order
+    bool contiguous_;
+
+    void init(const vec_basic &inputs, const vec_basic &entries, bool cse)
+    {
+        vec_basic outputs;
+        positions_.clear();
+        zeros_.clear();
+        for (unsigned i = 0; i < entries.size(); i++) {
+            if (is_a<Integer>(*entries[i])
+                and down_cast<const Integer &>(*entries[i]).is_zero()) {
+                zeros_.push_back(i);
+            } else {
+                positions_.push_back(i);
+                outputs.push_back(entries[i]);
+            }
+        }
+        contiguous_ = zeros_.empty();
+        values_.resize(contiguous_ ? 0 : outputs.size());
+        visitor_.init(inputs, outputs, cse);
+    }
+
+public:
+    //! The output is the row-major array of all entries of `A`
+    void init(const vec_basic &inputs, const DenseMatrix &A, bool cse = true)
+    {
+        vec_basic entries;
+        entries.reserve(A.nrows() * A.ncols());
+        for (unsigned i = 0; i < A.nrows(); i++)
+            for (unsigned j = 0; j < A.ncols(); j++)
+                entries.push_back(A.get(i, j));
+        init(inputs, entries, cse);
+    }
+
+    //! The output is the value array of `A`, aligned with its column indices
+    void init(const vec_basic &inputs, const CSRMatrix &A, bool cse = true)
+    {
+        init(inputs, A.get_values(), cse);
+    }
+
+    void call(double *outs, const double *inps)
+    {
+        if (contiguous_) {
+            visitor_.call(outs, inps);
+            return;
+        }
+        visitor_.call(values_.data(), inps);
+        for (unsigned i = 0; i < positions_.size(); i++)
+            outs[positions_[i]] = values_[i];
+        for (unsigned i : zeros_)
+            outs[i] = 0.0;
+    }
+};
+
+//! Solves the `batch` systems A X = B of size `n` with `nrhs` right-hand
+//! sides by LU decomposition with partial pivoting. The row-major matrices of
+//! the systems follow each other in `A` and `B`. `B` is overwritten by the
+//! solutions and `A` is used as scratch space. Groups of systems are solved
+//! together by kernels specialized to sizes up to 12. A singular system gives
+//! non-finite solutions.
+void batch_LU_solve(unsigned n, unsigned nrhs, size_t batch, double *A,
+                    double *B);
+
+//! Solves many linear systems A X = B whose entries are the same expressions
+//! of `inputs`. A and B are evaluated by one LambdaMatrix for each group of
+//! parameter vectors and solved by `batch_LU_solve`.
+template <typename Visitor = LambdaRealDoubleVisitor>
+class LambdaLinearSolver
+{
+private:
+    LambdaMatrix<Visitor> AB_;
+    unsigned n_, nrhs_, ninputs_;
+    std::vector<double> ab_, a_;
+
+public:
+    //! `A` must be square and `B` have as many rows as `A`
+    void init(const vec_basic &inputs, const DenseMatrix &A,
+              const DenseMatrix &B, bool cse = true)
+    {
+        if (A.nrows() != A.ncols() or A.nrows() != B.nrows())
+            throw SymEngineException("Matrix dimensions do not match");
+        n_ = A.nrows();
+        nrhs_ = B.ncols();
+        ninputs_ = inputs.size();
+        DenseMatrix AB = A;
+        AB.row_join(B);
+        AB_.init(inputs, AB, cse);
+    }
+
+    //! Solves the systems for the `batch` parameter vectors that follow each
+    //! other in `inps`. The row-major solutions follow each other in `outs`.
+    void call(double *outs, const double *inps, size_t batch)
+    {
+        // Systems evaluated and solved at a time
+        const size_t group = 256;
+        const size_t width = n_ + nrhs_, nA = (size_t)n_ * n_,
+                     nB = (size_t)n_ * nrhs_;
+        ab_.resize(n_ * width);
+        a_.resize(group * nA);
+        for (size_t first = 0; first < batch; first += group) {
+            const size_t count = std::min(group, batch - first);
+            for (size_t s = 0; s < count; s++) {
+                AB_.call(ab_.data(), &inps[(first + s) * ninputs_]);
+                double *a = &a_[s * nA], *b = &outs[(first + s) * nB];
+                for (unsigned i = 0; i < n_; i++) {
+                    for (unsigned j = 0; j < n_; j++)
+                        a[i * n_ + j] = ab_[i * width + j];
+                    for (unsigned j = 0; j < nrhs_; j++)
+                        b[i * nrhs_ + j] = ab_[i * width + n_ + j];
+                }
+            }
+            batch_LU_solve(n_, nrhs_, count, a_.data(), &outs[first * nB]);
+        }
+    }
+};
+}
+
+#endif
@@ -37,6 +37,7 @@
 
 #include <symengine/llvm_double.h>
 #include <symengine/eval_double.h>
+#include <symengine/cse.h>
 
 namespace SymEngine
 {
@@ -169,17 +170,15 @@ void LLVMDoubleVisitor::init(const vec_basic &inputs, const vec_basic &outputs,
     std::vector<llvm::Value *> output_vals;
 
     if (cse) {
-        vec_basic reduced_exprs;
-        vec_pair replacements;
         // cse the outputs
-        SymEngine::cse(replacements, reduced_exprs, outputs);
-        for (auto &rep : replacements) {
+        StraightLineProgram prog(inputs, outputs);
+        for (auto &rep : prog.get_instructions()) {
             // Store the replacement symbol values in a dictionary
             replacement_symbol_ptrs[rep.first] = apply(*(rep.second));
         }
         // Generate IR for all the reduced exprs and save references
-        for (unsigned i = 0; i < outputs.size(); i++) {
-            output_vals.push_back(apply(*reduced_exprs[i]));
+        for (auto &e : prog.get_outputs()) {
+            output_vals.push_back(apply(*e));
         }
     } else {
         // Generate IR for all the output exprs and save references
@@ -7,6 +7,9 @@
 namespace SymEngine
 {
 
+class UIntPoly;
+class MIntPoly;
+
 // Base class for matrices
 class MatrixBase
 {
@@ -75,6 +78,28 @@ public:
 
 typedef std::vector<std::pair<int, int>> permutelist;
 
+//! How `pivot` chooses among the nonzero entries of a column
+enum class PivotStrategy {
+    //! The first nonzero entry
+    FirstNonzero,
+    //! The entry with the fewest nodes in its expression tree
+    SmallestSize,
+    //! The entry whose row has the fewest nonzeros right of the column, which
+    //! minimizes the Markowitz count since the column is fixed. Ties are
+    //! broken by expression size.
+    Markowitz
+};
+
+//! How `pivot` decides whether an entry is zero
+enum class ZeroTest {
+    //! Structural equality with zero
+    Structural,
+    //! Evaluation with `eval_double` at pseudo-random points, which also
+    //! finds zeros that are not simplified away, e.g. `(x + 1)**2 - x**2 - 2*x
+    //! - 1`. Entries that cannot be evaluated are taken to be nonzero.
+    NumericProbe
+};
+
 // ----------------------------- Dense Matrix --------------------------------//
 class DenseMatrix : public MatrixBase
 {
@@ -151,6 +176,9 @@ public:
     // Return the Jacobian of the matrix using sdiff
     friend void sjacobian(const DenseMatrix &A, const DenseMatrix &x,
                           DenseMatrix &result);
+    // Return the Hessian of the expression
+    friend void hessian(const RCP<const Basic> &f, const DenseMatrix &x,
+                        DenseMatrix &result);
 
     // Differentiate the matrix element-wise
     friend void diff(const DenseMatrix &A, const RCP<const Symbol> &x,
@@ -198,15 +226,18 @@ public:
     friend void fraction_free_gaussian_elimination(const DenseMatrix &A,
                                                    DenseMatrix &B);
     friend void pivoted_fraction_free_gaussian_elimination(
-        const DenseMatrix &A, DenseMatrix &B, permutelist &pivotlist);
+        const DenseMatrix &A, DenseMatrix &B, permutelist &pivotlist,
+        PivotStrategy strategy, ZeroTest zero_test);
     friend void pivoted_gauss_jordan_elimination(const DenseMatrix &A,
                                                  DenseMatrix &B,
                                                  permutelist &pivotlist);
     friend void fraction_free_gauss_jordan_elimination(const DenseMatrix &A,
                                                        DenseMatrix &B);
     friend void pivoted_fraction_free_gauss_jordan_elimination(
-        const DenseMatrix &A, DenseMatrix &B, permutelist &pivotlist);
-    friend unsigned pivot(DenseMatrix &B, unsigned r, unsigned c);
+        const DenseMatrix &A, DenseMatrix &B, permutelist &pivotlist,
+        PivotStrategy strategy, ZeroTest zero_test);
+    friend unsigned pivot(DenseMatrix &B, unsigned r, unsigned c,
+                          PivotStrategy strategy, ZeroTest zero_test);
 
     // Ax = b
     friend void diagonal_solve(const DenseMatrix &A, const DenseMatrix &b,
@@ -221,6 +252,8 @@ public:
     friend void fraction_free_gauss_jordan_solve(const DenseMatrix &A,
                                                  const DenseMatrix &b,
                                                  DenseMatrix &x);
+    friend void LU_solve(const DenseMatrix &A, const DenseMatrix &b,
+                         DenseMatrix &x);
 
     // Matrix Decomposition
     friend void fraction_free_LU(const DenseMatrix &A, DenseMatrix &LU);
@@ -240,8 +273,20 @@ public:
 
     // Determinant
     friend RCP<const Basic> det_bareis(const DenseMatrix &A);
+    friend RCP<const Basic> det_multimodular(const DenseMatrix &A);
     friend void berkowitz(const DenseMatrix &A,
                           std::vector<DenseMatrix> &polys);
+    friend RCP<const MIntPoly> det_interpolation(const DenseMatrix &A,
+                                                 const set_basic &gens);
+    friend RCP<const UIntPoly>
+    char_poly_interpolation(const DenseMatrix &A, const RCP<const Basic> &x);
+
+    // Multi-modular methods for Integer and Rational matrices
+    friend unsigned rank_multimodular(const DenseMatrix &A);
+    friend void nullspace_multimodular(const DenseMatrix &A,
+                                       DenseMatrix &result);
+    friend void solve_multimodular(const DenseMatrix &A, const DenseMatrix &b,
+                                   DenseMatrix &x);
 
     // Inverse
     friend void inverse_fraction_free_LU(const DenseMatrix &A, DenseMatrix &B);
@@ -279,6 +324,20 @@ public:
 
     bool is_canonical() const;
 
+    // Row pointers, column indices and values of the nonzeros
+    inline const std::vector<unsigned> &get_row_pointers() const
+    {
+        return p_;
+    }
+    inline const std::vector<unsigned> &get_col_indices() const
+    {
+        return j_;
+    }
+    inline const vec_basic &get_values() const
+    {
+        return x_;
+    }
+
     virtual bool eq(const MatrixBase &other) const;
 
     // Get and set elements
@@ -364,6 +423,8 @@ public:
                                  CSRMatrix &C);
     friend void csr_matmat_pass2(const CSRMatrix &A, const CSRMatrix &B,
                                  CSRMatrix &C);
+    friend void csr_mul_dense(const CSRMatrix &A, const DenseMatrix &B,
+                              DenseMatrix &C);
     friend void csr_diagonal(const CSRMatrix &A, DenseMatrix &D);
     friend void csr_scale_rows(CSRMatrix &A, const DenseMatrix &X);
     friend void csr_scale_columns(CSRMatrix &A, const DenseMatrix &X);
@@ -373,6 +434,8 @@ public:
         RCP<const Basic> (&bin_op)(const RCP<const Basic> &,
                                    const RCP<const Basic> &));
 
+    friend class CSRFactorization;
+
 private:
     std::vector<unsigned> p_;
     std::vector<unsigned> j_;
@@ -382,10 +445,72 @@ private:
     unsigned col_;
 };
 
+// Sparse LU and LDL factorizations of a square CSRMatrix, split into a
+// symbolic analysis and a numeric factorization. The analysis chooses a
+// symmetric fill-reducing permutation P by minimum degree on the pattern of
+// A + A**T and computes the nonzero pattern of the factors of P A P**T. Any
+// matrix whose pattern is contained in the analysed one can then be factorized
+// without repeating the analysis. No pivoting is done during the numeric
+// factorization.
+class CSRFactorization
+{
+public:
+    // With `reorder` false the natural order is kept, so that A = L U
+    CSRFactorization(const CSRMatrix &A, bool reorder = true);
+
+    // P A P**T = L U with L unit lower triangular. Returns false if a pivot
+    // is zero.
+    bool factorize_LU(const CSRMatrix &A);
+    // P A P**T = L D L**T for a symmetric A. Only the lower triangle of A is
+    // read, whatever P is, so it may be all that A stores. Returns false if a
+    // pivot is zero.
+    bool factorize_LDL(const CSRMatrix &A);
+
+    // Solve A x = b using the last factorization
+    void solve(const DenseMatrix &b, DenseMatrix &x) const;
+    RCP<const Basic> det() const;
+
+    // Factors of P A P**T from the last factorization
+    void get_LU(CSRMatrix &L, CSRMatrix &U) const;
+    void get_LDL(CSRMatrix &L, CSRMatrix &D) const;
+
+    // perm[i] is the row and column of A that is the i-th one of P A P**T
+    inline const std::vector<unsigned> &get_permutation() const
+    {
+        return perm_;
+    }
+    // Number of off-diagonal nonzeros in the pattern of L
+    inline unsigned get_nnz_L() const
+    {
+        return lp_[n_];
+    }
+
+private:
+    bool factorize(const CSRMatrix &A, bool symmetric);
+
+    unsigned n_;
+    std::vector<unsigned> perm_, iperm_;
+    // Row pattern of L in CSR (lp_, lj_) and row pattern of the strictly upper
+    // part of U in CSR (up_, uj_). Both are structurally the transpose of each
+    // other; tpos_ maps an entry of L to the transposed entry of U.
+    std::vector<unsigned> lp_, lj_, up_, uj_, tpos_;
+    vec_basic lx_, ux_, d_;
+};
+
+// C = A * B for a sparse A and a dense B, a matrix-vector product when B has
+// a single column
+void csr_mul_dense(const CSRMatrix &A, const DenseMatrix &B, DenseMatrix &C);
+
 // Return the Jacobian of the matrix
 void jacobian(const DenseMatrix &A, const DenseMatrix &x, DenseMatrix &result);
 // Return the Jacobian of the matrix using sdiff
 void sjacobian(const DenseMatrix &A, const DenseMatrix &x, DenseMatrix &result);
+// Return the Jacobian of the matrix as a CSRMatrix. Entries are only computed
+// for the symbols of `x` that appear in the corresponding row of `A`.
+void jacobian(const DenseMatrix &A, const DenseMatrix &x, CSRMatrix &result);
+// Return the Hessian of `f` with respect to the symbols in `x`
+void hessian(const RCP<const Basic> &f, const DenseMatrix &x,
+             DenseMatrix &result);
 
 // Differentiate all the elements
 void diff(const DenseMatrix &A, const RCP<const Symbol> &x,
@@ -408,6 +533,21 @@ void row_add_row_dense(DenseMatrix &A, unsigned i, unsigned j,
 // Column operations
 void column_exchange_dense(DenseMatrix &A, unsigned i, unsigned j);
 
+// Gaussian elimination
+void pivoted_fraction_free_gaussian_elimination(
+    const DenseMatrix &A, DenseMatrix &B, permutelist &pivotlist,
+    PivotStrategy strategy = PivotStrategy::FirstNonzero,
+    ZeroTest zero_test = ZeroTest::Structural);
+void pivoted_fraction_free_gauss_jordan_elimination(
+    const DenseMatrix &A, DenseMatrix &B, permutelist &pivotlist,
+    PivotStrategy strategy = PivotStrategy::FirstNonzero,
+    ZeroTest zero_test = ZeroTest::Structural);
+//! Index of the pivot for column `c` among rows `r` and below, or the number
+//! of rows if all of them are zero
+unsigned pivot(DenseMatrix &B, unsigned r, unsigned c,
+               PivotStrategy strategy = PivotStrategy::FirstNonzero,
+               ZeroTest zero_test = ZeroTest::Structural);
+
 // Vector-specific methods
 void dot(const DenseMatrix &A, const DenseMatrix &B, DenseMatrix &C);
 void cross(const DenseMatrix &A, const DenseMatrix &B, DenseMatrix &C);
@@ -438,11 +578,36 @@ void LDL_solve(const DenseMatrix &A, const DenseMatrix &b, DenseMatrix &x);
 // Determinant
 RCP<const Basic> det_berkowitz(const DenseMatrix &A);
 
+// Multi-modular methods for matrices of Integers and Rationals. They work
+// modulo word-size primes and reconstruct the exact result by CRT and
+// rational reconstruction. The determinant is stopped by Hadamard's bound,
+// the others once the reconstruction is verified over Q.
+RCP<const Basic> det_multimodular(const DenseMatrix &A);
+unsigned rank_multimodular(const DenseMatrix &A);
+// Basis of the nullspace as the columns of `result`
+void nullspace_multimodular(const DenseMatrix &A, DenseMatrix &result);
+// Throws if `A` is singular
+void solve_multimodular(const DenseMatrix &A, const DenseMatrix &b,
+                        DenseMatrix &x);
+
 // Characteristic polynomial: Only the coefficients of monomials in decreasing
 // order of monomial powers is returned, i.e. if `B = transpose([1, -2, 3])`
 // then the corresponding polynomial is `x**2 - 2x + 3`.
 void char_poly(const DenseMatrix &A, DenseMatrix &B);
 
+// Determinant of a matrix whose entries are polynomials in `gens` with integer
+// coefficients. The matrix is evaluated at the integer points of a grid large
+// enough for the degree of the determinant, and the integer determinants are
+// interpolated.
+RCP<const MIntPoly> det_interpolation(const DenseMatrix &A,
+                                      const set_basic &gens);
+RCP<const UIntPoly> det_interpolation(const DenseMatrix &A,
+                                      const RCP<const Basic> &gen);
+// Characteristic polynomial det(x*I - A) of an Integer matrix, by
+// evaluation and interpolation
+RCP<const UIntPoly> char_poly_interpolation(const DenseMatrix &A,
+                                            const RCP<const Basic> &x);
+
 // returns a finiteset of eigenvalues of a matrix
 RCP<const Set> eigen_values(const DenseMatrix &A);
 
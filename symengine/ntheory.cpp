@@ -1,5 +1,10 @@
-#include <valarray>
+#include <bitset>
+#include <climits>
+#include <cstring>
+#include <deque>
 #include <iterator>
+#include <random>
+#include <set>
 
 #include <symengine/ntheory.h>
 #include <symengine/rational.h>
@@ -104,11 +109,187 @@ void quotient_mod_f(const Ptr<RCP<const Integer>> &q,
     *r = integer(std::move(_r));
 }
 
+namespace
+{
+// Sets a = F(n) and b = F(n - 1), with F(-1) = 1. From the pair F(k),
+// F(k - 1) two squarings give
+//   F(2k + 1) = 4 F(k)**2 - F(k - 1)**2 + 2 (-1)**k,
+//   F(2k - 1) = F(k)**2 + F(k - 1)**2
+// and F(2k) is their difference, so that each bit of n costs two
+// squarings.
+void _fibonacci2(integer_class &a, integer_class &b, unsigned long n)
+{
+    if (n == 0) {
+        a = 0;
+        b = 1;
+        return;
+    }
+    unsigned bit = 0;
+    while ((n >> bit) > 1)
+        ++bit;
+    a = 1;
+    b = 0;
+    integer_class f2, g2, odd;
+    for (unsigned long k = 1; bit-- > 0;) {
+        f2 = a * a;
+        g2 = b * b;
+        // F(2k + 1) and F(2k - 1)
+        odd = 4 * f2 - g2;
+        if (k % 2 == 0)
+            odd += 2;
+        else
+            odd -= 2;
+        b = f2 + g2;
+        if ((n >> bit) & 1) {
+            a = odd;
+            b = odd - b;
+            k = 2 * k + 1;
+        } else {
+            a = odd - b;
+            k = 2 * k;
+        }
+    }
+}
+
+// Appends p to the factors of a product, packed into words
+void push_factor(std::vector<unsigned long> &f, unsigned long p)
+{
+    if (not f.empty() and f.back() <= ULONG_MAX / p)
+        f.back() *= p;
+    else
+        f.push_back(p);
+}
+
+// The product of f[a], ..., f[b - 1] by binary splitting, so that the
+// large multiplications have balanced operands
+integer_class product(const std::vector<unsigned long> &f, size_t a,
+                      size_t b)
+{
+    if (b - a <= 8) {
+        integer_class r(1);
+        for (size_t i = a; i < b; i++)
+            r *= f[i];
+        return r;
+    }
+    const size_t m = (a + b) / 2;
+    return product(f, a, m) * product(f, m, b);
+}
+
+// (a + lo + 1) (a + lo + 2) ... (a + hi) by binary splitting
+integer_class rising(const integer_class &a, unsigned long lo,
+                     unsigned long hi)
+{
+    if (hi - lo <= 8) {
+        integer_class r(1);
+        for (unsigned long i = lo + 1; i <= hi; i++)
+            r *= a + i;
+        return r;
+    }
+    const unsigned long m = lo + (hi - lo) / 2;
+    return rising(a, lo, m) * rising(a, m, hi);
+}
+
+// The odd part of n!, which is the square of that of (n / 2)! times the
+// odd part of the swinging factorial n! / ((n / 2)!)**2. The latter is the
+// product of the odd primes p <= n, each to the power of the number of odd
+// floor(n / p**i), i > 0.
+integer_class odd_factorial(unsigned long n,
+                            const std::vector<unsigned> &primes)
+{
+    if (n < 3)
+        return integer_class(1);
+    std::vector<unsigned long> f;
+    for (size_t i = 1; i < primes.size() and primes[i] <= n; i++) {
+        for (unsigned long q = n / primes[i]; q > 0; q /= primes[i])
+            if (q % 2 == 1)
+                push_factor(f, primes[i]);
+    }
+    integer_class r = odd_factorial(n / 2, primes);
+    return r * r * product(f, 0, f.size());
+}
+
+// n! by the prime swing algorithm of Luschny, the power of two being
+// 2**(n - number of ones in the binary digits of n)
+void _factorial(integer_class &r, unsigned long n)
+{
+    std::vector<unsigned> primes;
+    Sieve::generate_primes(primes, numeric_cast<unsigned>(n));
+    r = odd_factorial(n, primes);
+    unsigned long ones = 0;
+    for (unsigned long m = n; m > 0; m >>= 1)
+        ones += m & 1;
+    r = r << (n - ones);
+}
+
+// Binomial coefficient of n and k <= n / 2 from its prime factorisation:
+// by Kummer's theorem the power of p dividing it is the number of carries
+// in the addition of k and n - k in base p
+void binomial_primes(integer_class &r, unsigned long n, unsigned long k)
+{
+    std::vector<unsigned> primes;
+    Sieve::generate_primes(primes, numeric_cast<unsigned>(n));
+    std::vector<unsigned long> f;
+    for (unsigned p : primes) {
+        for (unsigned long a = n, b = k, c = n - k; a > 0;) {
+            a /= p;
+            b /= p;
+            c /= p;
+            for (unsigned long e = a - b - c; e > 0; e--)
+                push_factor(f, p);
+        }
+    }
+    r = product(f, 0, f.size());
+}
+
+// Binomial coefficient of n and k for any integer n
+void _binomial(integer_class &r, const integer_class &n, unsigned long k)
+{
+    // binomial(n, k) = (-1)**k binomial(k - n - 1, k)
+    if (n < 0) {
+        _binomial(r, integer_class(k) - n - 1, k);
+        if (k % 2 == 1)
+            r = -r;
+        return;
+    }
+    if (n < k) {
+        r = 0;
+        return;
+    }
+    // The primes up to n are sieved only when the result is not much
+    // shorter than n bits
+    if (mp_fits_ulong_p(n) and mp_get_ui(n) <= 0xffffffffUL) {
+        const unsigned long m = mp_get_ui(n);
+        k = std::min(k, m - k);
+        if (k >= m / 16) {
+            binomial_primes(r, m, k);
+            return;
+        }
+    } else if (n - k < k) {
+        k = mp_get_ui(n - k);
+    }
+    integer_class d;
+    _factorial(d, k);
+    mp_divexact(r, rising(n - k, 0, k), d);
+}
+} // anonymous namespace
+
+// From F(k) and F(k - 1) for k = n / 2, the last step takes one product,
+// F(2k) = F(k) (F(k) + 2 F(k - 1)) or
+// F(2k + 1) = (2 F(k) + F(k - 1)) (2 F(k) - F(k - 1)) + 2 (-1)**k
 RCP<const Integer> fibonacci(unsigned long n)
 {
-    integer_class f;
-    mp_fib_ui(f, n);
-    return integer(std::move(f));
+    integer_class f, g, r;
+    _fibonacci2(f, g, n / 2);
+    if (n % 2 == 0) {
+        r = f * (f + 2 * g);
+    } else {
+        r = (2 * f + g) * (2 * f - g);
+        if (n / 2 % 2 == 0)
+            r += 2;
+        else
+            r -= 2;
+    }
+    return integer(std::move(r));
 }
 
 void fibonacci2(const Ptr<RCP<const Integer>> &g,
@@ -116,33 +297,50 @@ void fibonacci2(const Ptr<RCP<const Integer>> &g,
 {
     integer_class g_t;
     integer_class s_t;
-    mp_fib2_ui(g_t, s_t, n);
+    _fibonacci2(g_t, s_t, n);
     *g = integer(std::move(g_t));
     *s = integer(std::move(s_t));
 }
 
+// From L(k) = F(k) + 2 F(k - 1) and L(k + 1) = 3 F(k) + F(k - 1) for
+// k = m / 2, L(m) takes one product more, L(2k) = L(k)**2 - 2 (-1)**k or
+// L(2k + 1) = L(k) L(k + 1) - (-1)**k. The first of these then gives L(n)
+// for n = m 2**t with one squaring for each trailing zero of n.
 RCP<const Integer> lucas(unsigned long n)
 {
-    integer_class f;
-    mp_lucnum_ui(f, n);
-    return integer(std::move(f));
+    unsigned long m = n;
+    unsigned t = 0;
+    for (; m > 0 and m % 2 == 0; m /= 2)
+        ++t;
+    integer_class f, g, r;
+    _fibonacci2(f, g, m / 2);
+    const integer_class l = f + 2 * g;
+    const int sign = m / 2 % 2 == 0 ? 1 : -1;
+    if (m % 2 == 0)
+        r = l * l - 2 * sign;
+    else
+        r = l * (3 * f + g) - sign;
+    for (; t > 0; t--, m *= 2)
+        r = r * r - (m % 2 == 0 ? 2 : -2);
+    return integer(std::move(r));
 }
 
+// L(n - 1) = 2 F(n) - F(n - 1), which is -1 for n = 0
 void lucas2(const Ptr<RCP<const Integer>> &g, const Ptr<RCP<const Integer>> &s,
             unsigned long n)
 {
+    integer_class f_t;
     integer_class g_t;
-    integer_class s_t;
-    mp_lucnum2_ui(g_t, s_t, n);
-    *g = integer(std::move(g_t));
-    *s = integer(std::move(s_t));
+    _fibonacci2(f_t, g_t, n);
+    *g = integer(f_t + 2 * g_t);
+    *s = integer(2 * f_t - g_t);
 }
 
 // Binomial Coefficient
 RCP<const Integer> binomial(const Integer &n, unsigned long k)
 {
     integer_class f;
-    mp_bin_ui(f, n.as_integer_class(), k);
+    _binomial(f, n.as_integer_class(), k);
     return integer(std::move(f));
 }
 
@@ -150,7 +348,7 @@ RCP<const Integer> binomial(const Integer &n, unsigned long k)
 RCP<const Integer> factorial(unsigned long n)
 {
     integer_class f;
-    mp_fac_ui(f, n);
+    _factorial(f, n);
     return integer(std::move(f));
 }
 
@@ -160,6 +358,189 @@ bool divides(const Integer &a, const Integer &b)
     return mp_divisible_p(a.as_integer_class(), b.as_integer_class()) != 0;
 }
 
+namespace
+{
+// Largest r with r * r <= n
+uint64_t isqrt(uint64_t n)
+{
+    uint64_t r = static_cast<uint64_t>(std::sqrt(static_cast<double>(n)));
+    while (r > 0 and (r > 0xffffffffu or r * r > n))
+        --r;
+    while (r < 0xffffffffu and (r + 1) * (r + 1) <= n)
+        ++r;
+    return r;
+}
+
+// High word of the product a * b
+inline uint64_t mulhi_word(uint64_t a, uint64_t b)
+{
+#ifdef __SIZEOF_INT128__
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b)
+                                 >> 64);
+#else
+    uint64_t a0 = a & 0xffffffffu, a1 = a >> 32;
+    uint64_t b0 = b & 0xffffffffu, b1 = b >> 32;
+    uint64_t m = a1 * b0 + (a0 * b0 >> 32);
+    uint64_t c = a0 * b1 + (m & 0xffffffffu);
+    return a1 * b1 + (m >> 32) + (c >> 32);
+#endif
+}
+
+// Arithmetic modulo an odd n on residues in Montgomery form, x * 2**64 mod n
+class MontgomeryWord
+{
+private:
+    uint64_t n_, ninv_, one_, r2_;
+
+public:
+    MontgomeryWord(uint64_t n) : n_{n}, ninv_{n}
+    {
+        // Newton's iteration, each step doubling the correct low bits
+        for (unsigned i = 0; i < 5; ++i)
+            ninv_ *= 2 - n * ninv_;
+        one_ = (0 - n) % n;
+        r2_ = one_;
+        for (unsigned i = 0; i < 64; ++i)
+            r2_ = add(r2_, r2_);
+    }
+    uint64_t one() const
+    {
+        return one_;
+    }
+    uint64_t to(uint64_t a) const
+    {
+        return mul(a % n_, r2_);
+    }
+    // a * b / 2**64 mod n, where a * b < n * 2**64
+    uint64_t mul(uint64_t a, uint64_t b) const
+    {
+        uint64_t hi = mulhi_word(a, b), m = a * b * ninv_;
+        uint64_t mn = mulhi_word(m, n_);
+        return hi >= mn ? hi - mn : hi - mn + n_;
+    }
+    uint64_t add(uint64_t a, uint64_t b) const
+    {
+        return a >= n_ - b ? a - (n_ - b) : a + b;
+    }
+    uint64_t sub(uint64_t a, uint64_t b) const
+    {
+        return a >= b ? a - b : a - b + n_;
+    }
+    uint64_t half(uint64_t a) const
+    {
+        return (a & 1) ? (a >> 1) + (n_ >> 1) + 1 : a >> 1;
+    }
+};
+
+int jacobi_word(int64_t a, uint64_t n)
+{
+    uint64_t b = a >= 0 ? static_cast<uint64_t>(a) % n
+                        : n - static_cast<uint64_t>(-a) % n;
+    int s = 1;
+    while (b != 0) {
+        while ((b & 1) == 0) {
+            b >>= 1;
+            if ((n & 7) == 3 or (n & 7) == 5)
+                s = -s;
+        }
+        std::swap(b, n);
+        if ((b & 3) == 3 and (n & 3) == 3)
+            s = -s;
+        b %= n;
+    }
+    return n == 1 ? s : 0;
+}
+
+// Baillie-PSW test: a strong probable prime test to base 2 followed by a
+// strong Lucas test with Selfridge's parameters. It has no pseudoprimes
+// below 2**64, so the result is exact.
+bool is_prime_word(uint64_t n)
+{
+    static const unsigned small[] = {2,  3,  5,  7,  11, 13, 17, 19,
+                                     23, 29, 31, 37, 41, 43, 47};
+    for (unsigned p : small) {
+        if (n % p == 0)
+            return n == p;
+    }
+    if (n < 53 * 53)
+        return n > 1;
+
+    MontgomeryWord m(n);
+    uint64_t d = n - 1;
+    unsigned s = 0;
+    for (; (d & 1) == 0; d >>= 1)
+        ++s;
+    uint64_t one = m.one(), minus_one = n - one, x = one, b = m.add(one, one);
+    for (uint64_t e = d; e > 0; e >>= 1) {
+        if (e & 1)
+            x = m.mul(x, b);
+        b = m.mul(b, b);
+    }
+    if (x != one and x != minus_one) {
+        unsigned i = 1;
+        for (; i < s and x != minus_one; ++i)
+            x = m.mul(x, x);
+        if (x != minus_one)
+            return false;
+    }
+
+    // D is the first of 5, -7, 9, -11, ... with (D/n) = -1, which does not
+    // exist when n is a square
+    int64_t D = 5;
+    for (int j; (j = jacobi_word(D, n)) != -1; D = D > 0 ? -D - 2 : -D + 2) {
+        if (j == 0)
+            return false;
+        if (D == 17) {
+            uint64_t r = isqrt(n);
+            if (r * r == n)
+                return false;
+        }
+    }
+    auto residue = [&](int64_t a) {
+        return a >= 0 ? m.to(static_cast<uint64_t>(a))
+                      : m.sub(0, m.to(static_cast<uint64_t>(-a)));
+    };
+    // P = 1 and Q = (1 - D) / 4. The Lucas sequences U, V and Q**k are
+    // computed for k running over the leading bits of d = (n + 1) / 2**s.
+    uint64_t md = residue(D), q = residue((1 - D) / 4);
+    d = n / 2 + 1;
+    for (s = 1; (d & 1) == 0; d >>= 1)
+        ++s;
+    uint64_t u = one, v = one, qk = q;
+    unsigned bits = 64;
+    while ((d >> (bits - 1)) == 0)
+        --bits;
+    for (unsigned i = bits - 1; i-- > 0;) {
+        u = m.mul(u, v);
+        v = m.sub(m.mul(v, v), m.add(qk, qk));
+        qk = m.mul(qk, qk);
+        if ((d >> i) & 1) {
+            uint64_t t = m.half(m.add(u, v));
+            v = m.half(m.add(m.mul(md, u), v));
+            u = t;
+            qk = m.mul(qk, q);
+        }
+    }
+    if (u == 0 or v == 0)
+        return true;
+    for (unsigned i = 1; i < s; ++i) {
+        v = m.sub(m.mul(v, v), m.add(qk, qk));
+        if (v == 0)
+            return true;
+        qk = m.mul(qk, qk);
+    }
+    return false;
+}
+
+// probab_prime_p for n >= 0, which is exact below 2**64
+int _probab_prime_p(const integer_class &n, unsigned reps)
+{
+    if (mp_fits_ulong_p(n))
+        return is_prime_word(mp_get_ui(n)) ? 2 : 0;
+    return mp_probab_prime_p(n, reps);
+}
+} // anonymous namespace
+
 // Prime functions
 int probab_prime_p(const Integer &a, unsigned reps)
 {
@@ -363,6 +744,995 @@ int factor_pollard_rho_method(const Ptr<RCP<const Integer>> &f,
     return ret_val;
 }
 
+namespace
+{
+// Number of bits of n >= 0. The shift lo with n >> lo below 2**32 is
+// found by doubling and bisection, so that huge n take few shifts.
+unsigned bit_length(const integer_class &n)
+{
+    unsigned lo = 0, hi = 32;
+    while ((n >> hi) != 0) {
+        lo = hi;
+        hi *= 2;
+    }
+    while (hi - lo > 32) {
+        const unsigned mid = lo + (hi - lo) / 2;
+        if ((n >> mid) != 0)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    unsigned bits = lo;
+    for (unsigned long m = mp_get_ui(n >> lo); m != 0; m >>= 1)
+        ++bits;
+    return bits;
+}
+
+// Pollard's rho method with Brent's cycle detection, for the map
+// x -> x**2 + c. The differences are multiplied together and only their
+// product is checked with a gcd, once every 128 steps.
+bool _factor_brent_rho(integer_class &rop, const integer_class &n,
+                       unsigned long c, uint64_t max_steps)
+{
+    const uint64_t m = 128;
+    integer_class x, y = 2, ys, q = 1, t;
+    rop = 1;
+    for (uint64_t r = 1; rop == 1 and r <= max_steps; r *= 2) {
+        x = y;
+        for (uint64_t i = 0; i < r; i++)
+            y = (y * y + c) % n;
+        for (uint64_t k = 0; k < r and rop == 1; k += m) {
+            ys = y;
+            for (uint64_t i = 0; i < std::min(m, r - k); i++) {
+                y = (y * y + c) % n;
+                t = x - y;
+                q = (q * t) % n;
+            }
+            mp_gcd(rop, q, n);
+        }
+    }
+    if (rop == n) {
+        // Several factors were collected in one batch; redo it step by step
+        do {
+            ys = (ys * ys + c) % n;
+            t = x - ys;
+            mp_gcd(rop, t, n);
+        } while (rop == 1);
+    }
+    return rop != 1 and rop != n;
+}
+
+uint64_t gcd_word(uint64_t a, uint64_t b)
+{
+    while (b != 0) {
+        a %= b;
+        std::swap(a, b);
+    }
+    return a;
+}
+
+// _factor_brent_rho for an odd n that fits in a word, in Montgomery form.
+// Then x -> x**2 + c is in fact the map x -> x**2 + c / 2**64 modulo n,
+// which does as well.
+bool _factor_brent_rho_word(uint64_t &rop, uint64_t n, uint64_t c,
+                            uint64_t max_steps)
+{
+    const uint64_t m = 128;
+    const MontgomeryWord w(n);
+    auto f = [&](uint64_t a) { return w.add(w.mul(a, a), c); };
+    uint64_t x, y = 2, ys = 2, q = w.one();
+    rop = 1;
+    for (uint64_t r = 1; rop == 1 and r <= max_steps; r *= 2) {
+        x = y;
+        for (uint64_t i = 0; i < r; i++)
+            y = f(y);
+        for (uint64_t k = 0; k < r and rop == 1; k += m) {
+            ys = y;
+            for (uint64_t i = 0; i < std::min(m, r - k); i++) {
+                y = f(y);
+                q = w.mul(q, x > y ? x - y : y - x);
+            }
+            rop = gcd_word(q, n);
+        }
+    }
+    if (rop == n) {
+        do {
+            ys = f(ys);
+            rop = gcd_word(x > ys ? x - ys : ys - x, n);
+        } while (rop == 1);
+    }
+    return rop != 1 and rop != n;
+}
+
+// x-only arithmetic on the Montgomery curve B y**2 = x**3 + A x**2 + x
+// modulo n, with points (X : Z) in projective coordinates. Only the
+// differential addition is available, so sums need the difference of the
+// summands.
+class MontgomeryCurve
+{
+public:
+    struct Point {
+        integer_class x, z;
+    };
+
+private:
+    const integer_class &n_;
+    // (A + 2) / 4
+    integer_class a24_;
+    integer_class s_, d_, t_, u_;
+
+    void reduce(integer_class &a) const
+    {
+        mp_fdiv_r(a, a, n_);
+    }
+
+public:
+    MontgomeryCurve(const integer_class &n, const integer_class &a24)
+        : n_(n), a24_(a24)
+    {
+    }
+
+    // r = 2 p
+    void dbl(Point &r, const Point &p)
+    {
+        s_ = p.x + p.z;
+        s_ *= s_;
+        reduce(s_);
+        d_ = p.x - p.z;
+        d_ *= d_;
+        reduce(d_);
+        t_ = s_ - d_;
+        r.x = s_ * d_;
+        reduce(r.x);
+        u_ = a24_ * t_ + d_;
+        reduce(u_);
+        r.z = t_ * u_;
+        reduce(r.z);
+    }
+
+    // r = p + q, where `diff` = p - q must not alias r
+    void add(Point &r, const Point &p, const Point &q, const Point &diff)
+    {
+        s_ = (p.x - p.z) * (q.x + q.z);
+        d_ = (p.x + p.z) * (q.x - q.z);
+        t_ = s_ + d_;
+        reduce(t_);
+        u_ = s_ - d_;
+        reduce(u_);
+        r.x = t_ * t_;
+        reduce(r.x);
+        r.x *= diff.z;
+        reduce(r.x);
+        r.z = u_ * u_;
+        reduce(r.z);
+        r.z *= diff.x;
+        reduce(r.z);
+    }
+
+    // r = k p for k > 0, by the Montgomery ladder
+    void mul(Point &r, const Point &p, uint64_t k)
+    {
+        Point r0 = p, r1;
+        dbl(r1, p);
+        int i = 63;
+        while (not(k >> i & 1))
+            --i;
+        // r1 - r0 = p throughout
+        for (--i; i >= 0; --i) {
+            if (k >> i & 1) {
+                add(r0, r1, r0, p);
+                dbl(r1, r1);
+            } else {
+                add(r1, r1, r0, p);
+                dbl(r0, r0);
+            }
+        }
+        r = std::move(r0);
+    }
+};
+
+// One curve of Lenstra's elliptic curve method, on the curve given by
+// Suyama's parametrisation for `sigma`. Stage 1 multiplies the starting point
+// by every prime power up to B1. Stage 2 looks for a single prime q in
+// (B1, B2] by writing q = m D +- j: the baby steps j P and the giant steps
+// m D P are compared projectively, so that each q costs three products.
+// `primes` holds the primes up to B2.
+bool _factor_ecm_curve(integer_class &rop, const integer_class &n,
+                       unsigned long sigma, unsigned B1, unsigned B2,
+                       const std::vector<unsigned> &primes)
+{
+    typedef MontgomeryCurve::Point Point;
+    integer_class u, v, t, a24;
+    u = integer_class(sigma) * sigma - 5;
+    v = integer_class(sigma) * 4;
+    Point p;
+    p.x = u * u * u;
+    mp_fdiv_r(p.x, p.x, n);
+    p.z = v * v * v;
+    mp_fdiv_r(p.z, p.z, n);
+    // A + 2 = (v - u)**3 (3 u + v) / (4 u**3 v)
+    t = 16 * p.x * v;
+    mp_fdiv_r(t, t, n);
+    if (not mp_invert(a24, t, n)) {
+        mp_gcd(rop, t, n);
+        return rop != n;
+    }
+    t = v - u;
+    a24 = a24 * t * t * t * (3 * u + v);
+    mp_fdiv_r(a24, a24, n);
+    MontgomeryCurve curve(n, a24);
+
+    auto it = primes.begin();
+    for (; it != primes.end() and *it <= B1; ++it) {
+        uint64_t q = *it;
+        while (q <= B1 / *it)
+            q *= *it;
+        curve.mul(p, p, q);
+    }
+    mp_gcd(rop, p.z, n);
+    if (rop != 1)
+        return rop != n;
+
+    const unsigned D = B1 < 5000 ? 210 : 2310;
+    // baby[j] = j P for odd j <= D / 2
+    std::vector<Point> baby(D / 2 + 1);
+    Point p2;
+    curve.dbl(p2, p);
+    baby[1] = p;
+    curve.add(baby[3], p2, p, p);
+    for (unsigned j = 5; j <= D / 2; j += 2)
+        curve.add(baby[j], baby[j - 2], p2, baby[j - 4]);
+
+    Point giant, cur, next;
+    curve.mul(giant, p, D);
+    uint64_t m = std::max<uint64_t>(1, (B1 + D / 2) / D);
+    curve.mul(cur, giant, m);
+    curve.mul(next, giant, m + 1);
+    // q = m D - j and q = m D + j share their comparison
+    std::vector<char> done(D / 2 + 1, 0);
+    integer_class g = 1;
+    for (; it != primes.end() and *it <= B2; ++it) {
+        const uint64_t q = *it, mq = (q + D / 2) / D;
+        if (mq < m)
+            continue;
+        while (m < mq) {
+            curve.add(p2, next, giant, cur);
+            std::swap(cur, next);
+            std::swap(next, p2);
+            ++m;
+            std::fill(done.begin(), done.end(), 0);
+        }
+        const uint64_t j = q > m * D ? q - m * D : m * D - q;
+        if (done[j])
+            continue;
+        done[j] = 1;
+        t = cur.x * baby[j].z - baby[j].x * cur.z;
+        g *= t;
+        mp_fdiv_r(g, g, n);
+    }
+    mp_gcd(rop, g, n);
+    return rop != 1 and rop != n;
+}
+
+// Runs up to `curves` curves with stage 1 bound B1 and stage 2 bound 100 B1
+// (at most 1e9), starting from Suyama parameter `sigma`. The curves are
+// independent and run in parallel; the first factor found stops the others.
+bool _factor_ecm_method(integer_class &rop, const integer_class &n,
+                        unsigned B1, unsigned curves, unsigned long sigma)
+{
+    const unsigned B2 = B1 < 10000000 ? 100 * B1 : 1000000000;
+    std::vector<unsigned> primes;
+    Sieve::generate_primes(primes, B2);
+    bool found = false;
+#pragma omp parallel for schedule(dynamic)
+    for (unsigned c = 0; c < curves; c++) {
+        bool stop;
+#pragma omp atomic read
+        stop = found;
+        if (stop)
+            continue;
+        integer_class f;
+        if (_factor_ecm_curve(f, n, sigma + c, B1, B2, primes)) {
+#pragma omp critical
+            {
+                if (not found)
+                    rop = f;
+#pragma omp atomic write
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+// Modular arithmetic on words for the primes of the factor base, which are
+// below 2**32
+uint64_t powmod_word(uint64_t b, uint64_t e, uint64_t p)
+{
+    uint64_t r = 1;
+    for (b %= p; e > 0; e >>= 1) {
+        if (e & 1)
+            r = r * b % p;
+        b = b * b % p;
+    }
+    return r;
+}
+
+uint64_t invert_word(uint64_t a, uint64_t p)
+{
+    return powmod_word(a, p - 2, p);
+}
+
+// Square root of the quadratic residue a modulo the odd prime p, by
+// Tonelli-Shanks
+uint64_t sqrt_mod_word(uint64_t a, uint64_t p)
+{
+    a %= p;
+    if (a == 0)
+        return 0;
+    if (p % 4 == 3)
+        return powmod_word(a, (p + 1) / 4, p);
+    uint64_t q = p - 1, e = 0, z = 2;
+    while (q % 2 == 0) {
+        q /= 2;
+        ++e;
+    }
+    while (powmod_word(z, (p - 1) / 2, p) != p - 1)
+        ++z;
+    uint64_t c = powmod_word(z, q, p), r = powmod_word(a, (q + 1) / 2, p),
+             t = powmod_word(a, q, p);
+    while (t != 1) {
+        uint64_t i = 0, t2 = t;
+        while (t2 != 1) {
+            t2 = t2 * t2 % p;
+            ++i;
+        }
+        uint64_t b = c;
+        for (uint64_t k = 0; k + i + 1 < e; k++)
+            b = b * b % p;
+        r = r * b % p;
+        c = b * b % p;
+        t = t * c % p;
+        e = i;
+    }
+    return r;
+}
+
+// Self-initialising quadratic sieve. The polynomials are
+// g(x) = ((A x + B)**2 - k n) / A, where A is a product of s primes q_j of
+// the factor base and B = B_0 +- ... +- B_{s-1} with B_j**2 = k n mod q_j
+// and B_j = 0 mod A / q_j, which gives 2**(s - 1) polynomials for each A
+// whose roots modulo the factor base primes follow from each other by one
+// addition. Each (A x + B)**2 = A g(x) mod n with g(x) smooth over the
+// factor base gives a relation; values with one prime above the factor
+// base are kept until a second one shares that prime. A dependency among
+// the relations modulo 2 then gives x**2 = y**2 mod n.
+class QuadraticSieve
+{
+private:
+    // (A x + B)**2 = (-1)**e_0 prod(fb_[i]**e_i) large**2 mod n, where
+    // `factors` lists each index i e_i times and index 0 stands for -1
+    struct Relation {
+        integer_class y;
+        std::vector<unsigned> factors;
+        integer_class large;
+    };
+
+    const integer_class &n_;
+    integer_class kn_;
+    unsigned k_;
+    // fb_[0] = 1 stands for -1 and fb_[1] = 2
+    std::vector<unsigned> fb_;
+    // Square root of k n modulo fb_[i]
+    std::vector<unsigned> sqrt_;
+    std::vector<unsigned char> logp_;
+    // The sieve covers x in [-m_, m_)
+    unsigned m_;
+    uint64_t large_bound_;
+    unsigned char threshold_;
+    // First factor base index that is sieved; the smaller primes are left
+    // to the threshold
+    unsigned sieve_start_;
+    // Number of primes in A and the range of factor base indices they are
+    // drawn from
+    unsigned s_, qlo_, qhi_;
+    double log2a_;
+
+    std::vector<Relation> full_;
+    std::map<uint64_t, Relation> partial_;
+
+    void choose_multiplier()
+    {
+        // Odd square-free multipliers, scored by Knuth-Schroeppel
+        static const unsigned mults[]
+            = {1,  3,  5,  7,  11, 13, 15, 17, 19, 21, 23, 29, 31, 33, 35, 37,
+               39, 41, 43, 47, 51, 53, 55, 57, 59, 61, 65, 67, 69, 71, 73};
+        std::vector<unsigned> primes;
+        Sieve::generate_primes(primes, 2000);
+        double best = -1e9;
+        k_ = 1;
+        const unsigned n8 = static_cast<unsigned>(mp_get_ui(n_ % 8));
+        for (unsigned k : mults) {
+            double score = -0.5 * std::log(double(k));
+            const unsigned r = (k * n8) % 8;
+            score += (r == 1 ? 2.0 : r == 5 ? 1.0 : 0.5) * std::log(2.0);
+            for (unsigned i = 1; i < primes.size(); i++) {
+                const unsigned p = primes[i];
+                const uint64_t r = mp_get_ui(n_ % p) * k % p;
+                if (k % p == 0)
+                    score += std::log(double(p)) / p;
+                else if (powmod_word(r, (p - 1) / 2, p) == 1)
+                    score += 2 * std::log(double(p)) / (p - 1);
+            }
+            if (score > best) {
+                best = score;
+                k_ = k;
+            }
+        }
+        kn_ = n_ * k_;
+    }
+
+    // Builds the factor base of `size` primes; returns false with a factor
+    // of n in `rop` when one of them divides n
+    bool factor_base(integer_class &rop, unsigned size)
+    {
+        fb_ = {1, 2};
+        sqrt_ = {0, 1};
+        for (unsigned limit = 32 * size; fb_.size() < size; limit *= 2) {
+            std::vector<unsigned> primes;
+            Sieve::generate_primes(primes, limit);
+            for (unsigned p : primes) {
+                if (p <= fb_.back())
+                    continue;
+                if (fb_.size() == size)
+                    break;
+                const uint64_t r = mp_get_ui(kn_ % p);
+                if (r == 0 and (k_ % p != 0 or n_ % p == 0)) {
+                    rop = p;
+                    return false;
+                }
+                if (r == 0 or powmod_word(r, (p - 1) / 2, p) == 1) {
+                    fb_.push_back(p);
+                    sqrt_.push_back(
+                        static_cast<unsigned>(sqrt_mod_word(r, p)));
+                }
+            }
+        }
+        logp_.resize(fb_.size());
+        for (unsigned i = 0; i < fb_.size(); i++)
+            logp_[i] = static_cast<unsigned char>(
+                std::lround(std::log2(double(fb_[i]))));
+        return true;
+    }
+
+    // Picks the factor base indices of the primes of a new A, close to the
+    // target size
+    bool choose_a(std::vector<unsigned> &q, std::mt19937 &rng) const
+    {
+        q.clear();
+        double bits = 0;
+        std::uniform_int_distribution<unsigned> pick(qlo_, qhi_ - 1);
+        for (unsigned tries = 0; q.size() + 1 < s_; tries++) {
+            if (tries > 1000)
+                return false;
+            const unsigned i = pick(rng);
+            if (sqrt_[i] == 0 or std::find(q.begin(), q.end(), i) != q.end())
+                continue;
+            q.push_back(i);
+            bits += std::log2(double(fb_[i]));
+        }
+        // The last prime brings A closest to its target
+        const double last = std::exp2(log2a_ - bits);
+        auto it = std::lower_bound(fb_.begin() + 2, fb_.end(),
+                                   static_cast<unsigned>(std::min(
+                                       last, double(fb_.back()))));
+        const unsigned nfb = static_cast<unsigned>(fb_.size());
+        const unsigned i = std::min(
+            static_cast<unsigned>(it - fb_.begin()), nfb - 1);
+        auto usable = [&](unsigned j) {
+            return sqrt_[j] != 0
+                   and std::find(q.begin(), q.end(), j) == q.end();
+        };
+        unsigned d = 0;
+        while ((i < d + 2 or not usable(i - d))
+               and (i + d >= nfb or not usable(i + d)))
+            if (++d >= nfb)
+                return false;
+        q.push_back(i >= d + 2 and usable(i - d) ? i - d : i + d);
+        std::sort(q.begin(), q.end());
+        return true;
+    }
+
+    // Sieves all the polynomials of the A with factors fb_[q_j]
+    void sieve_a(const std::vector<unsigned> &q, std::vector<Relation> &full,
+                 std::vector<std::pair<uint64_t, Relation>> &partial) const
+    {
+        const unsigned s = static_cast<unsigned>(q.size());
+        const unsigned nfb = static_cast<unsigned>(fb_.size());
+        integer_class A = 1, B = 0, t;
+        for (unsigned j : q)
+            A *= fb_[j];
+        std::vector<integer_class> Bj(s);
+        for (unsigned j = 0; j < s; j++) {
+            const uint64_t p = fb_[q[j]];
+            integer_class Aq = A / p;
+            uint64_t g = sqrt_[q[j]] * invert_word(mp_get_ui(Aq % p), p) % p;
+            if (g > p / 2)
+                g = p - g;
+            Bj[j] = Aq * g;
+            B += Bj[j];
+        }
+        // Roots of g modulo the factor base primes, as sieve positions,
+        // and their steps 2 B_j / A when B_j changes sign
+        std::vector<unsigned> soln1(nfb), soln2(nfb);
+        std::vector<std::vector<unsigned>> step(s, std::vector<unsigned>(nfb));
+        std::vector<char> in_a(nfb, 0);
+        for (unsigned j : q)
+            in_a[j] = 1;
+        for (unsigned i = 2; i < nfb; i++) {
+            if (in_a[i])
+                continue;
+            const uint64_t p = fb_[i];
+            const uint64_t ainv = invert_word(mp_get_ui(A % p), p);
+            const uint64_t b = mp_get_ui(B % p), m = m_ % p;
+            soln1[i] = static_cast<unsigned>(
+                (ainv * ((sqrt_[i] + p - b) % p) + m) % p);
+            soln2[i] = static_cast<unsigned>(
+                (ainv * ((2 * p - sqrt_[i] - b) % p) + m) % p);
+            for (unsigned j = 0; j < s; j++)
+                step[j][i] = static_cast<unsigned>(
+                    2 * (mp_get_ui(Bj[j] % p) * ainv % p) % p);
+        }
+
+        std::vector<unsigned char> sieve(2 * m_);
+        const unsigned char init
+            = static_cast<unsigned char>(128 - threshold_);
+        for (unsigned poly = 0; poly < 1u << (s - 1); poly++) {
+            if (poly > 0) {
+                // Gray code: B_v changes sign
+                unsigned v = 0;
+                while (not(poly >> v & 1))
+                    ++v;
+                const bool negate = ((poly ^ (poly >> 1)) >> v) & 1;
+                if (negate)
+                    B -= 2 * Bj[v];
+                else
+                    B += 2 * Bj[v];
+                for (unsigned i = 2; i < nfb; i++) {
+                    const unsigned p = fb_[i];
+                    const unsigned d = negate ? step[v][i] : p - step[v][i];
+                    soln1[i] += d;
+                    if (soln1[i] >= p)
+                        soln1[i] -= p;
+                    soln2[i] += d;
+                    if (soln2[i] >= p)
+                        soln2[i] -= p;
+                }
+            }
+
+            std::fill(sieve.begin(), sieve.end(), init);
+            unsigned char *S = sieve.data();
+            const unsigned len = 2 * m_;
+            for (unsigned i = sieve_start_; i < nfb; i++) {
+                if (in_a[i])
+                    continue;
+                const unsigned p = fb_[i];
+                const unsigned char lp = logp_[i];
+                for (unsigned x = soln1[i]; x < len; x += p)
+                    S[x] = static_cast<unsigned char>(S[x] + lp);
+                if (soln2[i] != soln1[i])
+                    for (unsigned x = soln2[i]; x < len; x += p)
+                        S[x] = static_cast<unsigned char>(S[x] + lp);
+            }
+
+            for (unsigned w = 0; w < len; w += 8) {
+                uint64_t word;
+                std::memcpy(&word, S + w, 8);
+                if (not(word & 0x8080808080808080ULL))
+                    continue;
+                for (unsigned x = w; x < w + 8; x++)
+                    if (S[x] & 0x80)
+                        check(x, A, B, q, in_a, soln1, soln2, full, partial);
+            }
+        }
+    }
+
+    // Trial divides g at sieve position x and records the relation
+    void check(unsigned x, const integer_class &A, const integer_class &B,
+               const std::vector<unsigned> &q, const std::vector<char> &in_a,
+               const std::vector<unsigned> &soln1,
+               const std::vector<unsigned> &soln2,
+               std::vector<Relation> &full,
+               std::vector<std::pair<uint64_t, Relation>> &partial) const
+    {
+        Relation rel;
+        integer_class y = A * (long(x) - long(m_)) + B, g;
+        g = y * y - kn_;
+        mp_divexact(g, g, A);
+        if (g < 0) {
+            rel.factors.push_back(0);
+            g = -g;
+        }
+        if (g == 0)
+            return;
+        rel.factors.insert(rel.factors.end(), q.begin(), q.end());
+        for (unsigned i = 1; i < fb_.size(); i++) {
+            const unsigned p = fb_[i];
+            if (i == 1 or in_a[i] or sqrt_[i] == 0) {
+                if (not mp_divisible_p(g, integer_class(p)))
+                    continue;
+            } else {
+                const unsigned r = x % p;
+                if (r != soln1[i] and r != soln2[i])
+                    continue;
+            }
+            do {
+                g /= p;
+                rel.factors.push_back(i);
+            } while (mp_divisible_p(g, integer_class(p)));
+        }
+        // y and n - y give the same relation
+        mp_fdiv_r(rel.y, y, n_);
+        if (2 * rel.y > n_)
+            rel.y = n_ - rel.y;
+        if (g == 1) {
+            rel.large = 1;
+            full.push_back(std::move(rel));
+        } else if (g < large_bound_) {
+            rel.large = g;
+            partial.push_back(std::make_pair(mp_get_ui(g), std::move(rel)));
+        }
+    }
+
+    // Adds a relation with one large prime, combining it with an earlier one
+    // with the same prime into a full relation
+    void add_partial(uint64_t l, Relation &rel)
+    {
+        auto it = partial_.find(l);
+        if (it == partial_.end()) {
+            partial_.insert(std::make_pair(l, std::move(rel)));
+            return;
+        }
+        Relation r;
+        r.y = it->second.y * rel.y;
+        mp_fdiv_r(r.y, r.y, n_);
+        r.factors = it->second.factors;
+        r.factors.insert(r.factors.end(), rel.factors.begin(),
+                         rel.factors.end());
+        r.large = l;
+        full_.push_back(std::move(r));
+    }
+
+    // Finds the dependencies among the relations modulo 2 by Gaussian
+    // elimination, and tries each of them for a factor
+    bool combine(integer_class &rop) const
+    {
+        const size_t R = full_.size(), C = fb_.size();
+        const size_t cw = (C + 63) / 64, w = cw + (R + 63) / 64;
+        std::vector<uint64_t> mat(R * w, 0);
+        for (size_t r = 0; r < R; r++) {
+            uint64_t *row = &mat[r * w];
+            for (unsigned i : full_[r].factors)
+                row[i / 64] ^= uint64_t(1) << (i % 64);
+            row[cw + r / 64] |= uint64_t(1) << (r % 64);
+        }
+        std::vector<char> used(R, 0);
+        for (size_t c = 0; c < C; c++) {
+            const uint64_t bit = uint64_t(1) << (c % 64);
+            size_t pivot = R;
+            for (size_t r = 0; r < R; r++) {
+                if (not used[r] and (mat[r * w + c / 64] & bit)) {
+                    pivot = r;
+                    break;
+                }
+            }
+            if (pivot == R)
+                continue;
+            used[pivot] = 1;
+            const uint64_t *prow = &mat[pivot * w];
+            for (size_t r = pivot + 1; r < R; r++) {
+                uint64_t *row = &mat[r * w];
+                if (not used[r] and (row[c / 64] & bit))
+                    for (size_t k = c / 64; k < w; k++)
+                        row[k] ^= prow[k];
+            }
+        }
+
+        integer_class x, y, t;
+        std::vector<unsigned> exps(C);
+        for (size_t r = 0; r < R; r++) {
+            if (used[r])
+                continue;
+            const uint64_t *row = &mat[r * w + cw];
+            x = 1;
+            y = 1;
+            std::fill(exps.begin(), exps.end(), 0);
+            for (size_t i = 0; i < R; i++) {
+                if (not(row[i / 64] >> (i % 64) & 1))
+                    continue;
+                x = x * full_[i].y % n_;
+                y = y * full_[i].large % n_;
+                for (unsigned j : full_[i].factors)
+                    ++exps[j];
+            }
+            for (size_t j = 1; j < C; j++) {
+                if (exps[j] == 0)
+                    continue;
+                mp_powm(t, integer_class(fb_[j]), integer_class(exps[j] / 2),
+                        n_);
+                y = y * t % n_;
+            }
+            t = x - y;
+            mp_gcd(rop, t, n_);
+            if (rop != 1 and rop != n_)
+                return true;
+        }
+        return false;
+    }
+
+public:
+    QuadraticSieve(const integer_class &n) : n_(n)
+    {
+    }
+
+    // Returns true and a non-trivial factor of n, which must be odd,
+    // composite and not a perfect power
+    bool run(integer_class &rop)
+    {
+        choose_multiplier();
+        const unsigned bits = bit_length(kn_);
+        // Factor base size and sieve half width by the size of k n
+        static const unsigned params[][3]
+            = {{64, 100, 1 << 10},    {80, 120, 1 << 12},
+               {100, 240, 1 << 13},   {120, 400, 1 << 14},
+               {140, 600, 1 << 14},   {160, 1000, 1 << 14},
+               {180, 1600, 1 << 15},  {200, 2400, 1 << 15},
+               {220, 3600, 1 << 15},  {240, 5200, 1 << 16},
+               {260, 7200, 1 << 16},  {280, 10000, 1 << 16},
+               {300, 14000, 1 << 16}, {~0u, 18000, 1 << 17}};
+        unsigned k = 0;
+        while (params[k][0] < bits)
+            ++k;
+        if (not factor_base(rop, params[k][1]))
+            return true;
+        m_ = params[k][2];
+        const double pmax = fb_.back();
+        large_bound_ = static_cast<uint64_t>(pmax) * 100;
+        sieve_start_ = 2;
+        while (sieve_start_ < fb_.size() and fb_[sieve_start_] < 30)
+            ++sieve_start_;
+        // log2 of the largest |g(x)|, about m sqrt(k n / 2), less what may
+        // be left over: a large prime and the unsieved small primes
+        const double log2g = std::log2(double(m_)) + 0.5 * bits - 0.5;
+        threshold_ = static_cast<unsigned char>(std::max(
+            1.0, std::min(127.0, log2g - std::log2(double(large_bound_))
+                                     - 8.0)));
+
+        // A ~ sqrt(2 k n) / m, from primes of about 2**11 where possible
+        log2a_ = 0.5 * bits + 0.5 - std::log2(double(m_));
+        const double qbits = std::min(11.0, std::log2(pmax) - 1);
+        s_ = std::max(2u, static_cast<unsigned>(std::lround(log2a_ / qbits)));
+        const double qtarget = std::exp2(log2a_ / s_);
+        unsigned centre = static_cast<unsigned>(
+            std::lower_bound(fb_.begin() + 2, fb_.end(),
+                             static_cast<unsigned>(qtarget))
+            - fb_.begin());
+        centre = std::min<unsigned>(centre, unsigned(fb_.size()) - 1);
+        qlo_ = std::max<unsigned>(std::max(sieve_start_, 3u),
+                                  centre > 30 ? centre - 30 : 0);
+        qhi_ = std::min<unsigned>(unsigned(fb_.size()), centre + 30);
+        if (qhi_ <= qlo_ + s_)
+            qlo_ = 2;
+
+        std::mt19937 rng(12345);
+        std::set<std::vector<unsigned>> seen;
+        std::set<integer_class> found;
+        const size_t needed = fb_.size() + 64;
+        // The batches of A values sieved in parallel start with one, as a
+        // single A may give all the relations needed for a small n
+        unsigned batch = 1, failures = 0;
+        for (; full_.size() < needed; batch = std::min(2 * batch, 8u)) {
+            std::vector<std::vector<unsigned>> as;
+            while (as.size() < batch) {
+                std::vector<unsigned> q;
+                if (not choose_a(q, rng) or not seen.insert(q).second) {
+                    if (++failures > 10000)
+                        return false;
+                    continue;
+                }
+                as.push_back(std::move(q));
+            }
+            std::vector<std::vector<Relation>> full(batch);
+            std::vector<std::vector<std::pair<uint64_t, Relation>>> partial(
+                batch);
+#pragma omp parallel for schedule(dynamic)
+            for (unsigned b = 0; b < batch; b++)
+                sieve_a(as[b], full[b], partial[b]);
+            // Different polynomials may find the same y when n is small
+            for (unsigned b = 0; b < batch; b++) {
+                for (auto &rel : full[b])
+                    if (found.insert(rel.y).second)
+                        full_.push_back(std::move(rel));
+                for (auto &rel : partial[b])
+                    if (found.insert(rel.second.y).second)
+                        add_partial(rel.first, rel.second);
+            }
+        }
+        full_.resize(needed);
+        return combine(rop);
+    }
+};
+
+// Returns r with r**e = n for the largest such e > 1, or n
+integer_class _perfect_power_root(const integer_class &n)
+{
+    integer_class r;
+    for (unsigned e = bit_length(n); e > 1; --e)
+        if (mp_root(r, n, e))
+            return r;
+    return n;
+}
+
+// Splits n, which is composite and has no prime factors below 2**16, into
+// two non-trivial factors. ECM is first run on curves that find the factors
+// that are small for the size of n, then the quadratic sieve, whose running
+// time only depends on the size of n, is used up to about 75 digits.
+// Larger n are left to ECM with growing bounds, and if that finds no factor
+// up to about 35 digits an exception is thrown.
+void _factor_split(integer_class &rop, const integer_class &n, unsigned B1)
+{
+    if (mp_perfect_power_p(n)) {
+        rop = _perfect_power_root(n);
+        return;
+    }
+    // Rho always splits n below 2**64, on machine words where n fits in one
+    const unsigned bits = bit_length(n);
+    if (bits <= 64) {
+        const bool word = mp_fits_ulong_p(n);
+        const uint64_t m = word ? mp_get_ui(n) : 0;
+        for (unsigned long c = 1;; c++) {
+            uint64_t f;
+            if (word and _factor_brent_rho_word(f, m, c, uint64_t(1) << 40)) {
+                rop = f;
+                return;
+            }
+            if (not word and _factor_brent_rho(rop, n, c, uint64_t(1) << 40))
+                return;
+        }
+    }
+    // Below 100 bits the quadratic sieve takes milliseconds, so rho is only
+    // left to find the smallest factors
+    if (_factor_brent_rho(rop, n, 1, bits <= 100 ? 1 << 11 : 1 << 14))
+        return;
+    // B1, number of curves and smallest size of n worth running them
+    static const unsigned levels[][3]
+        = {{2000, 25, 160}, {11000, 90, 215}, {50000, 200, 240}};
+    unsigned long sigma = 7;
+    for (auto &level : levels) {
+        if (bits < level[2])
+            break;
+        if (_factor_ecm_method(rop, n, std::max(level[0], B1), level[1],
+                               sigma))
+            return;
+        sigma += level[1];
+    }
+    if (bits <= 250) {
+        QuadraticSieve qs(n);
+        if (qs.run(rop))
+            return;
+    }
+    for (unsigned b = std::max(250000u, B1), curves = 500;;
+         b = std::min(4 * b, 10000000u)) {
+        if (_factor_ecm_method(rop, n, b, curves, sigma))
+            return;
+        if (b >= 10000000u)
+            break;
+        sigma += curves;
+    }
+    throw SymEngineException("N too large to factor");
+}
+
+// Appends the prime factors of n > 1, which has none below 2**16, to
+// `primes`
+void _factor_complete(std::vector<integer_class> &primes,
+                      const integer_class &n, unsigned B1)
+{
+    if (n < integer_class(1) << 32 or _probab_prime_p(n, 25)) {
+        primes.push_back(n);
+        return;
+    }
+    integer_class f, g;
+    _factor_split(f, n, B1);
+    mp_divexact(g, n, f);
+    _factor_complete(primes, f, B1);
+    _factor_complete(primes, g, B1);
+}
+
+// Divides the primes up to min(sqrt(n), 2**16) out of n and appends them to
+// `primes`, then factors what is left
+void _prime_factors(std::vector<integer_class> &primes, integer_class n)
+{
+    Sieve::iterator pi(1 << 16);
+    unsigned p;
+    while ((p = pi.next_prime()) <= 1 << 16) {
+        if (integer_class(p) * p > n)
+            break;
+        while (mp_divisible_p(n, integer_class(p))) {
+            primes.push_back(p);
+            n /= p;
+        }
+    }
+    if (n > 1) {
+        std::vector<integer_class> large;
+        _factor_complete(large, n, 0);
+        std::sort(large.begin(), large.end());
+        primes.insert(primes.end(), large.begin(), large.end());
+    }
+}
+
+#ifndef HAVE_SYMENGINE_ECM
+// Returns 1 and a non-trivial factor of n when it is composite, otherwise 0
+int _factor(integer_class &rop, integer_class n, unsigned B1)
+{
+    if (n < 0)
+        n = -n;
+    rop = n;
+    if (n < 4)
+        return 0;
+    Sieve::iterator pi(1 << 16);
+    unsigned p;
+    while ((p = pi.next_prime()) <= 1 << 16) {
+        if (integer_class(p) * p > n)
+            return 0;
+        if (mp_divisible_p(n, integer_class(p))) {
+            rop = p;
+            return 1;
+        }
+    }
+    if (_probab_prime_p(n, 25))
+        return 0;
+    _factor_split(rop, n, B1);
+    return 1;
+}
+#endif // !HAVE_SYMENGINE_ECM
+} // anonymous namespace
+
+int factor_ecm_method(const Ptr<RCP<const Integer>> &f, const Integer &n,
+                      unsigned B1, unsigned curves)
+{
+    if (n.as_integer_class() < 6 or B1 < 2)
+        throw SymEngineException("Require n > 5 and B1 > 1 to use ECM");
+
+    integer_class rop;
+    int ret_val = _factor_ecm_method(rop, n.as_integer_class(), B1, curves, 7);
+    if (ret_val != 0)
+        *f = integer(std::move(rop));
+    return ret_val;
+}
+
+int factor_quadratic_sieve_method(const Ptr<RCP<const Integer>> &f,
+                                  const Integer &n)
+{
+    const integer_class &_n = n.as_integer_class();
+    if (_n < 4)
+        throw SymEngineException(
+            "Require n > 3 to use the quadratic sieve method");
+
+    integer_class rop;
+    int ret_val = 1;
+    if (mp_probab_prime_p(_n, 25))
+        ret_val = 0;
+    else if (mp_divisible_p(_n, integer_class(2)))
+        rop = 2;
+    else if (mp_perfect_power_p(_n))
+        rop = _perfect_power_root(_n);
+    else
+        ret_val = QuadraticSieve(_n).run(rop);
+    if (ret_val != 0)
+        *f = integer(std::move(rop));
+    return ret_val;
+}
+
 // Factorization
 int factor(const Ptr<RCP<const Integer>> &f, const Integer &n, double B1)
 {
@@ -407,8 +1777,7 @@ int factor(const Ptr<RCP<const Integer>> &f, const Integer &n, double B1)
         }
     }
 #else
-    // B1 is discarded if gmp-ecm is not installed
-    ret_val = _factor_trial_division_sieve(_f, _n);
+    ret_val = _factor(_f, _n, static_cast<unsigned>(std::min(B1, 1e7)));
 #endif // HAVE_SYMENGINE_ECM
     *f = integer(std::move(_f));
 
@@ -428,70 +1797,428 @@ int factor_trial_division(const Ptr<RCP<const Integer>> &f, const Integer &n)
 void prime_factors(std::vector<RCP<const Integer>> &prime_list,
                    const Integer &n)
 {
-    integer_class sqrtN;
     integer_class _n = n.as_integer_class();
     if (_n == 0)
         return;
     if (_n < 0)
         _n *= -1;
 
-    sqrtN = mp_sqrt(_n);
-    auto limit = mp_get_ui(sqrtN);
-    if (not mp_fits_ulong_p(sqrtN)
-        or limit > std::numeric_limits<unsigned>::max())
-        throw SymEngineException("N too large to factor");
-    Sieve::iterator pi(numeric_cast<unsigned>(limit));
-    unsigned p;
-
-    while ((p = pi.next_prime()) <= limit) {
-        while (_n % p == 0) {
-            prime_list.push_back(integer(p));
-            _n = _n / p;
-        }
-        if (_n == 1)
-            break;
-    }
-    if (not(_n == 1))
-        prime_list.push_back(integer(std::move(_n)));
+    std::vector<integer_class> primes;
+    _prime_factors(primes, _n);
+    for (auto &p : primes)
+        prime_list.push_back(integer(std::move(p)));
 }
 
 void prime_factor_multiplicities(map_integer_uint &primes_mul, const Integer &n)
 {
-    integer_class sqrtN;
     integer_class _n = n.as_integer_class();
-    unsigned count;
     if (_n == 0)
         return;
     if (_n < 0)
         _n *= -1;
 
-    sqrtN = mp_sqrt(_n);
-    auto limit = mp_get_ui(sqrtN);
-    if (not mp_fits_ulong_p(sqrtN)
-        or limit > std::numeric_limits<unsigned>::max())
-        throw SymEngineException("N too large to factor");
-    Sieve::iterator pi(numeric_cast<unsigned>(limit));
+    std::vector<integer_class> primes;
+    _prime_factors(primes, _n);
+    // The primes come sorted, so equal ones are adjacent
+    for (size_t i = 0, j; i < primes.size(); i = j) {
+        for (j = i + 1; j < primes.size() and primes[j] == primes[i]; ++j)
+            ;
+        insert(primes_mul, integer(std::move(primes[i])),
+               static_cast<unsigned>(j - i));
+    }
+}
+
+namespace
+{
+// Builds the product tree of `leaves`: tree[0] is `leaves` and each further
+// level holds the products of adjacent pairs of nodes of the level below, a
+// last unpaired node being carried up. The last level is the root.
+void product_tree(std::vector<vec_integer_class> &tree,
+                  const vec_integer_class &leaves)
+{
+    tree.assign(1, leaves);
+    while (tree.back().size() > 1) {
+        const vec_integer_class &below = tree.back();
+        vec_integer_class level((below.size() + 1) / 2);
+#pragma omp parallel for schedule(dynamic)
+        for (size_t i = 0; i < below.size() / 2; i++)
+            level[i] = below[2 * i] * below[2 * i + 1];
+        if (below.size() % 2 == 1)
+            level.back() = below.back();
+        tree.push_back(std::move(level));
+    }
+}
+
+// Sets rem[i] = x mod tree[0][i], reducing x down the product tree, so that
+// the large divisions are done once for all the leaves
+void remainder_tree(vec_integer_class &rem, const integer_class &x,
+                    const std::vector<vec_integer_class> &tree)
+{
+    rem.assign(1, x);
+    for (size_t l = tree.size(); l-- > 0;) {
+        const vec_integer_class &level = tree[l];
+        vec_integer_class below(level.size());
+#pragma omp parallel for schedule(dynamic)
+        for (size_t i = 0; i < level.size(); i++)
+            mp_fdiv_r(below[i], rem[i / 2], level[i]);
+        rem = std::move(below);
+    }
+}
+
+// The product of the primes below 2**16. Its remainders modulo a batch of
+// integers replace the trial division of each of them.
+const integer_class &small_primes_product()
+{
+    static const integer_class product = [] {
+        std::vector<unsigned> primes;
+        Sieve::generate_primes(primes, 1 << 16);
+        vec_integer_class leaves;
+        for (unsigned p : primes)
+            leaves.push_back(integer_class(p));
+        std::vector<vec_integer_class> tree;
+        product_tree(tree, leaves);
+        return tree.back()[0];
+    }();
+    return product;
+}
+} // anonymous namespace
+
+void probab_prime_p_batch(std::vector<int> &result,
+                          const std::vector<uint64_t> &n)
+{
+    result.resize(n.size());
+#pragma omp parallel for schedule(dynamic, 256)
+    for (size_t i = 0; i < n.size(); i++)
+        result[i] = is_prime_word(n[i]) ? 2 : 0;
+}
+
+void probab_prime_p_batch(std::vector<int> &result, const vec_integer_class &n,
+                          unsigned reps)
+{
+    // mp_probab_prime_p trial divides its argument up to a bound growing
+    // with its size, which a remainder tree would only repeat
+    result.resize(n.size());
+#pragma omp parallel for schedule(dynamic, 16)
+    for (size_t i = 0; i < n.size(); i++) {
+        integer_class a = mp_abs(n[i]);
+        result[i] = _probab_prime_p(a, reps);
+    }
+}
+
+void prime_factors_batch(vec_integer_class &primes,
+                         std::vector<size_t> &offsets,
+                         const vec_integer_class &n)
+{
+    std::vector<unsigned> small;
+    Sieve::generate_primes(small, 1 << 16);
+    const integer_class &product = small_primes_product();
+    // Zero has no prime factors, as for prime_factors
+    vec_integer_class a(n.size());
+    for (size_t i = 0; i < n.size(); i++)
+        a[i] = n[i] == 0 ? integer_class(1) : mp_abs(n[i]);
+    vec_integer_class rem;
+    if (not a.empty()) {
+        std::vector<vec_integer_class> tree;
+        product_tree(tree, a);
+        remainder_tree(rem, product, tree);
+    }
+
+    // The small prime factors and the prime cofactors are found in parallel,
+    // while the composite cofactors are split one at a time, the methods
+    // doing so being parallel themselves and sharing the Sieve
+    std::vector<vec_integer_class> factors(n.size());
+    std::vector<size_t> composite;
+#pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < n.size(); i++) {
+        // g is the product of the distinct primes below 2**16 dividing a[i]
+        integer_class g;
+        mp_gcd(g, rem[i], a[i]);
+        for (size_t j = 0; g != 1; j++) {
+            integer_class p(small[j]);
+            if (p * p > g)
+                p = g;
+            if (not mp_divisible_p(g, p))
+                continue;
+            mp_divexact(g, g, p);
+            do {
+                factors[i].push_back(p);
+                mp_divexact(a[i], a[i], p);
+            } while (mp_divisible_p(a[i], p));
+        }
+        if (a[i] == 1)
+            continue;
+        if (a[i] < integer_class(1) << 32 or _probab_prime_p(a[i], 25)) {
+            factors[i].push_back(a[i]);
+        } else {
+#pragma omp critical
+            composite.push_back(i);
+        }
+    }
+    for (size_t i : composite) {
+        _factor_complete(factors[i], a[i], 0);
+        std::sort(factors[i].begin(), factors[i].end());
+    }
+
+    primes.clear();
+    offsets.assign(1, 0);
+    for (auto &f : factors) {
+        std::move(f.begin(), f.end(), std::back_inserter(primes));
+        offsets.push_back(primes.size());
+    }
+}
+
+std::vector<unsigned> Sieve::_primes = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29};
+bool Sieve::_clear = true;
+unsigned Sieve::_sieve_size = 32 * 1024 * 8; // 32K in bits
+
+namespace
+{
+// The sieve stores one byte for each 30 integers. Bit i of byte k stands for
+// 30 k + wheel_residues[i], which runs over the integers coprime to 2, 3 and
+// 5, so that they never have to be crossed off.
+const unsigned wheel_residues[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+// wheel_index[r] is the index of the first residue >= r
+const unsigned wheel_index[30] = {0, 0, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 4,
+                                  4, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7};
+
+// lowest_bit[c] is the index of the lowest set bit of c > 0
+const std::vector<unsigned char> &lowest_bit()
+{
+    static const std::vector<unsigned char> t = []() {
+        std::vector<unsigned char> t(256, 0);
+        for (unsigned c = 1; c < 256; c++)
+            while (not(c >> t[c] & 1))
+                ++t[c];
+        return t;
+    }();
+    return t;
+}
+
+// Crosses off the multiples of `base` (the odd primes above 5, up to
+// sqrt(last)) in the sieve of [lo, last], where lo is a multiple of 30. Only
+// multiples p k with k coprime to 30 and k >= p are crossed off. Those with
+// k = r mod 30 for a residue r share a bit and are p bytes apart, so each
+// residue is one strided loop. The bound is inclusive so that last may be
+// 2**64 - 1.
+template <typename Base>
+void wheel_sieve_segment(uint64_t lo, uint64_t last, const Base &base,
+                         std::vector<unsigned char> &seg)
+{
+    const uint64_t bytes = (last - lo) / 30 + 1;
+    seg.assign(bytes, 0xff);
+    // Numbers above last in the last byte, and 1
+    const uint64_t top = last - lo - 30 * (bytes - 1);
+    for (unsigned i = 0; i < 8; i++)
+        if (wheel_residues[i] > top)
+            seg[bytes - 1] &= static_cast<unsigned char>(~(1u << i));
+    if (lo == 0)
+        seg[0] &= 0xfe;
+
+    for (unsigned p : base) {
+        if (p < 7)
+            continue;
+        if ((uint64_t)p * p > last)
+            break;
+        // With lo = q p + r, the multiples k p <= last have k up to
+        // q + (r + last - lo) / p, which is q for most primes above the
+        // width of the segment
+        const uint64_t q = lo / p, d = lo - q * p + (last - lo);
+        const uint64_t kmin = std::max<uint64_t>(p, q + (lo != q * p ? 1 : 0));
+        const uint64_t kmax = q + (d < p ? 0 : d / p);
+        if (kmin > kmax)
+            continue;
+        for (unsigned j = 0; j < 8; j++) {
+            const unsigned r = wheel_residues[j];
+            const uint64_t k = kmin + (r + 30 - kmin % 30) % 30;
+            if (k > kmax)
+                continue;
+            const uint64_t m = (uint64_t)p * k;
+            const unsigned char mask = static_cast<unsigned char>(
+                ~(1u << wheel_index[(p % 30) * r % 30]));
+            for (uint64_t b = (m - lo) / 30; b < bytes; b += p)
+                seg[b] &= mask;
+        }
+    }
+}
+
+// Calls f(seg, lo) with the sieve of each segment [lo, lo + 30 seg.size()) of
+// [start, limit], in order. The segments are sieved in parallel, in batches
+// of one per thread, all reading the same base primes, which must include
+// those up to sqrt(limit) and are never written to.
+template <typename Base, typename F>
+void wheel_sieve(uint64_t start, uint64_t limit, const Base &base,
+                 uint64_t segment_bytes, F f)
+{
+    if (start > limit)
+        return;
+    const uint64_t width = 30 * segment_bytes;
+    const uint64_t first = start - start % 30;
+    const uint64_t nsegments = (limit - first) / width + 1;
+    const uint64_t batch = 64;
+    std::vector<std::vector<unsigned char>> segs(batch);
+    for (uint64_t b = 0; b < nsegments; b += batch) {
+        const uint64_t nb = std::min(batch, nsegments - b);
+#pragma omp parallel for schedule(dynamic)
+        for (uint64_t s = 0; s < nb; s++) {
+            const uint64_t lo = first + (b + s) * width;
+            const uint64_t last = lo + std::min(limit - lo, width - 1);
+            wheel_sieve_segment(lo, last, base, segs[s]);
+        }
+        for (uint64_t s = 0; s < nb; s++)
+            f(segs[s], first + (b + s) * width);
+    }
+}
+
+// The primes up to a bound, kept as the sieve of [0, top] for some top >=
+// bound, which takes a byte for each 30 integers instead of four bytes for
+// each prime. It is extended on demand and enumerated in increasing order,
+// 2, 3 and 5 first, as a base for wheel_sieve and the range sieves.
+class WheelBase
+{
+    std::vector<unsigned char> seg_;
+    uint64_t top_;
+
+public:
+    class iterator
+    {
+        const std::vector<unsigned char> *seg_;
+        uint64_t k_;
+        unsigned c_;
+        // Index of the current prime among 2, 3 and 5, or 3 past them
+        unsigned small_;
+
+        void skip()
+        {
+            while (c_ == 0 and k_ < seg_->size())
+                if (++k_ < seg_->size())
+                    c_ = (*seg_)[k_];
+        }
+
+    public:
+        iterator(const std::vector<unsigned char> &seg, uint64_t k)
+            : seg_(&seg), k_(k), c_(k < seg.size() ? seg[k] : 0),
+              small_(k < seg.size() ? 0 : 3)
+        {
+            skip();
+        }
+        unsigned operator*() const
+        {
+            if (small_ < 3) {
+                const unsigned small[3] = {2, 3, 5};
+                return small[small_];
+            }
+            return static_cast<unsigned>(30 * k_)
+                   + wheel_residues[lowest_bit()[c_]];
+        }
+        iterator &operator++()
+        {
+            if (small_ < 3) {
+                ++small_;
+            } else {
+                c_ &= c_ - 1;
+                skip();
+            }
+            return *this;
+        }
+        bool operator!=(const iterator &other) const
+        {
+            return k_ != other.k_ or c_ != other.c_ or small_ != other.small_;
+        }
+    };
+
+    WheelBase()
+    {
+        clear();
+    }
+    // Drops the primes above 29 and releases their memory
+    void clear()
+    {
+        std::vector<unsigned char>(1, 0xfe).swap(seg_);
+        top_ = 29;
+    }
+    // Sieves the primes up to `bound` if they are not in the base yet. The
+    // base is extended by whole bytes, except at the top of the range of
+    // unsigned, which it never goes beyond.
+    const WheelBase &extend(unsigned bound, uint64_t segment_bytes)
+    {
+        if (bound <= top_)
+            return *this;
+        const uint64_t last
+            = std::min<uint64_t>((uint64_t(bound) / 30 + 1) * 30 - 1, UINT_MAX);
+        extend(static_cast<unsigned>(isqrt(last)), segment_bytes);
+        seg_.reserve(last / 30 + 1);
+        wheel_sieve(top_ + 1, last, *this, segment_bytes,
+                    [&](const std::vector<unsigned char> &seg, uint64_t) {
+                        seg_.insert(seg_.end(), seg.begin(), seg.end());
+                    });
+        top_ = last;
+        return *this;
+    }
+    iterator begin() const
+    {
+        return iterator(seg_, 0);
+    }
+    iterator end() const
+    {
+        return iterator(seg_, seg_.size());
+    }
+};
+
+// The base kept between calls, like Sieve::_primes, and released by
+// Sieve::clear()
+WheelBase &wheel_base()
+{
+    static WheelBase base;
+    return base;
+}
 
-    unsigned p;
-    while ((p = pi.next_prime()) <= limit) {
-        count = 0;
-        while (_n % p == 0) { // when a prime factor is found, we divide
-            ++count;          // _n by that prime as much as we can
-            _n = _n / p;
-        }
-        if (count > 0) {
-            insert(primes_mul, integer(p), count);
-            if (_n == 1)
-                break;
-        }
+// Calls f(n) for each prime n of [start, limit] and returns true when that
+// is cheaper with is_prime_word than with wheel_sieve, which walks all the
+// primes up to sqrt(limit) for each segment. A test costs about as much as
+// walking 128 / log(sqrt(limit)) base primes, so sieving only pays once a
+// segment holds more than about sqrt(limit) / 128 integers; near 2**64 it
+// never does.
+template <typename F>
+bool narrow_primes(uint64_t start, uint64_t limit, uint64_t segment_bytes,
+                   F f)
+{
+    if (start > limit
+        or std::min(limit - start, 30 * segment_bytes) >= isqrt(limit) / 128)
+        return false;
+    for (uint64_t n = start;; n++) {
+        if (is_prime_word(n))
+            f(n);
+        if (n == limit)
+            break;
     }
-    if (not(_n == 1))
-        insert(primes_mul, integer(std::move(_n)), 1);
+    return true;
 }
 
-std::vector<unsigned> Sieve::_primes = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29};
-bool Sieve::_clear = true;
-unsigned Sieve::_sieve_size = 32 * 1024 * 8; // 32K in bits
+// Appends the primes of [start, limit] to `primes`
+template <typename T, typename Base>
+void wheel_primes(std::vector<T> &primes, uint64_t start, uint64_t limit,
+                  const Base &base, uint64_t segment_bytes)
+{
+    const std::vector<unsigned char> &lowest = lowest_bit();
+    for (unsigned p : {2u, 3u, 5u})
+        if (start <= p and p <= limit)
+            primes.push_back(p);
+    start = std::max<uint64_t>(start, 7);
+    wheel_sieve(start, limit, base, segment_bytes,
+                [&](const std::vector<unsigned char> &seg, uint64_t lo) {
+                    // The first segment may begin below start
+                    const uint64_t skip = lo < start ? start : 0;
+                    for (uint64_t k = 0; k < seg.size(); k++) {
+                        const uint64_t n = lo + 30 * k;
+                        for (unsigned c = seg[k]; c != 0; c &= c - 1) {
+                            const uint64_t q = n + wheel_residues[lowest[c]];
+                            if (q >= skip)
+                                primes.push_back(static_cast<T>(q));
+                        }
+                    }
+                });
+}
+} // namespace
 
 void Sieve::set_clear(bool clear)
 {
@@ -501,6 +2228,7 @@ void Sieve::set_clear(bool clear)
 void Sieve::clear()
 {
     _primes.erase(_primes.begin() + 10, _primes.end());
+    wheel_base().clear();
 }
 
 void Sieve::set_sieve_size(unsigned size)
@@ -518,46 +2246,20 @@ void Sieve::_extend(unsigned limit)
     if (_primes.back() < limit)
         primesieve::generate_primes(_primes.back() + 1, limit, &_primes);
 #else
+    const unsigned start = _primes.back() + 1;
+    if (limit < start)
+        return;
+    // The base primes up to sqrt(limit) are found first, which extends
+    // _primes when sqrt(limit) >= start
     const unsigned sqrt_limit
         = static_cast<unsigned>(std::floor(std::sqrt(limit)));
-    unsigned start = _primes.back() + 1;
-    if (limit <= start)
-        return;
-    if (sqrt_limit >= start) {
+    if (sqrt_limit >= start)
         _extend(sqrt_limit);
-        start = _primes.back() + 1;
-    }
-
-    unsigned segment = _sieve_size;
-    std::valarray<bool> is_prime(segment);
-    for (; start <= limit; start += 2 * segment) {
-        unsigned finish = std::min(start + segment * 2 + 1, limit);
-        is_prime[std::slice(0, segment, 1)] = true;
-        // considering only odd integers. An odd number n corresponds to
-        // n-start/2 in the array.
-        for (unsigned index = 1; index < _primes.size()
-                                 and _primes[index] * _primes[index] <= finish;
-             ++index) {
-            unsigned n = _primes[index];
-            unsigned multiple = (start / n + 1) * n;
-            if (multiple % 2 == 0)
-                multiple += n;
-            if (multiple > finish)
-                continue;
-            std::slice sl = std::slice((multiple - start) / 2,
-                                       1 + (finish - multiple) / (2 * n), n);
-            // starting from n*n, all the odd multiples of n are marked not
-            // prime.
-            is_prime[sl] = false;
-        }
-        for (unsigned n = start + 1; n <= finish; n += 2) {
-            if (is_prime[(n - start) / 2])
-                _primes.push_back(n);
-        }
-    }
+    std::vector<unsigned> primes;
+    wheel_primes(primes, _primes.back() + 1, limit, _primes, _sieve_size / 8);
+    _primes.insert(_primes.end(), primes.begin(), primes.end());
 #endif
 }
-
 void Sieve::generate_primes(std::vector<unsigned> &primes, unsigned limit)
 {
     _extend(limit);
@@ -566,8 +2268,57 @@ void Sieve::generate_primes(std::vector<unsigned> &primes, unsigned limit)
     // primes
     primes.reserve(it - _primes.begin());
     std::copy(_primes.begin(), it, std::back_inserter(primes));
+    // Only the primes above are dropped; the base primes of the 64-bit
+    // functions are kept until clear() is called
     if (_clear)
-        clear();
+        _primes.erase(_primes.begin() + 10, _primes.end());
+}
+
+void Sieve::generate_primes(std::vector<uint64_t> &primes, uint64_t start,
+                            uint64_t limit)
+{
+#ifdef HAVE_SYMENGINE_PRIMESIEVE
+    if (start <= limit)
+        primesieve::generate_primes(start, limit, &primes);
+#else
+    if (narrow_primes(start, limit, _sieve_size / 8,
+                      [&](uint64_t p) { primes.push_back(p); }))
+        return;
+    const WheelBase &base = wheel_base().extend(
+        static_cast<unsigned>(isqrt(limit)), _sieve_size / 8);
+    wheel_primes(primes, start, limit, base, _sieve_size / 8);
+#endif
+}
+
+uint64_t Sieve::count_primes(uint64_t start, uint64_t limit)
+{
+#ifdef HAVE_SYMENGINE_PRIMESIEVE
+    return start <= limit ? primesieve::count_primes(start, limit) : 0;
+#else
+    uint64_t count = 0;
+    if (narrow_primes(start, limit, _sieve_size / 8,
+                      [&](uint64_t) { ++count; }))
+        return count;
+    for (unsigned p : {2u, 3u, 5u})
+        if (start <= p and p <= limit)
+            ++count;
+    start = std::max<uint64_t>(start, 7);
+    const WheelBase &base = wheel_base().extend(
+        static_cast<unsigned>(isqrt(limit)), _sieve_size / 8);
+    wheel_sieve(start, limit, base, _sieve_size / 8,
+                [&](const std::vector<unsigned char> &seg, uint64_t lo) {
+                    uint64_t k = 0;
+                    // The first segment may begin below start
+                    for (; k < seg.size() and lo + 30 * k < start; k++)
+                        for (unsigned i = 0; i < 8; i++)
+                            if ((seg[k] >> i & 1)
+                                and lo + 30 * k + wheel_residues[i] >= start)
+                                ++count;
+                    for (; k < seg.size(); k++)
+                        count += std::bitset<8>(seg[k]).count();
+                });
+    return count;
+#endif
 }
 
 Sieve::iterator::iterator(unsigned max)
@@ -585,7 +2336,7 @@ Sieve::iterator::iterator()
 Sieve::iterator::~iterator()
 {
     if (_clear)
-        Sieve::clear();
+        _primes.erase(_primes.begin() + 10, _primes.end());
 }
 
 unsigned Sieve::iterator::next_prime()
@@ -603,6 +2354,219 @@ unsigned Sieve::iterator::next_prime()
     return SymEngine::Sieve::_primes[_index++];
 }
 
+namespace
+{
+#ifndef HAVE_SYMENGINE_ARB
+// Floating point numbers m * 2**e with an integer mantissa m, which the
+// functions below truncate to `prec` bits
+struct BigFloat {
+    integer_class m;
+    long e;
+};
+
+void truncate(BigFloat &x, unsigned long prec)
+{
+    const unsigned long bits = bit_length(x.m);
+    if (bits > prec) {
+        x.m = x.m >> (bits - prec);
+        x.e += static_cast<long>(bits - prec);
+    }
+}
+
+// x**n, with a relative error of about 2 log2(n) 2**-prec more than that
+// of x times n
+BigFloat pow(const BigFloat &x, unsigned long n, unsigned long prec)
+{
+    BigFloat r{integer_class(1), 0}, b = x;
+    for (; n > 0; n >>= 1) {
+        if (n & 1) {
+            r = {r.m * b.m, r.e + b.e};
+            truncate(r, prec);
+        }
+        if (n > 1) {
+            b = {b.m * b.m, 2 * b.e};
+            truncate(b, prec);
+        }
+    }
+    return r;
+}
+
+// Sets P, Q and T for the terms a to b - 1 of the Chudnovsky series
+//   1 / pi = 12 / 640320**(3/2) sum of (-1)**k (6k)! (13591409 + 545140134
+//            k) / ((3k)! (k!)**3 640320**(3k))
+// with P(a, b) and Q(a, b) the products of the ratios of consecutive
+// terms, and T(a, b) / Q(a, b) the sum of their terms relative to term a
+void chudnovsky(integer_class &P, integer_class &Q, integer_class &T,
+                unsigned long a, unsigned long b)
+{
+    if (b - a == 1) {
+        if (a == 0) {
+            P = Q = 1;
+        } else {
+            static const integer_class c
+                = integer_class(640320) * 640320 * 640320 / 24;
+            P = integer_class(6 * a - 5) * (2 * a - 1) * (6 * a - 1);
+            Q = integer_class(a) * a * a * c;
+        }
+        T = P * (integer_class(545140134UL) * a + 13591409UL);
+        if (a % 2 == 1)
+            T = -T;
+        return;
+    }
+    const unsigned long m = (a + b) / 2;
+    integer_class P2, Q2, T2;
+    chudnovsky(P, Q, T, a, m);
+    chudnovsky(P2, Q2, T2, m, b);
+    T = T * Q2 + P * T2;
+    P *= P2;
+    Q *= Q2;
+}
+
+// floor(pi * 2**prec), within one. The digits of the most precise value
+// computed so far are kept.
+integer_class pi_fixed(unsigned long prec)
+{
+    static integer_class pi;
+    static unsigned long pi_prec = 0;
+    integer_class r;
+#pragma omp critical(symengine_pi)
+    {
+        if (pi_prec < prec) {
+            // Each term adds about 47.11 bits
+            const unsigned long w = prec + 32;
+            integer_class P, Q, T;
+            chudnovsky(P, Q, T, 0, w / 47 + 2);
+            integer_class s(10005);
+            s = mp_sqrt(s << (2 * w));
+            mp_fdiv_q(pi, s * 426880 * Q, T);
+            pi_prec = w;
+        }
+        r = pi >> (pi_prec - prec);
+    }
+    return r;
+}
+
+// B_n of even n > 2 from
+//   |B_n| = 2 n! zeta(n) / (2 pi)**n,
+// with the sign (-1)**(n / 2 + 1). By the von Staudt-Clausen theorem the
+// denominator of B_n is the product D of the primes p with p - 1 | n, so
+// that |B_n| D is the integer nearest to the value computed here, with a
+// relative precision of more bits than it has.
+rational_class bernoulli_zeta(unsigned long n)
+{
+    integer_class D(1);
+    for (unsigned long d = 1; d * d <= n; d++) {
+        if (n % d != 0)
+            continue;
+        if (is_prime_word(d + 1))
+            D *= d + 1;
+        if (d * d != n and is_prime_word(n / d + 1))
+            D *= n / d + 1;
+    }
+
+    // log2 of |B_n| D
+    const double size = (std::lgamma(double(n) + 1)
+                         - double(n) * std::log(2 * 3.14159265358979324))
+                            / std::log(2.0)
+                        + 1 + bit_length(D);
+    const unsigned long nbits = bit_length(integer_class(n));
+    const unsigned long prec
+        = static_cast<unsigned long>(std::max(size, 0.0)) + 64 + 2 * nbits;
+
+    // (2 pi)**n, from pi to nbits more bits than needed
+    const unsigned long wp = prec + nbits + 16;
+    const BigFloat two_pi{pi_fixed(wp), 1 - static_cast<long>(wp)};
+    const BigFloat t = pow(two_pi, n, wp);
+
+    // 1 / zeta(n) * 2**prec as the product of 1 - p**-n over the primes p
+    // with p**n < 2**prec. Each p**-n is needed to prec - n log2(p) bits
+    // only, and the product is truncated to as many bits before it is
+    // multiplied by it. The powers, which take most of the time, are
+    // computed in parallel.
+    std::vector<unsigned> primes;
+    Sieve::generate_primes(
+        primes, static_cast<unsigned>(std::exp2(double(prec) / double(n))));
+    std::vector<unsigned long> r(primes.size());
+    std::vector<integer_class> q(primes.size());
+#pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < primes.size(); i++) {
+        const double lost = double(n) * std::log2(double(primes[i]));
+        r[i] = prec - std::min(prec, static_cast<unsigned long>(lost)) + 32;
+        const BigFloat pn = pow(BigFloat{integer_class(primes[i]), 0}, n, r[i]);
+        // p**-n * 2**(prec + 32)
+        const long shift = static_cast<long>(prec) + 32 - pn.e;
+        mp_fdiv_q(q[i], integer_class(1) << static_cast<unsigned long>(shift),
+                  pn.m);
+    }
+    integer_class inv = integer_class(1) << prec;
+    for (size_t i = 0; i < primes.size(); i++) {
+        const unsigned long shift = prec > r[i] ? prec - r[i] : 0;
+        inv -= ((inv >> shift) * q[i]) >> (prec + 32 - shift);
+    }
+
+    // |B_n| D = 2 n! D / (2 pi)**n / (inv / 2**prec)
+    integer_class num, den = t.m * inv;
+    _factorial(num, n);
+    num *= 2 * D;
+    const long s = static_cast<long>(prec) - t.e;
+    if (s >= 0)
+        num = num << static_cast<unsigned long>(s);
+    else
+        den = den << static_cast<unsigned long>(-s);
+    integer_class N;
+    mp_fdiv_q(N, 2 * num + den, 2 * den);
+    if (n % 4 == 0)
+        N = -N;
+    rational_class b(N, D);
+    canonicalize(b);
+    return b;
+}
+
+// B_0, B_2, ..., B_2(size - 1) from the tangent numbers T_k, by
+//   B_2k = (-1)**(k - 1) 2k T_k / (4**k (4**k - 1)),
+// with the T_k computed by the algorithm of Brent and Harvey in O(size**2)
+// operations on integers
+void bernoulli_table(std::vector<rational_class> &table, unsigned long size)
+{
+    std::vector<integer_class> T(size);
+    if (size > 1)
+        T[1] = 1;
+    for (unsigned long k = 2; k < size; k++)
+        T[k] = (k - 1) * T[k - 1];
+    for (unsigned long k = 2; k < size; k++)
+        for (unsigned long j = k; j < size; j++)
+            T[j] = (j - k) * T[j - 1] + (j - k + 2) * T[j];
+    table.assign(size, rational_class(1));
+    for (unsigned long k = 1; k < size; k++) {
+        integer_class four_k = integer_class(1) << (2 * k);
+        integer_class num = 2 * k * T[k];
+        if (k % 2 == 0)
+            num = -num;
+        table[k] = rational_class(num, four_k * (four_k - 1));
+        canonicalize(table[k]);
+    }
+}
+#endif // !HAVE_SYMENGINE_ARB
+
+// Sets p / q to the sum of 1 / k**m for k in [a, b), by binary splitting.
+// The fraction is not reduced.
+void harmonic_split(integer_class &p, integer_class &q, unsigned long a,
+                    unsigned long b, unsigned long m)
+{
+    if (b - a == 1) {
+        p = 1;
+        mp_pow_ui(q, integer_class(a), m);
+        return;
+    }
+    const unsigned long c = (a + b) / 2;
+    integer_class p2, q2;
+    harmonic_split(p, q, a, c, m);
+    harmonic_split(p2, q2, c, b, m);
+    p = p * q2 + p2 * q;
+    q *= q2;
+}
+} // anonymous namespace
+
 RCP<const Number> bernoulli(unsigned long n)
 {
 #ifdef HAVE_SYMENGINE_ARB
@@ -617,45 +2581,70 @@ RCP<const Number> bernoulli(unsigned long n)
     mpq_clear(a);
     return Rational::from_mpq(std::move(b));
 #else
-    // TODO: implement a faster algorithm
-    std::vector<rational_class> v(n + 1);
-    for (unsigned m = 0; m <= n; ++m) {
-        v[m] = rational_class(1u, m + 1);
-
-        for (unsigned j = m; j >= 1; --j) {
-            v[j - 1] = j * (v[j - 1] - v[j]);
+    if (n == 1)
+        return Rational::from_mpq(rational_class(1u, 2u));
+    if (n % 2 == 1)
+        return Rational::from_mpq(rational_class(0));
+    // B_0 to B_256 come from one table, and the last larger ones computed
+    // are kept, `order` listing them from the oldest
+    const unsigned long table_size = 129;
+    const size_t cache_size = 64;
+    static std::vector<rational_class> table;
+    static std::map<unsigned long, rational_class> cache;
+    static std::deque<unsigned long> order;
+    rational_class b;
+    bool found = false;
+#pragma omp critical(symengine_bernoulli)
+    {
+        if (n / 2 < table_size) {
+            if (table.empty())
+                bernoulli_table(table, table_size);
+            b = table[n / 2];
+            found = true;
+        } else {
+            auto it = cache.find(n);
+            if (it != cache.end()) {
+                b = it->second;
+                found = true;
+            }
+        }
+    }
+    if (not found) {
+        b = bernoulli_zeta(n);
+#pragma omp critical(symengine_bernoulli)
+        {
+            // Another thread may have computed B_n meanwhile
+            if (cache.find(n) == cache.end()) {
+                if (cache.size() == cache_size) {
+                    cache.erase(order.front());
+                    order.pop_front();
+                }
+                cache[n] = b;
+                order.push_back(n);
+            }
         }
     }
-    return Rational::from_mpq(v[0]);
+    return Rational::from_mpq(std::move(b));
 #endif
 }
 
 RCP<const Number> harmonic(unsigned long n, long m)
 {
-    rational_class res(0);
-    if (m == 1) {
-        for (unsigned i = 1; i <= n; ++i) {
-            res += rational_class(1u, i);
-        }
-        return Rational::from_mpq(res);
-    } else {
-        for (unsigned i = 1; i <= n; ++i) {
-            if (m > 0) {
-                rational_class t(1u, i);
-#if SYMENGINE_INTEGER_CLASS != SYMENGINE_BOOSTMP
-                mp_pow_ui(get_den(t), get_den(t), m);
-#else
-                mp_pow_ui(t, t, m);
-#endif
-                res += t;
-            } else {
-                integer_class t(i);
-                mp_pow_ui(t, t, static_cast<unsigned long>(-m));
-                res += t;
-            }
-        }
-        return Rational::from_mpq(res);
+    if (n == 0)
+        return Rational::from_mpq(rational_class(0));
+    if (m > 0) {
+        integer_class p, q;
+        harmonic_split(p, q, 1, n + 1, static_cast<unsigned long>(m));
+        rational_class res(p, q);
+        canonicalize(res);
+        return Rational::from_mpq(std::move(res));
+    }
+    integer_class res(0), t;
+    for (unsigned long i = 1; i <= n; ++i) {
+        mp_pow_ui(t, integer_class(i), static_cast<unsigned long>(-m));
+        res += t;
     }
+    return integer(std::move(res));
 }
 
 // References : Cohen H., A course in computational algebraic number theory
@@ -1083,53 +3072,489 @@ bool _sqrt_mod_prime(integer_class &rop, const integer_class &a,
     return true;
 }
 
+// Arithmetic modulo an odd n < 2**64, on residues in Montgomery form. The
+// exponents fit in a word and the residues are their own hash keys.
+class WordResidues
+{
+private:
+    MontgomeryWord M_;
+    integer_class n_;
+
+public:
+    typedef uint64_t element;
+    typedef uint64_t exponent;
+    static const bool exact_keys = true;
+
+    WordResidues(const integer_class &n) : M_(mp_get_ui(n)), n_{n}
+    {
+    }
+    element one() const
+    {
+        return M_.one();
+    }
+    element from(const integer_class &a) const
+    {
+        integer_class t;
+        mp_fdiv_r(t, a, n_);
+        return M_.to(mp_get_ui(t));
+    }
+    integer_class to_integer(element a) const
+    {
+        return integer_class(M_.mul(a, 1));
+    }
+    element mul(element a, element b) const
+    {
+        return M_.mul(a, b);
+    }
+    element pow(element b, uint64_t e) const
+    {
+        element r = M_.one();
+        for (; e != 0; e >>= 1) {
+            if (e & 1)
+                r = M_.mul(r, b);
+            b = M_.mul(b, b);
+        }
+        return r;
+    }
+    element pow(element b, const integer_class &e) const
+    {
+        return pow(b, uint64_t(mp_get_ui(e)));
+    }
+    uint64_t key(element a) const
+    {
+        return a;
+    }
+    static exponent to_exponent(const integer_class &e)
+    {
+        return mp_get_ui(e);
+    }
+    static void add(exponent &a, exponent b, exponent q)
+    {
+        a = a >= q - b ? a - (q - b) : a + b;
+    }
+};
+
+// Arithmetic modulo any n > 1. The hash key of a residue is its remainder
+// modulo a word prime, so that a match has to be confirmed.
+class IntegerResidues
+{
+private:
+    integer_class n_;
+
+public:
+    typedef integer_class element;
+    typedef integer_class exponent;
+    static const bool exact_keys = false;
+
+    IntegerResidues(const integer_class &n) : n_{n}
+    {
+    }
+    element one() const
+    {
+        return integer_class(1);
+    }
+    element from(const integer_class &a) const
+    {
+        integer_class t;
+        mp_fdiv_r(t, a, n_);
+        return t;
+    }
+    integer_class to_integer(const element &a) const
+    {
+        return a;
+    }
+    element mul(const element &a, const element &b) const
+    {
+        integer_class t = a * b;
+        mp_fdiv_r(t, t, n_);
+        return t;
+    }
+    element pow(const element &b, const integer_class &e) const
+    {
+        integer_class t;
+        mp_powm(t, b, e, n_);
+        return t;
+    }
+    uint64_t key(const element &a) const
+    {
+        integer_class t;
+        mp_fdiv_r(t, a, integer_class(4294967291UL));
+        return mp_get_ui(t);
+    }
+    static exponent to_exponent(const integer_class &e)
+    {
+        return e;
+    }
+    static void add(exponent &a, const exponent &b, const exponent &q)
+    {
+        a += b;
+        if (a >= q)
+            a -= q;
+    }
+};
+
 // References : Menezes, Alfred J., Paul C. Van Oorschot, and Scott A. Vanstone.
 // Handbook of applied cryptography. CRC press, 2010. pages 104 - 108
-// Calculates log = x mod q**k where g**x == a mod p and order(g, p) = n.
-void _discrete_log(integer_class &log, const integer_class &a,
-                   const integer_class &g, const integer_class &n,
-                   const integer_class &q, const unsigned &k,
-                   const integer_class &p)
+// Discrete logarithms to the base g, a residue of order N with the prime
+// factorisation `factors`. Pohlig-Hellman reduces a logarithm to one per
+// prime power q**e dividing N, and each of those to e logarithms in the
+// subgroup of prime order q. These are found by baby-step giant-step with
+// a hash table of the baby steps that is built once for all the targets,
+// or by Pollard's rho when q is too large for a table. Should rho fail, a
+// smaller table is built for baby-step giant-step with more giant steps.
+template <typename Group>
+class DiscreteLog
 {
-    log = 0;
-    integer_class gamma = a, alpha, _n, t, beta, qj(1), m, l;
-    _n = n / q;
-    mp_powm(alpha, g, _n, p);
-    mp_sqrtrem(m, t, q);
-    if (t != 0)
-        ++m; // m = ceiling(sqrt(q)).
-    map_integer_uint
-        table; // Table for lookup in baby-step giant-step algorithm
-    integer_class alpha_j(1), d, s;
-    s = -m;
-    mp_powm(s, alpha, s, p);
-
-    for (unsigned j = 0; j < m; ++j) {
-        insert(table, integer(alpha_j), j);
-        alpha_j = (alpha_j * alpha) % p;
-    }
-
-    for (unsigned long j = 0; j < k; ++j) { // Pohlig-Hellman
-        mp_powm(beta, gamma, _n, p);
-        // Baby-step giant-step algorithm for l = log_alpha(beta)
-        d = beta;
-        bool found = false;
-        for (unsigned i = 0; not found && i < m; ++i) {
-            if (table.find(integer(d)) != table.end()) {
-                l = i * m + table[integer(d)];
-                found = true;
-                break;
+public:
+    typedef typename Group::element element;
+    typedef typename Group::exponent exponent;
+
+private:
+    // Baby steps gamma**j for j < m, at slots given by their hash keys,
+    // with j + 1 stored in `steps` and 0 marking an empty slot
+    struct Table {
+        std::vector<uint64_t> keys;
+        std::vector<uint32_t> steps;
+        unsigned shift;
+        uint64_t m, giants;
+        element giant; // gamma**-m
+    };
+    struct Subgroup {
+        integer_class q, qe, cofactor; // q, q**e and N / q**e
+        unsigned e;
+        element ge, ge_inv; // g**cofactor, of order q**e, and its inverse
+        element gamma;      // g**(N / q), of order q
+        Table table;        // Empty when q is left to rho
+    };
+    Group G_;
+    element g_;
+    integer_class N_;
+    std::vector<Subgroup> sub_;
+
+    static size_t slot(uint64_t key, unsigned shift)
+    {
+        return static_cast<size_t>((key * 0x9e3779b97f4a7c15ULL) >> shift);
+    }
+
+    // Fills t with m <= q baby steps of gamma, of prime order q
+    void build(Table &t, const element &gamma, const integer_class &q,
+               uint64_t m) const
+    {
+        t.m = m;
+        integer_class giants = (q + m - 1) / m, r;
+        t.giants = mp_fits_ulong_p(giants) ? mp_get_ui(giants) : UINT64_MAX;
+        unsigned bits = 1;
+        while ((uint64_t(1) << bits) < 2 * m)
+            ++bits;
+        t.shift = 64 - bits;
+        t.keys.resize(size_t(1) << bits);
+        t.steps.resize(size_t(1) << bits);
+        const size_t mask = t.steps.size() - 1;
+        element x = G_.one();
+        for (uint64_t j = 0; j < m; ++j) {
+            const uint64_t k = G_.key(x);
+            size_t h = slot(k, t.shift);
+            while (t.steps[h] != 0)
+                h = (h + 1) & mask;
+            t.keys[h] = k;
+            t.steps[h] = static_cast<uint32_t>(j + 1);
+            x = G_.mul(x, gamma);
+        }
+        mp_fdiv_r(r, integer_class(m), q);
+        t.giant = G_.pow(gamma, q - r);
+    }
+
+    bool baby_giant(integer_class &d, const Subgroup &s, const Table &t,
+                    const element &beta) const
+    {
+        const size_t mask = t.steps.size() - 1;
+        element y = beta;
+        for (uint64_t i = 0; i < t.giants; ++i) {
+            const uint64_t k = G_.key(y);
+            for (size_t h = slot(k, t.shift); t.steps[h] != 0;
+                 h = (h + 1) & mask) {
+                if (t.keys[h] != k)
+                    continue;
+                d = integer_class(i) * t.m + (t.steps[h] - 1);
+                if (d < s.q
+                    and (Group::exact_keys or G_.pow(s.gamma, d) == beta))
+                    return true;
+            }
+            y = G_.mul(y, t.giant);
+        }
+        return false;
+    }
+
+    // Pollard's rho with Teske's 20-adding walk and Brent's cycle detection.
+    // A walk that takes more than 8 sqrt(q) steps, which is most unlikely
+    // if beta is a power of gamma, ends the search.
+    bool rho(integer_class &d, const Subgroup &s, const element &beta) const
+    {
+        const unsigned r = 20;
+        const exponent q = Group::to_exponent(s.q);
+        const integer_class w = 8 * mp_sqrt(s.q) + 64;
+        const uint64_t walk = mp_fits_ulong_p(w) ? mp_get_ui(w) : UINT64_MAX;
+        std::mt19937_64 rng(12345);
+        auto random = [&]() {
+            integer_class t(rng());
+            mp_fdiv_r(t, t, s.q);
+            return Group::to_exponent(t);
+        };
+        for (unsigned attempt = 0; attempt < 32; ++attempt) {
+            std::vector<element> M;
+            std::vector<exponent> u, v;
+            for (unsigned i = 0; i < r; ++i) {
+                u.push_back(random());
+                v.push_back(random());
+                M.push_back(G_.mul(G_.pow(s.gamma, u[i]), G_.pow(beta, v[i])));
+            }
+            // x = gamma**a * beta**b for the hare and the tortoise
+            exponent a = random(), b = random();
+            element x = G_.mul(G_.pow(s.gamma, a), G_.pow(beta, b));
+            element y = x;
+            exponent ay = a, by = b;
+            for (uint64_t power = 1, lambda = 0, steps = 0;; ++steps) {
+                if (steps == walk)
+                    return false;
+                const size_t i = static_cast<size_t>(G_.key(x) % r);
+                x = G_.mul(x, M[i]);
+                Group::add(a, u[i], q);
+                Group::add(b, v[i], q);
+                if (x == y)
+                    break;
+                if (++lambda == power) {
+                    y = x;
+                    ay = a;
+                    by = b;
+                    power *= 2;
+                    lambda = 0;
+                }
+            }
+            // gamma**(a - ay) == beta**(by - b)
+            integer_class da = integer_class(a) - integer_class(ay),
+                          db = integer_class(by) - integer_class(b), t;
+            mp_fdiv_r(db, db, s.q);
+            if (db == 0)
+                continue;
+            mp_invert(t, db, s.q);
+            d = da * t;
+            mp_fdiv_r(d, d, s.q);
+            if (G_.pow(s.gamma, d) == beta)
+                return true;
+        }
+        return false;
+    }
+
+    bool subgroup_log(integer_class &d, const Subgroup &s,
+                      const element &beta) const
+    {
+        if (beta == G_.one()) {
+            d = 0;
+            return true;
+        }
+        if (not s.table.steps.empty())
+            return baby_giant(d, s, s.table, beta);
+        // An element of order other than q is not a power of gamma
+        if (G_.pow(beta, s.q) != G_.one())
+            return false;
+        if (rho(d, s, beta))
+            return true;
+        // Rho gives up when its walks run too long or only meet degenerate
+        // collisions, which is unlikely for a power of gamma but does not
+        // rule one out
+        Table t;
+        build(t, s.gamma, s.q, uint64_t(1) << 18);
+        return baby_giant(d, s, t, beta);
+    }
+
+public:
+    //! The tables are sized for `targets` logarithms
+    DiscreteLog(const Group &G, const integer_class &g, const integer_class &N,
+                const map_integer_uint &factors, size_t targets)
+        : G_(G), g_(G.from(g)), N_(N)
+    {
+        for (const auto &it : factors) {
+            Subgroup s;
+            s.q = it.first->as_integer_class();
+            s.e = it.second;
+            mp_pow_ui(s.qe, s.q, s.e);
+            s.cofactor = N / s.qe;
+            s.ge = G_.pow(g_, s.cofactor);
+            s.ge_inv = G_.pow(s.ge, s.qe - 1);
+            s.gamma = G_.pow(g_, N / s.q);
+            if (s.q < integer_class(1) << 36) {
+                // Balance the baby steps against the giant steps of all
+                // the targets, within 2**18 table entries
+                const uint64_t q = mp_get_ui(s.q);
+                double m = std::ceil(std::sqrt(double(q) * double(targets)
+                                               * double(s.e)));
+                build(s.table, s.gamma, s.q,
+                      std::min<uint64_t>(std::min<uint64_t>(q, 1 << 18),
+                                         static_cast<uint64_t>(m)));
+            }
+            sub_.push_back(std::move(s));
+        }
+    }
+
+    //! Sets x to the logarithm of a in [0, N). Returns false if there is
+    //! none.
+    bool log(integer_class &x, const integer_class &a) const
+    {
+        const element h = G_.from(a);
+        if (G_.pow(h, N_) != G_.one())
+            return false;
+        integer_class modulus(1), xq, qj, d, t;
+        x = 0;
+        for (const Subgroup &s : sub_) {
+            // xq = sum(d_j q**j) is the logarithm of y = h**cofactor to the
+            // base ge, with d_j the logarithm of (y ge**-(d_0 + ... +
+            // d_(j-1) q**(j-1)))**(q**(e-1-j)) to the base gamma
+            element y = G_.pow(h, s.cofactor);
+            xq = 0;
+            qj = 1;
+            for (unsigned j = 0; j < s.e; ++j) {
+                if (not subgroup_log(d, s, G_.pow(y, s.qe / (qj * s.q))))
+                    return false;
+                t = d * qj;
+                xq += t;
+                y = G_.mul(y, G_.pow(s.ge_inv, t));
+                qj *= s.q;
             }
-            d = (d * s) % p;
+            // Chinese remaindering of x mod modulus and xq mod q**e
+            mp_invert(t, modulus, s.qe);
+            t *= xq - x;
+            mp_fdiv_r(t, t, s.qe);
+            x += modulus * t;
+            modulus *= s.qe;
+        }
+        return G_.pow(g_, x) == h;
+    }
+};
+
+// Sets N to the order of the unit g mod n and `factors` to its prime
+// factorisation, by reducing the Carmichael function of n
+void _order_factors(integer_class &N, map_integer_uint &factors,
+                    const integer_class &g, const integer_class &n)
+{
+    RCP<const Integer> lambda = carmichael(integer(n));
+    map_integer_uint prime_mul;
+    prime_factor_multiplicities(prime_mul, *lambda);
+    integer_class p, t;
+    N = lambda->as_integer_class();
+    for (const auto &it : prime_mul) {
+        p = it.first->as_integer_class();
+        mp_pow_ui(t, p, it.second);
+        mp_divexact(N, N, t);
+        mp_powm(t, g, N, n);
+        unsigned e = 0;
+        while (t != 1) {
+            mp_powm(t, t, p, n);
+            N *= p;
+            ++e;
+        }
+        if (e > 0)
+            insert(factors, it.first, e);
+    }
+}
+
+template <typename Group>
+void _discrete_log_group(vec_integer_class &x, const vec_integer_class &a,
+                         const integer_class &g, const integer_class &N,
+                         const map_integer_uint &factors,
+                         const integer_class &n)
+{
+    const DiscreteLog<Group> L(Group(n), g, N, factors, a.size());
+#pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < a.size(); i++) {
+        if (not L.log(x[i], a[i]))
+            x[i] = -1;
+    }
+}
+
+// Logarithms of each of a to the base g of order N mod n, or -1 where there
+// is none. A modulus that is odd and fits in a word gets machine arithmetic.
+void _discrete_log_mod(vec_integer_class &x, const vec_integer_class &a,
+                       const integer_class &g, const integer_class &N,
+                       const map_integer_uint &factors, const integer_class &n)
+{
+    x.resize(a.size());
+    if (mp_fits_ulong_p(n) and n % 2 == 1)
+        _discrete_log_group<WordResidues>(x, a, g, N, factors, n);
+    else
+        _discrete_log_group<IntegerResidues>(x, a, g, N, factors, n);
+}
+
+// Sets x[i] to the smallest x >= 0 with g**x == a[i] mod n, or to -1 if
+// there is none. If g is not a unit, the powers of g are periodic from
+// x = bit_length(n) on, and the logarithm is then taken modulo the largest
+// divisor of n coprime to g.
+void _discrete_log_batch(vec_integer_class &x, const vec_integer_class &a,
+                         const integer_class &g, const integer_class &n)
+{
+    x.assign(a.size(), integer_class(-1));
+    if (n <= 1) {
+        if (n == 1)
+            x.assign(a.size(), integer_class(0));
+        return;
+    }
+    integer_class _g, n1(1), n2 = n, t;
+    mp_fdiv_r(_g, g, n);
+    for (mp_gcd(t, _g, n2); t != 1; mp_gcd(t, _g, n2)) {
+        mp_divexact(n2, n2, t);
+        n1 *= t;
+    }
+
+    vec_integer_class b(a.size());
+    for (size_t i = 0; i < a.size(); i++)
+        mp_fdiv_r(b[i], a[i], n);
+    const unsigned period = n1 == 1 ? 0 : bit_length(n);
+    std::vector<size_t> rest;
+    for (size_t i = 0; i < a.size(); i++) {
+        t = 1;
+        for (unsigned j = 0; j < period and x[i] < 0; j++) {
+            if (t == b[i])
+                x[i] = integer_class(j);
+            t = t * _g % n;
         }
-        _n /= q;
-        t = -l * qj;
+        if (x[i] < 0 and b[i] % n1 == 0)
+            rest.push_back(i);
+    }
+    if (rest.empty())
+        return;
 
-        log -= t;
-        mp_powm(t, g, t, p);
-        gamma *= t; // gamma *= g ** (-l * (q ** j))
-        qj *= q;
+    vec_integer_class c, y;
+    for (size_t i : rest)
+        c.push_back(b[i] % n2);
+    if (n2 == 1) {
+        y.assign(c.size(), integer_class(0));
+        t = 1;
+    } else {
+        map_integer_uint factors;
+        _order_factors(t, factors, _g % n2, n2);
+        _discrete_log_mod(y, c, _g % n2, t, factors, n2);
     }
+    // The smallest x >= period congruent to y mod t, the order of g mod n2
+    const integer_class p(period);
+    for (size_t i = 0; i < rest.size(); i++) {
+        if (y[i] < 0)
+            continue;
+        if (y[i] < p)
+            y[i] += (p - y[i] + t - 1) / t * t;
+        x[rest[i]] = y[i];
+    }
+}
+
+// Calculates log = x mod q**k where g**x == a mod p and order(g, p) = n = q**k.
+void _discrete_log(integer_class &log, const integer_class &a,
+                   const integer_class &g, const integer_class &n,
+                   const integer_class &q, const unsigned &k,
+                   const integer_class &p)
+{
+    map_integer_uint factors;
+    insert(factors, integer(q), k);
+    vec_integer_class x;
+    _discrete_log_mod(x, {a}, g, n, factors, p);
+    log = x[0];
 }
 
 // References : Johnston A., A generalised qth root algorithm.
@@ -1541,6 +3966,24 @@ void nthroot_mod_list(std::vector<RCP<const Integer>> &roots,
     std::sort(roots.begin(), roots.end(), SymEngine::RCPIntegerKeyLess());
 }
 
+bool discrete_log(const Ptr<RCP<const Integer>> &x, const Integer &a,
+                  const Integer &g, const Integer &n)
+{
+    vec_integer_class y;
+    _discrete_log_batch(y, {a.as_integer_class()}, g.as_integer_class(),
+                        n.as_integer_class());
+    if (y[0] < 0)
+        return false;
+    *x = integer(std::move(y[0]));
+    return true;
+}
+
+void discrete_log_batch(vec_integer_class &x, const vec_integer_class &a,
+                        const integer_class &g, const integer_class &n)
+{
+    _discrete_log_batch(x, a, g, n);
+}
+
 bool powermod(const Ptr<RCP<const Integer>> &powm, const RCP<const Integer> &a,
               const RCP<const Number> &b, const RCP<const Integer> &m)
 {
@@ -1737,12 +4180,195 @@ int mobius(const Integer &a)
     }
 }
 
+namespace
+{
+// Number of entries in a segment of the range sieves below, which is also
+// the segment size in bytes for extending their base
+const uint64_t range_segment = 1 << 15;
+
+// The primes up to sqrt(limit), from the base that Sieve keeps for its
+// 64-bit functions, so that they are never all stored in one vector
+const WheelBase &range_base(uint64_t limit)
+{
+    return wheel_base().extend(static_cast<unsigned>(isqrt(limit)),
+                               range_segment);
+}
+
+// Sets mu[i] to mobius(lo + i) for i < n, where lo > 0 and `base` holds the
+// primes up to sqrt(lo + n - 1). prod[i] collects the product of the small
+// primes dividing lo + i; if that falls short of lo + i, the cofactor is a
+// single larger prime.
+template <typename T>
+void mobius_segment(T *mu, uint64_t lo, uint64_t n, const WheelBase &base,
+                    std::vector<uint64_t> &prod)
+{
+    std::fill(mu, mu + n, 1);
+    prod.assign(n, 1);
+    for (unsigned p : base) {
+        // lo + n itself wraps to 0 at the top of the range
+        if ((uint64_t)p * p > lo + n - 1)
+            break;
+        for (uint64_t i = (p - lo % p) % p; i < n; i += p) {
+            mu[i] = static_cast<T>(-mu[i]);
+            prod[i] *= p;
+        }
+        const uint64_t q = (uint64_t)p * p;
+        for (uint64_t i = (q - lo % q) % q; i < n; i += q)
+            mu[i] = 0;
+    }
+    for (uint64_t i = 0; i < n; i++)
+        if (prod[i] != lo + i)
+            mu[i] = static_cast<T>(-mu[i]);
+}
+
+// Sets out[i - start] to the multiplicative function f(i) for i in
+// [start, limit], where f(p**e) = g(p, e). The primes up to sqrt(limit) are
+// divided out of each segment; what is left of i is 1 or a single prime.
+template <typename T, typename G>
+void multiplicative_range(std::vector<T> &out, uint64_t start,
+                          uint64_t limit, G g)
+{
+    out.assign(limit - start + 1, 1);
+    const WheelBase &base = range_base(limit);
+    const uint64_t nsegments = (limit - start) / range_segment + 1;
+#pragma omp parallel for schedule(dynamic)
+    for (uint64_t s = 0; s < nsegments; s++) {
+        const uint64_t lo = start + s * range_segment;
+        const uint64_t n = std::min(limit - lo, range_segment - 1) + 1;
+        T *f = &out[lo - start];
+        std::vector<uint64_t> rem(n);
+        for (uint64_t i = 0; i < n; i++)
+            rem[i] = lo + i;
+        for (unsigned p : base) {
+            if ((uint64_t)p * p > lo + n - 1)
+                break;
+            for (uint64_t i = (p - lo % p) % p; i < n; i += p) {
+                unsigned e = 0;
+                do {
+                    rem[i] /= p;
+                    ++e;
+                } while (rem[i] % p == 0);
+                f[i] *= g(p, e);
+            }
+        }
+        for (uint64_t i = 0; i < n; i++)
+            if (rem[i] > 1)
+                f[i] *= g(rem[i], 1);
+    }
+}
+} // namespace
+
+void mobius_range(std::vector<int> &mu, uint64_t start, uint64_t limit)
+{
+    if (start == 0)
+        throw SymEngineException("mobius_range: start must be positive");
+    mu.clear();
+    if (start > limit)
+        return;
+    mu.resize(limit - start + 1);
+    const WheelBase &base = range_base(limit);
+    const uint64_t nsegments = (limit - start) / range_segment + 1;
+#pragma omp parallel for schedule(dynamic)
+    for (uint64_t s = 0; s < nsegments; s++) {
+        const uint64_t lo = start + s * range_segment;
+        std::vector<uint64_t> prod;
+        mobius_segment(&mu[lo - start], lo,
+                       std::min(limit - lo, range_segment - 1) + 1, base,
+                       prod);
+    }
+}
+
+void totient_range(std::vector<uint64_t> &phi, uint64_t start,
+                   uint64_t limit)
+{
+    if (start == 0)
+        throw SymEngineException("totient_range: start must be positive");
+    phi.clear();
+    if (start > limit)
+        return;
+    multiplicative_range(phi, start, limit, [](uint64_t p, unsigned e) {
+        uint64_t r = p - 1;
+        for (unsigned i = 1; i < e; i++)
+            r *= p;
+        return r;
+    });
+}
+
+void divisor_sigma_range(std::vector<uint64_t> &sigma, uint64_t start,
+                         uint64_t limit, unsigned k)
+{
+    if (start == 0)
+        throw SymEngineException(
+            "divisor_sigma_range: start must be positive");
+    sigma.clear();
+    if (start > limit)
+        return;
+    multiplicative_range(sigma, start, limit, [k](uint64_t p, unsigned e) {
+        uint64_t pk = 1;
+        for (unsigned i = 0; i < k; i++)
+            pk *= p;
+        // 1 + p**k + ... + p**(e k)
+        uint64_t r = 1;
+        for (unsigned i = 0; i < e; i++)
+            r = r * pk + 1;
+        return r;
+    });
+}
+
+// Uses M(v) = 1 - sum(M(v / d), d = 2..v), where every argument v / d is of
+// the form a / m. M is tabulated by sieving up to L ~ a**(2/3), and the
+// a / L values a / k above L are computed for k decreasing, each in
+// O(sqrt(a / k)) by grouping the d with equal v / d. This takes
+// O(a**(2/3)) time overall; L is capped to bound the memory, which only
+// costs time beyond a ~ 2e11.
 long mertens(const unsigned long a)
 {
-    long mertens = 0;
-    for (unsigned long i = 1; i <= a; ++i) {
-        mertens += mobius(*(integer(i)));
+    if (a == 0)
+        return 0;
+    const uint64_t n = a;
+    const uint64_t root = isqrt(n);
+    uint64_t L = static_cast<uint64_t>(std::cbrt(static_cast<double>(n)));
+    L = std::min<uint64_t>(L * L, 1 << 25);
+    L = std::min(std::max(L, root + 1), n);
+
+    // small[v] = M(v) for v <= L
+    std::vector<int32_t> small(L + 1);
+    {
+        std::vector<signed char> mu(L);
+        const WheelBase &base = range_base(L);
+        const uint64_t nsegments = (L - 1) / range_segment + 1;
+#pragma omp parallel for schedule(dynamic)
+        for (uint64_t s = 0; s < nsegments; s++) {
+            const uint64_t lo = 1 + s * range_segment;
+            std::vector<uint64_t> prod;
+            mobius_segment(&mu[lo - 1], lo,
+                           std::min(L + 1 - lo, range_segment), base, prod);
+        }
+        small[0] = 0;
+        for (uint64_t v = 1; v <= L; v++)
+            small[v] = small[v - 1] + mu[v - 1];
+    }
+
+    // big[k] = M(n / k) for the k <= K with n / k > L
+    const uint64_t K = n / (L + 1);
+    std::vector<long> big(K + 1);
+    for (uint64_t k = K; k >= 1; --k) {
+        const uint64_t v = n / k;
+        const uint64_t r = isqrt(v);
+        long m = 1;
+        for (uint64_t d = 2; d <= r; d++) {
+            const uint64_t w = v / d;
+            m -= w <= L ? small[w] : big[k * d];
+        }
+        // The d > r have v / d = w <= v / (r + 1) < sqrt(v)
+        uint64_t upper = v;
+        for (uint64_t w = 1; w <= v / (r + 1); w++) {
+            const uint64_t lower = std::max(v / (w + 1), r);
+            m -= static_cast<long>(upper - lower) * small[w];
+            upper = lower;
+        }
+        big[k] = m;
     }
-    return mertens;
+    return K > 0 ? big[1] : small[n];
 }
 } // SymEngine
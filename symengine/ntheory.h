@@ -76,7 +76,8 @@ RCP<const Integer> factorial(unsigned long n);
 bool divides(const Integer &a, const Integer &b);
 
 //! Factorization
-//! \param B1 is only used when `n` is factored using gmp-ecm
+//! \param B1 is the stage 1 bound of gmp-ecm, or the smallest one used by
+//! the built-in elliptic curve method when gmp-ecm is not installed
 int factor(const Ptr<RCP<const Integer>> &f, const Integer &n, double B1 = 1.0);
 
 //! Factor using trial division.
@@ -95,18 +96,43 @@ int factor_pollard_pm1_method(const Ptr<RCP<const Integer>> &f,
 int factor_pollard_rho_method(const Ptr<RCP<const Integer>> &f,
                               const Integer &n, unsigned retries = 5);
 
-//! Find prime factors of `n`
+//! Factor using Lenstra's elliptic curve method, running `curves` curves
+//! with stage 1 bound `B1` and stage 2 bound `100 * B1`, at most 1e9
+int factor_ecm_method(const Ptr<RCP<const Integer>> &f, const Integer &n,
+                      unsigned B1 = 2000, unsigned curves = 100);
+
+//! Factor using the self-initialising quadratic sieve
+//! \return 1 if a non-trivial factor is found, otherwise 0.
+int factor_quadratic_sieve_method(const Ptr<RCP<const Integer>> &f,
+                                  const Integer &n);
+
+//! Find prime factors of `n`. Throws SymEngineException when a composite
+//! factor cannot be split by ECM with bounds up to 1e7.
 void prime_factors(std::vector<RCP<const Integer>> &primes, const Integer &n);
 //! Find multiplicities of prime factors of `n`
 void prime_factor_multiplicities(map_integer_uint &primes, const Integer &n);
+//! Sets result[i] to 2 if n[i] is prime and to 0 otherwise, by an exact
+//! Baillie-PSW test that makes no GMP calls
+void probab_prime_p_batch(std::vector<int> &result,
+                          const std::vector<uint64_t> &n);
+//! Sets result[i] = probab_prime_p(|n[i]|, reps), in parallel. The integers
+//! that fit in a word get the exact test above.
+void probab_prime_p_batch(std::vector<int> &result, const vec_integer_class &n,
+                          unsigned reps = 25);
+//! Finds the prime factors of each of `n`, as prime_factors does. Those of
+//! n[i] are primes[offsets[i]] to primes[offsets[i + 1] - 1], in increasing
+//! order. The trial division is shared through a remainder tree.
+void prime_factors_batch(vec_integer_class &primes,
+                         std::vector<size_t> &offsets,
+                         const vec_integer_class &n);
 // Sieve class stores all the primes upto a limit. When a prime or a list of
 // prime
 // is requested, if the prime is not there in the sieve, it is extended to hold
 // that
-// prime. The implementation is a very basic Eratosthenes sieve, but the code
-// should
-// be quite optimized. For limit=1e8, it is about 20x slower than the
-// `primesieve` library (1206ms vs 55.63ms).
+// prime. The implementation is a segmented Eratosthenes sieve that stores one
+// bit for each integer coprime to 30, and sieves the segments in parallel
+// when OpenMP is enabled. Ranges of 64-bit integers can be sieved or counted
+// without being stored.
 class Sieve
 {
 
@@ -122,7 +148,16 @@ public:
     // be empty on input and it will be filled with the primes.
     //! \param primes: holds all primes up to the `limit` (including).
     static void generate_primes(std::vector<unsigned> &primes, unsigned limit);
-    // Clear the array of primes stored
+    //! Appends the primes in [start, limit] to `primes`. They are not kept
+    //! in the sieve, but the base primes up to sqrt(limit) are, until
+    //! clear() is called. Windows much narrower than sqrt(limit) are tested
+    //! one integer at a time instead.
+    static void generate_primes(std::vector<uint64_t> &primes, uint64_t start,
+                                uint64_t limit);
+    //! \return the number of primes in [start, limit]
+    static uint64_t count_primes(uint64_t start, uint64_t limit);
+    // Clear the array of primes stored and the base primes of the 64-bit
+    // functions
     static void clear();
     // Set the sieve size in kilobytes. Set it to L1d cache size for best
     // performance.
@@ -185,6 +220,14 @@ void nthroot_mod_list(std::vector<RCP<const Integer>> &roots,
 bool nthroot_mod(const Ptr<RCP<const Integer>> &root,
                  const RCP<const Integer> &a, const RCP<const Integer> &n,
                  const RCP<const Integer> &m);
+//! Smallest x >= 0 with g**x == a mod n. Return false if none exists.
+bool discrete_log(const Ptr<RCP<const Integer>> &x, const Integer &a,
+                  const Integer &g, const Integer &n);
+//! Sets x[i] to the smallest x >= 0 with g**x == a[i] mod n, or to -1 if
+//! none exists. The order of g and the baby-step tables are shared by all
+//! the targets.
+void discrete_log_batch(vec_integer_class &x, const vec_integer_class &a,
+                        const integer_class &g, const integer_class &n);
 //! A solution to x**s == a**r mod m where b = r / s. Return false if none
 //! exists.
 bool powermod(const Ptr<RCP<const Integer>> &powm, const RCP<const Integer> &a,
@@ -212,5 +255,17 @@ int mobius(const Integer &a);
 // Mertens Function
 // mertens(n) -> Sum of mobius(i) for i from 1 to n
 long mertens(const unsigned long a);
+//! Sets mu[i - start] = mobius(i) for i in [start, limit], where start > 0.
+//! This and the range functions below sieve with the base primes up to
+//! sqrt(limit) that Sieve keeps for its 64-bit functions.
+void mobius_range(std::vector<int> &mu, uint64_t start, uint64_t limit);
+//! Sets phi[i - start] to Euler's totient of i for i in [start, limit],
+//! where start > 0
+void totient_range(std::vector<uint64_t> &phi, uint64_t start,
+                   uint64_t limit);
+//! Sets sigma[i - start] to the sum of d**k over the divisors d of i, for i
+//! in [start, limit], where start > 0. The sums are taken modulo 2**64.
+void divisor_sigma_range(std::vector<uint64_t> &sigma, uint64_t start,
+                         uint64_t limit, unsigned k = 1);
 }
 #endif
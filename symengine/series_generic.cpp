@@ -1,6 +1,8 @@
 #include <exception>
 #include <iterator>
 #include <symengine/series_visitor.h>
+#include <symengine/add.h>
+#include <symengine/mul.h>
 #include <symengine/symengine_exception.h>
 
 using SymEngine::RCP;
@@ -76,20 +78,115 @@ int UnivariateSeries::ldegree(const UExprDict &s)
     return s.get_dict().begin()->first;
 }
 
+namespace
+{
+// Adds the product of the length `n` coefficient vectors `a` and `b` to the
+// `2n - 1` entries of `r`, using Karatsuba's algorithm above a threshold
+void karatsuba_mul(const rational_class *a, const rational_class *b,
+                   unsigned n, rational_class *r)
+{
+    if (n <= 16) {
+        for (unsigned i = 0; i < n; i++)
+            for (unsigned j = 0; j < n; j++)
+                r[i + j] += a[i] * b[j];
+        return;
+    }
+    // a = a0 + a1 * x**m, where a0 has m and a1 has h >= m coefficients
+    const unsigned m = n / 2, h = n - m;
+    std::vector<rational_class> as(h), bs(h), z0(2 * m - 1), z1(2 * h - 1),
+        z2(2 * h - 1);
+    for (unsigned i = 0; i < h; i++) {
+        as[i] = a[m + i];
+        bs[i] = b[m + i];
+        if (i < m) {
+            as[i] += a[i];
+            bs[i] += b[i];
+        }
+    }
+    karatsuba_mul(a, b, m, z0.data());
+    karatsuba_mul(a + m, b + m, h, z2.data());
+    karatsuba_mul(as.data(), bs.data(), h, z1.data());
+    for (unsigned i = 0; i < z0.size(); i++) {
+        r[i] += z0[i];
+        z1[i] -= z0[i];
+    }
+    for (unsigned i = 0; i < z2.size(); i++) {
+        r[2 * m + i] += z2[i];
+        z1[i] -= z2[i];
+    }
+    for (unsigned i = 0; i < z1.size(); i++)
+        r[m + i] += z1[i];
+}
+
+// Dense coefficients of `s` for the exponents `low, ..., low + n - 1`.
+// Returns false if a coefficient is not an Integer or a Rational.
+bool to_dense_rational(const UExprDict &s, int low, unsigned n,
+                       std::vector<rational_class> &v)
+{
+    v.assign(n, rational_class(0));
+    for (auto &it : s.get_dict()) {
+        if (it.first >= low + (int)n)
+            break;
+        const Basic &c = *it.second.get_basic();
+        rational_class &x = v[it.first - low];
+        if (is_a<Integer>(c)) {
+            x = rational_class(
+                down_cast<const Integer &>(c).as_integer_class());
+        } else if (is_a<Rational>(c)) {
+            x = down_cast<const Rational &>(c).as_rational_class();
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
 UExprDict UnivariateSeries::mul(const UExprDict &a, const UExprDict &b,
                                 unsigned prec)
 {
-    map_int_Expr p;
+    if (a.get_dict().empty() or b.get_dict().empty())
+        return UExprDict();
+    const int low = ldegree(a) + ldegree(b);
+    if (low >= (int)prec)
+        return UExprDict();
+    const unsigned n = (unsigned)((int)prec - low);
+
+    // Series with dense numeric coefficients (e.g. the expansion of a
+    // function at high precision) use the truncated Karatsuba product
+    if (n >= 32 and a.size() >= n / 4 and b.size() >= n / 4) {
+        std::vector<rational_class> va, vb;
+        if (to_dense_rational(a, ldegree(a), n, va)
+            and to_dense_rational(b, ldegree(b), n, vb)) {
+            std::vector<rational_class> r(2 * n - 1, rational_class(0));
+            karatsuba_mul(va.data(), vb.data(), n, r.data());
+            map_int_Expr p;
+            for (unsigned i = 0; i < n; i++) {
+                if (r[i] != 0)
+                    p[low + (int)i] = Expression(Rational::from_mpq(r[i]));
+            }
+            return UExprDict(p);
+        }
+    }
+
+    // Collect the terms of each coefficient and add them once, instead of
+    // canonicalizing a growing Add for every product
+    std::map<int, vec_basic> terms;
     for (auto &it1 : a.get_dict()) {
         for (auto &it2 : b.get_dict()) {
             int exp = it1.first + it2.first;
             if (exp < (int)prec) {
-                p[exp] += it1.second * it2.second;
+                terms[exp].push_back(SymEngine::mul(it1.second.get_basic(),
+                                                    it2.second.get_basic()));
             } else {
                 break;
             }
         }
     }
+    map_int_Expr p;
+    for (auto &it : terms) {
+        p[it.first] = Expression(SymEngine::add(it.second));
+    }
     return UExprDict(p);
 }
 
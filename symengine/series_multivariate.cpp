@@ -0,0 +1,455 @@
+#include <symengine/series_multivariate.h>
+#include <symengine/infinity.h>
+#include <symengine/nan.h>
+#include <symengine/series_generic.h>
+#include <symengine/visitor.h>
+
+namespace SymEngine
+{
+
+namespace
+{
+int total_degree(const vec_int &v)
+{
+    int d = 0;
+    for (int e : v)
+        d += e;
+    return d;
+}
+
+// Monomials of total degree below `base` packed into one word as the digits
+// of a number in radix `base`. Adding two packed monomials multiplies them as
+// long as the total degree of the product stays below `base`.
+struct PackedMonomial {
+    typedef uint64_t key_type;
+    typedef std::hash<uint64_t> hash_type;
+    unsigned n;
+    uint64_t base;
+
+    static bool fits(unsigned n, unsigned base)
+    {
+        uint64_t m = 1;
+        for (unsigned i = 0; i < n; i++) {
+            if (m > std::numeric_limits<uint64_t>::max() / base)
+                return false;
+            m *= base;
+        }
+        return true;
+    }
+    key_type encode(const vec_int &v) const
+    {
+        key_type k = 0;
+        for (unsigned i = n; i-- > 0;)
+            k = k * base + static_cast<uint64_t>(v[i]);
+        return k;
+    }
+    vec_int decode(key_type k) const
+    {
+        vec_int v(n);
+        for (unsigned i = 0; i < n; i++) {
+            v[i] = static_cast<int>(k % base);
+            k /= base;
+        }
+        return v;
+    }
+    key_type combine(key_type a, key_type b) const
+    {
+        return a + b;
+    }
+};
+
+// Fallback for too many variables or a too high precision to pack
+struct VecMonomial {
+    typedef vec_int key_type;
+    typedef vec_hash<vec_int> hash_type;
+    unsigned n;
+
+    const key_type &encode(const vec_int &v) const
+    {
+        return v;
+    }
+    const vec_int &decode(const key_type &k) const
+    {
+        return k;
+    }
+    key_type combine(const key_type &a, const key_type &b) const
+    {
+        key_type c(n);
+        for (unsigned i = 0; i < n; i++)
+            c[i] = a[i] + b[i];
+        return c;
+    }
+};
+
+template <typename Monomial>
+MExprDict truncated_mul(const MExprDict &a, const MExprDict &b, unsigned prec,
+                        const Monomial &m)
+{
+    typedef typename Monomial::key_type Key;
+    typedef std::vector<std::vector<std::pair<Key, RCP<const Basic>>>> Buckets;
+
+    // Grouping the terms by total degree lets the loops below skip every
+    // pair whose product would be truncated.
+    auto by_degree = [&](const MExprDict &p) {
+        Buckets r(prec);
+        for (const auto &t : p.dict_) {
+            int d = total_degree(t.first);
+            SYMENGINE_ASSERT(d >= 0)
+            if (static_cast<unsigned>(d) < prec)
+                r[d].push_back({m.encode(t.first), t.second.get_basic()});
+        }
+        return r;
+    };
+    const Buckets ba = by_degree(a), bb = by_degree(b);
+
+    std::unordered_map<Key, vec_basic, typename Monomial::hash_type> terms;
+    for (unsigned da = 0; da < prec; da++) {
+        for (unsigned db = 0; da + db < prec; db++) {
+            for (const auto &x : ba[da]) {
+                for (const auto &y : bb[db]) {
+                    terms[m.combine(x.first, y.first)].push_back(
+                        SymEngine::mul(x.second, y.second));
+                }
+            }
+        }
+    }
+
+    umap_vec_expr d;
+    for (const auto &t : terms)
+        d.insert({m.decode(t.first), Expression(SymEngine::add(t.second))});
+    return MExprDict(std::move(d), a.vec_size);
+}
+
+void add_constant(MExprDict &s, const Expression &c)
+{
+    if (c == 0)
+        return;
+    const vec_int zero_v(s.vec_size, 0);
+    auto it = s.dict_.find(zero_v);
+    if (it == s.dict_.end()) {
+        s.dict_.insert({zero_v, c});
+    } else {
+        it->second += c;
+        if (it->second == 0)
+            s.dict_.erase(it);
+    }
+}
+
+class MultivariateSeriesVisitor
+    : public BaseVisitor<MultivariateSeriesVisitor>
+{
+private:
+    MExprDict p;
+    const vec_basic &vars;
+    const unsigned prec;
+    const RCP<const Symbol> u;
+
+    MExprDict constant(const RCP<const Basic> &c) const
+    {
+        MExprDict r(numeric_cast<unsigned>(vars.size()));
+        if (prec > 0)
+            add_constant(r, Expression(c));
+        return r;
+    }
+
+public:
+    MultivariateSeriesVisitor(const vec_basic &vars_, unsigned prec_)
+        : vars(vars_), prec(prec_), u(dummy("u"))
+    {
+    }
+
+    MExprDict apply(const RCP<const Basic> &x)
+    {
+        x->accept(*this);
+        MExprDict temp(std::move(p));
+        return temp;
+    }
+
+    void bvisit(const Add &x)
+    {
+        MExprDict temp(apply(x.get_coef()));
+        for (const auto &term : x.get_dict()) {
+            MExprDict t(apply(term.first));
+            for (auto &c : t.dict_)
+                c.second *= Expression(term.second);
+            temp += t;
+        }
+        p = temp;
+    }
+
+    void bvisit(const Mul &x)
+    {
+        MExprDict temp(apply(x.get_coef()));
+        for (const auto &term : x.get_dict()) {
+            temp = MultivariateSeries::mul(
+                temp, apply(SymEngine::pow(term.first, term.second)), prec);
+        }
+        p = temp;
+    }
+
+    void bvisit(const Pow &x)
+    {
+        const RCP<const Basic> &base = x.get_base(), &exp = x.get_exp();
+        if (is_a<Integer>(*exp)
+            and down_cast<const Integer &>(*exp).is_positive()) {
+            const Integer &ii = down_cast<const Integer &>(*exp);
+            if (not mp_fits_ulong_p(ii.as_integer_class()))
+                throw SymEngineException("series power exponent size");
+            p = MultivariateSeries::pow(
+                apply(base),
+                numeric_cast<unsigned>(mp_get_ui(ii.as_integer_class())),
+                prec);
+        } else if (eq(*E, *base)) {
+            p = MultivariateSeries::compose(SymEngine::exp(u), u, apply(exp),
+                                            prec);
+        } else {
+            MExprDict e(apply(exp));
+            const vec_int zero_v(e.vec_size, 0);
+            if (e.empty() or (e.dict_.size() == 1 and e.dict_.count(zero_v))) {
+                // Constant exponent: binomial series of the base
+                p = MultivariateSeries::compose(
+                    SymEngine::pow(u, exp), u, apply(base), prec);
+            } else {
+                p = MultivariateSeries::compose(
+                    SymEngine::exp(u), u,
+                    MultivariateSeries::mul(
+                        e, MultivariateSeries::compose(SymEngine::log(u), u,
+                                                       apply(base), prec),
+                        prec),
+                    prec);
+            }
+        }
+    }
+
+    // Sin, Cos, Tan, Cot, Csc, Sec, Log, ASin, ACos, ATan, Sinh, Cosh, Tanh,
+    // ASinh, ATanh, LambertW, Gamma and the other functions of one argument
+    void bvisit(const OneArgFunction &x)
+    {
+        p = MultivariateSeries::compose(x.create(u), u, apply(x.get_arg()),
+                                        prec);
+    }
+
+    void bvisit(const Symbol &x)
+    {
+        MExprDict r(numeric_cast<unsigned>(vars.size()));
+        for (size_t i = 0; i < vars.size(); i++) {
+            if (eq(x, *vars[i])) {
+                if (prec > 1) {
+                    vec_int v(vars.size(), 0);
+                    v[i] = 1;
+                    r.dict_.insert({v, Expression(1)});
+                }
+                p = r;
+                return;
+            }
+        }
+        p = constant(x.rcp_from_this());
+    }
+
+    void bvisit(const Number &x)
+    {
+        p = constant(x.rcp_from_this());
+    }
+
+    void bvisit(const Constant &x)
+    {
+        p = constant(x.rcp_from_this());
+    }
+
+    void bvisit(const Basic &x)
+    {
+        RCP<const Basic> b = x.rcp_from_this();
+        const set_basic syms = free_symbols(x);
+        for (const auto &v : vars) {
+            if (syms.find(v) != syms.end())
+                throw NotImplementedError("Multivariate series of "
+                                          + x.__str__()
+                                          + " is not implemented.");
+        }
+        p = constant(b);
+    }
+};
+} // namespace
+
+MultivariateSeries::MultivariateSeries(const vec_basic &vars,
+                                       const MExprDict &p, unsigned prec)
+    : vars_(vars), p_(p), prec_(prec)
+{
+    SYMENGINE_ASSERT(p.vec_size == vars.size())
+}
+
+MultivariateSeries MultivariateSeries::series(const RCP<const Basic> &t,
+                                              const vec_basic &vars,
+                                              unsigned prec)
+{
+    for (const auto &v : vars) {
+        if (not is_a<Symbol>(*v))
+            throw SymEngineException("Expected a Symbol, got "
+                                     + v->__str__());
+    }
+    MultivariateSeriesVisitor visitor(vars, prec);
+    return MultivariateSeries(vars, visitor.apply(t), prec);
+}
+
+RCP<const Basic> MultivariateSeries::get_coeff(const vec_int &exps) const
+{
+    auto it = p_.dict_.find(exps);
+    if (it == p_.dict_.end())
+        return zero;
+    return it->second.get_basic();
+}
+
+RCP<const Basic> MultivariateSeries::as_basic() const
+{
+    vec_basic args;
+    for (const auto &t : p_.dict_) {
+        vec_basic factors = {t.second.get_basic()};
+        for (size_t i = 0; i < vars_.size(); i++) {
+            if (t.first[i] != 0)
+                factors.push_back(
+                    SymEngine::pow(vars_[i], integer(t.first[i])));
+        }
+        args.push_back(SymEngine::mul(factors));
+    }
+    return SymEngine::add(args);
+}
+
+bool MultivariateSeries::operator==(const MultivariateSeries &o) const
+{
+    return prec_ == o.prec_ and unified_eq(vars_, o.vars_) and p_ == o.p_;
+}
+
+static unsigned common_prec(const MultivariateSeries &a,
+                            const MultivariateSeries &b)
+{
+    if (not unified_eq(a.get_vars(), b.get_vars()))
+        throw SymEngineException("Series have different variables");
+    return std::min(a.get_prec(), b.get_prec());
+}
+
+MultivariateSeries operator+(const MultivariateSeries &a,
+                             const MultivariateSeries &b)
+{
+    const unsigned prec = common_prec(a, b);
+    MExprDict r(a.p_ + b.p_);
+    for (auto it = r.dict_.begin(); it != r.dict_.end();) {
+        if (static_cast<unsigned>(total_degree(it->first)) >= prec)
+            it = r.dict_.erase(it);
+        else
+            ++it;
+    }
+    return MultivariateSeries(a.vars_, r, prec);
+}
+
+MultivariateSeries operator-(const MultivariateSeries &a,
+                             const MultivariateSeries &b)
+{
+    return a + MultivariateSeries(b.vars_, -b.p_, b.prec_);
+}
+
+MultivariateSeries operator*(const MultivariateSeries &a,
+                             const MultivariateSeries &b)
+{
+    const unsigned prec = common_prec(a, b);
+    return MultivariateSeries(
+        a.vars_, MultivariateSeries::mul(a.p_, b.p_, prec), prec);
+}
+
+MExprDict MultivariateSeries::mul(const MExprDict &s, const MExprDict &r,
+                                  unsigned prec)
+{
+    SYMENGINE_ASSERT(s.vec_size == r.vec_size)
+    if (s.empty() or r.empty() or prec == 0)
+        return MExprDict(s.vec_size);
+    if (PackedMonomial::fits(s.vec_size, prec))
+        return truncated_mul(s, r, prec, PackedMonomial{s.vec_size, prec});
+    return truncated_mul(s, r, prec, VecMonomial{s.vec_size});
+}
+
+MExprDict MultivariateSeries::pow(const MExprDict &s, unsigned n,
+                                  unsigned prec)
+{
+    MExprDict res(s.vec_size), tmp(s);
+    if (prec == 0)
+        return res;
+    add_constant(res, Expression(1));
+    while (n > 0) {
+        if (n % 2 == 1)
+            res = mul(res, tmp, prec);
+        n >>= 1;
+        if (n > 0)
+            tmp = mul(tmp, tmp, prec);
+    }
+    return res;
+}
+
+MExprDict MultivariateSeries::compose(const RCP<const Basic> &f,
+                                      const RCP<const Symbol> &u,
+                                      const MExprDict &s, unsigned prec)
+{
+    if (prec == 0)
+        return MExprDict(s.vec_size);
+    const vec_int zero_v(s.vec_size, 0);
+    MExprDict t(s);
+    Expression c(0);
+    auto it = t.dict_.find(zero_v);
+    if (it != t.dict_.end()) {
+        c = it->second;
+        t.dict_.erase(it);
+    }
+
+    // f(c + t) = sum(a_k t**k) with the Taylor coefficients a_k of f at c.
+    // Since t has no constant term, t**k has no terms of total degree below
+    // k and the sum stops at prec. When c is zero, the a_k are those of the
+    // univariate series of f(y) in a fresh symbol y, which are numbers.
+    // Otherwise that series carries unexpanded functions of c that swell at
+    // every step, so a_k = f^(k)(c) / k! is taken from the derivatives of f.
+    const RCP<const Basic> f0 = f->subs({{u, c.get_basic()}});
+    if (is_a<Infty>(*f0) or is_a<NaN>(*f0))
+        throw SymEngineException(f0->__str__()
+                                 + " is not analytic in the series");
+    const unsigned n = t.empty() ? 1 : prec;
+    std::vector<Expression> coeffs(1, Expression(f0));
+    if (n > 1 and c == 0) {
+        std::string name = "y";
+        while (has_symbol(*f, *symbol(name)))
+            name += "_";
+        const UExprDict a
+            = UnivariateSeries::series(f->subs({{u, symbol(name)}}), name, n)
+                  ->get_poly();
+        coeffs.assign(n, Expression(0));
+        for (const auto &term : a.dict_) {
+            if (term.first < 0 or is_a<Infty>(*term.second.get_basic())
+                or is_a<NaN>(*term.second.get_basic()))
+                throw SymEngineException(f0->__str__()
+                                         + " is not analytic in the series");
+            if (static_cast<unsigned>(term.first) < n)
+                coeffs[term.first] = term.second;
+        }
+    } else if (n > 1) {
+        const map_basic_basic m({{u, c.get_basic()}});
+        RCP<const Basic> d = f;
+        integer_class fact(1);
+        for (unsigned k = 1; k < n; k++) {
+            d = d->diff(u);
+            fact *= k;
+            RCP<const Basic> a = div(d->subs(m), integer(fact));
+            if (is_a<Infty>(*a) or is_a<NaN>(*a))
+                throw SymEngineException(f0->__str__()
+                                         + " is not analytic in the series");
+            coeffs.push_back(Expression(a));
+        }
+    }
+
+    // Horner's scheme. The partial sum at step k is later multiplied by
+    // t**k, so only its terms of total degree below prec - k are needed.
+    MExprDict r(s.vec_size);
+    add_constant(r, coeffs[n - 1]);
+    for (unsigned k = n - 1; k-- > 0;) {
+        r = mul(r, t, prec - k);
+        add_constant(r, coeffs[k]);
+    }
+    return r;
+}
+
+} // SymEngine
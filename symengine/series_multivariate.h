@@ -0,0 +1,77 @@
+/**
+ *  \file series_multivariate.h
+ *  Class for multivariate series truncated in total degree.
+ *
+ **/
+#ifndef SYMENGINE_SERIES_MULTIVARIATE_H
+#define SYMENGINE_SERIES_MULTIVARIATE_H
+
+#include <symengine/polys/msymenginepoly.h>
+
+namespace SymEngine
+{
+//! MultivariateSeries Class
+class MultivariateSeries
+{
+    // MultivariateSeries 1 + x*y + 2*y**2 + O(|x, y|**3) has vars_ = {x, y},
+    // prec_ = 3 and p_ = {{0, 0}: 1, {1, 1}: 1, {0, 2}: 2}. All terms of
+    // total degree prec_ or higher are dropped.
+private:
+    vec_basic vars_;
+    MExprDict p_;
+    unsigned prec_;
+
+public:
+    MultivariateSeries(const vec_basic &vars, const MExprDict &p,
+                       unsigned prec);
+
+    //! Expands `t` around the origin of `vars`, which must be symbols
+    static MultivariateSeries series(const RCP<const Basic> &t,
+                                     const vec_basic &vars, unsigned prec);
+
+    inline const vec_basic &get_vars() const
+    {
+        return vars_;
+    }
+    inline const MExprDict &get_poly() const
+    {
+        return p_;
+    }
+    inline unsigned get_prec() const
+    {
+        return prec_;
+    }
+    //! \return the coefficient of the monomial with exponents `exps`
+    RCP<const Basic> get_coeff(const vec_int &exps) const;
+    //! \return the truncated polynomial without the order term
+    RCP<const Basic> as_basic() const;
+    bool operator==(const MultivariateSeries &o) const;
+
+    friend MultivariateSeries operator+(const MultivariateSeries &a,
+                                        const MultivariateSeries &b);
+    friend MultivariateSeries operator-(const MultivariateSeries &a,
+                                        const MultivariateSeries &b);
+    friend MultivariateSeries operator*(const MultivariateSeries &a,
+                                        const MultivariateSeries &b);
+
+    //! Product of `s` and `r` without the terms of total degree `prec` or
+    //! higher
+    static MExprDict mul(const MExprDict &s, const MExprDict &r,
+                         unsigned prec);
+    static MExprDict pow(const MExprDict &s, unsigned n, unsigned prec);
+    //! Composes the univariate function `f` of `u` with `s`. `f` must be
+    //! analytic at the constant term of `s`.
+    static MExprDict compose(const RCP<const Basic> &f,
+                             const RCP<const Symbol> &u, const MExprDict &s,
+                             unsigned prec);
+};
+
+inline MultivariateSeries multivariate_series(const RCP<const Basic> &t,
+                                              const vec_basic &vars,
+                                              unsigned prec)
+{
+    return MultivariateSeries::series(t, vars, prec);
+}
+
+} // SymEngine
+#endif
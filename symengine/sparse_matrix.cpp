@@ -2,6 +2,7 @@
 #include <symengine/add.h>
 #include <symengine/mul.h>
 #include <symengine/constants.h>
+#include <symengine/visitor.h>
 #include <symengine/symengine_exception.h>
 
 namespace SymEngine
@@ -69,18 +70,14 @@ RCP<const Basic> CSRMatrix::get(unsigned i, unsigned j) const
     unsigned row_end = p_[i + 1];
     unsigned k;
 
-    if (row_start == row_end) {
-        return zero;
-    }
-
-    while (row_start <= row_end) {
+    while (row_start < row_end) {
         k = (row_start + row_end) / 2;
         if (j_[k] == j) {
             return x_[k];
         } else if (j_[k] < j) {
             row_start = k + 1;
         } else {
-            row_end = k - 1;
+            row_end = k;
         }
     }
 
@@ -132,19 +129,86 @@ void CSRMatrix::set(unsigned i, unsigned j, const RCP<const Basic> &e)
     }
 }
 
+// Copy of `A` as a DenseMatrix, used when the sparse factorization would
+// need pivoting
+static DenseMatrix csr_to_dense(const CSRMatrix &A)
+{
+    DenseMatrix B(A.nrows(), A.ncols());
+    for (unsigned i = 0; i < A.nrows(); i++)
+        for (unsigned j = 0; j < A.ncols(); j++)
+            B.set(i, j, A.get(i, j));
+    return B;
+}
+
+// Store the CSRMatrix `A` into `result`, which is either a CSRMatrix or a
+// DenseMatrix of the same shape
+static void csr_assign(const CSRMatrix &A, MatrixBase &result)
+{
+    SYMENGINE_ASSERT(result.nrows() == A.nrows()
+                     and result.ncols() == A.ncols());
+
+    if (is_a<CSRMatrix>(result)) {
+        down_cast<CSRMatrix &>(result) = A;
+    } else if (is_a<DenseMatrix>(result)) {
+        DenseMatrix &r = down_cast<DenseMatrix &>(result);
+        for (unsigned i = 0; i < A.nrows(); i++)
+            for (unsigned j = 0; j < A.ncols(); j++)
+                r.set(i, j, A.get(i, j));
+    }
+}
+
 unsigned CSRMatrix::rank() const
 {
-    throw NotImplementedError("Not Implemented");
+    if (row_ == col_) {
+        CSRFactorization F(*this);
+        if (F.factorize_LU(*this))
+            return row_;
+    }
+    return csr_to_dense(*this).rank();
 }
 
 RCP<const Basic> CSRMatrix::det() const
 {
-    throw NotImplementedError("Not Implemented");
+    SYMENGINE_ASSERT(row_ == col_);
+
+    CSRFactorization F(*this);
+    if (F.factorize_LU(*this))
+        return F.det();
+    return csr_to_dense(*this).det();
 }
 
 void CSRMatrix::inv(MatrixBase &result) const
 {
-    throw NotImplementedError("Not Implemented");
+    SYMENGINE_ASSERT(row_ == col_ and result.nrows() == row_
+                     and result.ncols() == col_);
+
+    DenseMatrix B(row_, col_);
+    CSRFactorization F(*this);
+    if (F.factorize_LU(*this)) {
+        DenseMatrix I(row_, col_);
+        eye(I);
+        F.solve(I, B);
+    } else {
+        csr_to_dense(*this).inv(B);
+    }
+
+    if (is_a<DenseMatrix>(result)) {
+        down_cast<DenseMatrix &>(result) = B;
+    } else if (is_a<CSRMatrix>(result)) {
+        std::vector<unsigned> p(row_ + 1, 0), j;
+        vec_basic x;
+        for (unsigned i = 0; i < row_; i++) {
+            for (unsigned k = 0; k < col_; k++) {
+                if (neq(*B.get(i, k), *zero)) {
+                    j.push_back(k);
+                    x.push_back(B.get(i, k));
+                }
+            }
+            p[i + 1] = numeric_cast<unsigned>(j.size());
+        }
+        down_cast<CSRMatrix &>(result) = CSRMatrix(
+            row_, col_, std::move(p), std::move(j), std::move(x));
+    }
 }
 
 void CSRMatrix::add_matrix(const MatrixBase &other, MatrixBase &result) const
@@ -154,7 +218,22 @@ void CSRMatrix::add_matrix(const MatrixBase &other, MatrixBase &result) const
 
 void CSRMatrix::mul_matrix(const MatrixBase &other, MatrixBase &result) const
 {
-    throw NotImplementedError("Not Implemented");
+    SYMENGINE_ASSERT(row_ == result.nrows()
+                     and other.ncols() == result.ncols());
+
+    if (is_a<CSRMatrix>(other) and is_a<CSRMatrix>(result)) {
+        const CSRMatrix &o = down_cast<const CSRMatrix &>(other);
+        CSRMatrix C(row_, o.col_);
+        csr_matmat_pass1(*this, o, C);
+        csr_matmat_pass2(*this, o, C);
+        down_cast<CSRMatrix &>(result) = std::move(C);
+    } else if (is_a<DenseMatrix>(other) and is_a<DenseMatrix>(result)) {
+        const DenseMatrix &o = down_cast<const DenseMatrix &>(other);
+        DenseMatrix &r = down_cast<DenseMatrix &>(result);
+        csr_mul_dense(*this, o, r);
+    } else {
+        throw NotImplementedError("Not Implemented");
+    }
 }
 
 // Add a scalar
@@ -184,34 +263,62 @@ void CSRMatrix::submatrix(MatrixBase &result, unsigned row_start,
     throw NotImplementedError("Not Implemented");
 }
 
-// LU factorization
+// LU factorization without pivoting
 void CSRMatrix::LU(MatrixBase &L, MatrixBase &U) const
 {
-    throw NotImplementedError("Not Implemented");
+    SYMENGINE_ASSERT(row_ == col_);
+
+    CSRFactorization F(*this, false);
+    if (not F.factorize_LU(*this))
+        throw SymEngineException("Zero pivot, LU needs pivoting");
+    CSRMatrix L_, U_;
+    F.get_LU(L_, U_);
+    csr_assign(L_, L);
+    csr_assign(U_, U);
 }
 
 // LDL factorization
 void CSRMatrix::LDL(MatrixBase &L, MatrixBase &D) const
 {
-    throw NotImplementedError("Not Implemented");
+    SYMENGINE_ASSERT(row_ == col_);
+
+    CSRFactorization F(*this, false);
+    if (not F.factorize_LDL(*this))
+        throw SymEngineException("Zero pivot, LDL needs pivoting");
+    CSRMatrix L_, D_;
+    F.get_LDL(L_, D_);
+    csr_assign(L_, L);
+    csr_assign(D_, D);
 }
 
 // Solve Ax = b using LU factorization
 void CSRMatrix::LU_solve(const MatrixBase &b, MatrixBase &x) const
 {
-    throw NotImplementedError("Not Implemented");
+    SYMENGINE_ASSERT(row_ == col_);
+
+    if (is_a<DenseMatrix>(b) and is_a<DenseMatrix>(x)) {
+        const DenseMatrix &b_ = down_cast<const DenseMatrix &>(b);
+        DenseMatrix &x_ = down_cast<DenseMatrix &>(x);
+        CSRFactorization F(*this);
+        if (F.factorize_LU(*this))
+            F.solve(b_, x_);
+        else
+            pivoted_LU_solve(csr_to_dense(*this), b_, x_);
+    }
 }
 
 // Fraction free LU factorization
 void CSRMatrix::FFLU(MatrixBase &LU) const
 {
-    throw NotImplementedError("Not Implemented");
+    if (is_a<DenseMatrix>(LU))
+        csr_to_dense(*this).FFLU(LU);
 }
 
 // Fraction free LDU factorization
 void CSRMatrix::FFLDU(MatrixBase &L, MatrixBase &D, MatrixBase &U) const
 {
-    throw NotImplementedError("Not Implemented");
+    if (is_a<DenseMatrix>(L) and is_a<DenseMatrix>(D) and is_a<DenseMatrix>(U))
+        csr_to_dense(*this).FFLDU(L, D, U);
 }
 
 void CSRMatrix::csr_sum_duplicates(std::vector<unsigned> &p_,
@@ -284,7 +391,7 @@ bool CSRMatrix::csr_has_duplicates(const std::vector<unsigned> &p_,
                                    unsigned row_)
 {
     for (unsigned i = 0; i < row_; i++) {
-        for (unsigned j = p_[i]; j < p_[i + 1] - 1; j++) {
+        for (unsigned j = p_[i]; j + 1 < p_[i + 1]; j++) {
             if (j_[j] == j_[j + 1])
                 return true;
         }
@@ -297,7 +404,7 @@ bool CSRMatrix::csr_has_sorted_indices(const std::vector<unsigned> &p_,
                                        unsigned row_)
 {
     for (unsigned i = 0; i < row_; i++) {
-        for (unsigned jj = p_[i]; jj < p_[i + 1] - 1; jj++) {
+        for (unsigned jj = p_[i]; jj + 1 < p_[i + 1]; jj++) {
             if (j_[jj] > j_[jj + 1])
                 return false;
         }
@@ -368,29 +475,38 @@ CSRMatrix CSRMatrix::from_coo(unsigned row, unsigned col,
     return B;
 }
 
+// Pass 1 computes the row pointer of C = A*B. The rows are counted in
+// parallel, each thread with its own O(n) mask, followed by a prefix sum.
 void csr_matmat_pass1(const CSRMatrix &A, const CSRMatrix &B, CSRMatrix &C)
 {
-    // method that uses O(n) temp storage
-    std::vector<unsigned> mask(A.col_, -1);
-    C.p_[0] = 0;
-
-    unsigned nnz = 0;
-    for (unsigned i = 0; i < A.row_; i++) {
-        // npy_intp row_nnz = 0;
-        unsigned row_nnz = 0;
-
-        for (unsigned jj = A.p_[i]; jj < A.p_[i + 1]; jj++) {
-            unsigned j = A.j_[jj];
-            for (unsigned kk = B.p_[j]; kk < B.p_[j + 1]; kk++) {
-                unsigned k = B.j_[kk];
-                if (mask[k] != i) {
-                    mask[k] = i;
-                    row_nnz++;
+    SYMENGINE_ASSERT(A.col_ == B.row_ and C.row_ == A.row_
+                     and C.col_ == B.col_);
+
+    C.p_.assign(A.row_ + 1, 0);
+
+#pragma omp parallel
+    {
+        std::vector<unsigned> mask(B.col_, -1);
+#pragma omp for schedule(dynamic, 64)
+        for (unsigned i = 0; i < A.row_; i++) {
+            unsigned row_nnz = 0;
+            for (unsigned jj = A.p_[i]; jj < A.p_[i + 1]; jj++) {
+                unsigned j = A.j_[jj];
+                for (unsigned kk = B.p_[j]; kk < B.p_[j + 1]; kk++) {
+                    unsigned k = B.j_[kk];
+                    if (mask[k] != i) {
+                        mask[k] = i;
+                        row_nnz++;
+                    }
                 }
             }
+            C.p_[i + 1] = row_nnz;
         }
+    }
 
-        unsigned next_nnz = nnz + row_nnz;
+    unsigned nnz = 0;
+    for (unsigned i = 0; i < A.row_; i++) {
+        unsigned next_nnz = nnz + C.p_[i + 1];
 
         // Addition overflow: http://www.cplusplus.com/articles/DE18T05o/
         if (next_nnz < nnz) {
@@ -400,60 +516,86 @@ void csr_matmat_pass1(const CSRMatrix &A, const CSRMatrix &B, CSRMatrix &C)
         nnz = next_nnz;
         C.p_[i + 1] = nnz;
     }
+    C.j_.resize(nnz);
+    C.x_.resize(nnz);
 }
 
 // Pass 2 computes CSR entries for matrix C = A*B using the
-// row pointer Cp[] computed in Pass 1.
+// row pointer Cp[] computed in Pass 1. Rows are filled in parallel, every
+// entry is summed by a single Add and the column indices of each row are
+// sorted, so C is canonical. Entries that cancel are dropped and C is
+// compacted at the end.
 void csr_matmat_pass2(const CSRMatrix &A, const CSRMatrix &B, CSRMatrix &C)
 {
-    std::vector<int> next(A.col_, -1);
-    vec_basic sums(A.col_, zero);
-
-    unsigned nnz = 0;
-
-    C.p_[0] = 0;
-
-    for (unsigned i = 0; i < A.row_; i++) {
-        int head = -2;
-        unsigned length = 0;
-
-        unsigned jj_start = A.p_[i];
-        unsigned jj_end = A.p_[i + 1];
-        for (unsigned jj = jj_start; jj < jj_end; jj++) {
-            unsigned j = A.j_[jj];
-            RCP<const Basic> v = A.x_[jj];
-
-            unsigned kk_start = B.p_[j];
-            unsigned kk_end = B.p_[j + 1];
-            for (unsigned kk = kk_start; kk < kk_end; kk++) {
-                unsigned k = B.j_[kk];
-
-                sums[k] = add(sums[k], mul(v, B.x_[kk]));
-
-                if (next[k] == -1) {
-                    next[k] = head;
-                    head = k;
-                    length++;
+    SYMENGINE_ASSERT(C.p_.size() == A.row_ + 1 and C.j_.size() == C.p_[A.row_]);
+
+    std::vector<unsigned> row_nnz(A.row_);
+
+#pragma omp parallel
+    {
+        std::vector<unsigned> mask(B.col_, -1);
+        std::vector<vec_basic> sums(B.col_);
+        std::vector<unsigned> cols;
+#pragma omp for schedule(dynamic, 64)
+        for (unsigned i = 0; i < A.row_; i++) {
+            cols.clear();
+            for (unsigned jj = A.p_[i]; jj < A.p_[i + 1]; jj++) {
+                unsigned j = A.j_[jj];
+                const RCP<const Basic> &v = A.x_[jj];
+                for (unsigned kk = B.p_[j]; kk < B.p_[j + 1]; kk++) {
+                    unsigned k = B.j_[kk];
+                    sums[k].push_back(mul(v, B.x_[kk]));
+                    if (mask[k] != i) {
+                        mask[k] = i;
+                        cols.push_back(k);
+                    }
                 }
             }
+            std::sort(cols.begin(), cols.end());
+
+            unsigned nnz = C.p_[i];
+            for (unsigned k : cols) {
+                RCP<const Basic> sum = add(sums[k]);
+                sums[k].clear();
+                if (neq(*sum, *zero)) {
+                    C.j_[nnz] = k;
+                    C.x_[nnz] = sum;
+                    nnz++;
+                }
+            }
+            row_nnz[i] = nnz - C.p_[i];
         }
+    }
 
-        for (unsigned jj = 0; jj < length; jj++) {
+    unsigned nnz = 0;
+    for (unsigned i = 0; i < A.row_; i++) {
+        for (unsigned jj = C.p_[i]; jj < C.p_[i] + row_nnz[i]; jj++, nnz++) {
+            C.j_[nnz] = C.j_[jj];
+            C.x_[nnz] = C.x_[jj];
+        }
+        C.p_[i] = nnz - row_nnz[i];
+    }
+    C.p_[A.row_] = nnz;
+    C.j_.resize(nnz);
+    C.x_.resize(nnz);
+}
 
-            if (neq(*sums[head], *zero)) {
-                C.j_[nnz] = head;
-                C.x_[nnz] = sums[head];
-                nnz++;
-            }
+void csr_mul_dense(const CSRMatrix &A, const DenseMatrix &B, DenseMatrix &C)
+{
+    SYMENGINE_ASSERT(A.col_ == B.nrows() and C.nrows() == A.row_
+                     and C.ncols() == B.ncols());
 
-            unsigned temp = head;
-            head = next[head];
+    const unsigned col = B.ncols();
 
-            next[temp] = -1; // clear arrays
-            sums[temp] = zero;
+#pragma omp parallel for schedule(dynamic, 16)
+    for (unsigned i = 0; i < A.row_; i++) {
+        vec_basic terms;
+        for (unsigned c = 0; c < col; c++) {
+            terms.clear();
+            for (unsigned jj = A.p_[i]; jj < A.p_[i + 1]; jj++)
+                terms.push_back(mul(A.x_[jj], B.get(A.j_[jj], c)));
+            C.set(i, c, add(terms));
         }
-
-        C.p_[i + 1] = nnz;
     }
 }
 
@@ -474,7 +616,7 @@ void csr_diagonal(const CSRMatrix &A, DenseMatrix &D)
         diag = zero;
         unsigned jj;
 
-        while (row_start <= row_end) {
+        while (row_start < row_end) {
             jj = (row_start + row_end) / 2;
             if (A.j_[jj] == i) {
                 diag = A.x_[jj];
@@ -482,7 +624,7 @@ void csr_diagonal(const CSRMatrix &A, DenseMatrix &D)
             } else if (A.j_[jj] < i) {
                 row_start = jj + 1;
             } else {
-                row_end = jj - 1;
+                row_end = jj;
             }
         }
 
@@ -533,78 +675,366 @@ void csr_binop_csr_canonical(
     SYMENGINE_ASSERT(A.row_ == B.row_ and A.col_ == B.col_ and C.row_ == A.row_
                      and C.col_ == A.col_);
 
-    // Method that works for canonical CSR matrices
-    C.p_[0] = 0;
-    unsigned nnz = 0;
-    unsigned A_pos, B_pos, A_end, B_end;
+    // Method that works for canonical CSR matrices. Rows are merged in
+    // parallel and concatenated afterwards.
+    std::vector<std::vector<unsigned>> cols(A.row_);
+    std::vector<vec_basic> vals(A.row_);
 
+#pragma omp parallel for schedule(dynamic, 64)
     for (unsigned i = 0; i < A.row_; i++) {
-        A_pos = A.p_[i];
-        B_pos = B.p_[i];
-        A_end = A.p_[i + 1];
-        B_end = B.p_[i + 1];
+        unsigned A_pos = A.p_[i];
+        unsigned B_pos = B.p_[i];
+        unsigned A_end = A.p_[i + 1];
+        unsigned B_end = B.p_[i + 1];
+        std::vector<unsigned> &C_j = cols[i];
+        vec_basic &C_x = vals[i];
 
         // while not finished with either row
-        while (A_pos < A_end and B_pos < B_end) {
-            unsigned A_j = A.j_[A_pos];
-            unsigned B_j = B.j_[B_pos];
-
-            if (A_j == B_j) {
-                RCP<const Basic> result = bin_op(A.x_[A_pos], B.x_[B_pos]);
-                if (neq(*result, *zero)) {
-                    C.j_.push_back(A_j);
-                    C.x_.push_back(result);
-                    nnz++;
-                }
-                A_pos++;
-                B_pos++;
-            } else if (A_j < B_j) {
-                RCP<const Basic> result = bin_op(A.x_[A_pos], zero);
-                if (neq(*result, *zero)) {
-                    C.j_.push_back(A_j);
-                    C.x_.push_back(result);
-                    nnz++;
-                }
-                A_pos++;
+        while (A_pos < A_end or B_pos < B_end) {
+            unsigned j;
+            RCP<const Basic> result;
+            if (B_pos == B_end
+                or (A_pos < A_end and A.j_[A_pos] < B.j_[B_pos])) {
+                j = A.j_[A_pos];
+                result = bin_op(A.x_[A_pos++], zero);
+            } else if (A_pos == A_end or B.j_[B_pos] < A.j_[A_pos]) {
+                j = B.j_[B_pos];
+                result = bin_op(zero, B.x_[B_pos++]);
             } else {
-                // B_j < A_j
-                RCP<const Basic> result = bin_op(zero, B.x_[B_pos]);
-                if (neq(*result, *zero)) {
-                    C.j_.push_back(B_j);
-                    C.x_.push_back(result);
-                    nnz++;
-                }
-                B_pos++;
+                j = A.j_[A_pos];
+                result = bin_op(A.x_[A_pos++], B.x_[B_pos++]);
+            }
+            if (neq(*result, *zero)) {
+                C_j.push_back(j);
+                C_x.push_back(result);
             }
         }
+    }
 
-        // tail
-        while (A_pos < A_end) {
-            RCP<const Basic> result = bin_op(A.x_[A_pos], zero);
-            if (neq(*result, *zero)) {
-                C.j_.push_back(A.j_[A_pos]);
-                C.x_.push_back(result);
-                nnz++;
+    C.p_.assign(A.row_ + 1, 0);
+    for (unsigned i = 0; i < A.row_; i++)
+        C.p_[i + 1] = C.p_[i] + numeric_cast<unsigned>(cols[i].size());
+    C.j_.clear();
+    C.x_.clear();
+    C.j_.reserve(C.p_[A.row_]);
+    C.x_.reserve(C.p_[A.row_]);
+    for (unsigned i = 0; i < A.row_; i++) {
+        C.j_.insert(C.j_.end(), cols[i].begin(), cols[i].end());
+        C.x_.insert(C.x_.end(), vals[i].begin(), vals[i].end());
+    }
+}
+
+// ---------------------------- Sparse Factorization ------------------------//
+
+CSRFactorization::CSRFactorization(const CSRMatrix &A, bool reorder)
+    : n_(A.row_)
+{
+    SYMENGINE_ASSERT(A.row_ == A.col_);
+
+    // Graph of the pattern of A + A**T. Eliminating a vertex connects all of
+    // its neighbours, which are the rows of the corresponding column of L.
+    std::vector<std::set<unsigned>> adj(n_);
+    for (unsigned i = 0; i < n_; i++) {
+        for (unsigned jj = A.p_[i]; jj < A.p_[i + 1]; jj++) {
+            if (A.j_[jj] != i) {
+                adj[i].insert(A.j_[jj]);
+                adj[A.j_[jj]].insert(i);
             }
-            A_pos++;
         }
-        while (B_pos < B_end) {
-            RCP<const Basic> result = bin_op(zero, B.x_[B_pos]);
-            if (neq(*result, *zero)) {
-                C.j_.push_back(B.j_[B_pos]);
-                C.x_.push_back(result);
-                nnz++;
+    }
+
+    // Vertices ordered by degree, the one of least degree is eliminated next
+    std::set<std::pair<size_t, unsigned>> degrees;
+    if (reorder)
+        for (unsigned v = 0; v < n_; v++)
+            degrees.insert(std::make_pair(adj[v].size(), v));
+
+    perm_.resize(n_);
+    iperm_.resize(n_);
+    std::vector<std::vector<unsigned>> cols(n_);
+    for (unsigned k = 0; k < n_; k++) {
+        unsigned v = k;
+        if (reorder) {
+            v = degrees.begin()->second;
+            degrees.erase(degrees.begin());
+        }
+        perm_[k] = v;
+        iperm_[v] = k;
+        cols[k].assign(adj[v].begin(), adj[v].end());
+        for (unsigned u : adj[v]) {
+            if (reorder)
+                degrees.erase(std::make_pair(adj[u].size(), u));
+            adj[u].erase(v);
+            for (unsigned w : adj[v])
+                if (w != u)
+                    adj[u].insert(w);
+            if (reorder)
+                degrees.insert(std::make_pair(adj[u].size(), u));
+        }
+        adj[v].clear();
+    }
+
+    // Columns of L, in the permuted order, are the rows of the strictly upper
+    // part of U
+    up_.assign(n_ + 1, 0);
+    for (unsigned k = 0; k < n_; k++) {
+        for (unsigned &u : cols[k])
+            u = iperm_[u];
+        std::sort(cols[k].begin(), cols[k].end());
+        up_[k + 1] = up_[k] + numeric_cast<unsigned>(cols[k].size());
+        uj_.insert(uj_.end(), cols[k].begin(), cols[k].end());
+    }
+
+    // The rows of L are built by transposing, which keeps them sorted
+    lp_.assign(n_ + 1, 0);
+    for (unsigned j : uj_)
+        lp_[j + 1]++;
+    for (unsigned i = 0; i < n_; i++)
+        lp_[i + 1] += lp_[i];
+    std::vector<unsigned> next(lp_.begin(), lp_.end() - 1);
+    lj_.resize(uj_.size());
+    tpos_.resize(uj_.size());
+    for (unsigned k = 0; k < n_; k++) {
+        for (unsigned q = up_[k]; q < up_[k + 1]; q++) {
+            const unsigned pos = next[uj_[q]]++;
+            lj_[pos] = k;
+            tpos_[pos] = q;
+        }
+    }
+}
+
+bool CSRFactorization::factorize_LU(const CSRMatrix &A)
+{
+    return factorize(A, false);
+}
+
+bool CSRFactorization::factorize_LDL(const CSRMatrix &A)
+{
+    return factorize(A, true);
+}
+
+// Up-looking factorization, one row of L and U at a time. Every entry collects
+// its terms and is summed by a single Add once all of them are known.
+bool CSRFactorization::factorize(const CSRMatrix &A, bool symmetric)
+{
+    SYMENGINE_ASSERT(A.row_ == n_ and A.col_ == n_);
+
+    lx_.assign(lj_.size(), zero);
+    ux_.assign(uj_.size(), zero);
+    d_.assign(n_, zero);
+    std::vector<vec_basic> terms(n_);
+    std::vector<unsigned> mark(n_, n_);
+
+    // For LDL, the entries of the lower triangle of A are bucketed by the row
+    // of the lower triangle of P A P**T they land in, mirrored across the
+    // diagonal when P moves them above it: (sp, sj) is that triangle in CSR
+    // and sx gives the position of each entry in A.x_.
+    std::vector<unsigned> sp, sj, sx;
+    if (symmetric) {
+        sp.assign(n_ + 1, 0);
+        for (unsigned r = 0; r < n_; r++)
+            for (unsigned jj = A.p_[r]; jj < A.p_[r + 1]; jj++)
+                if (A.j_[jj] <= r)
+                    sp[std::max(iperm_[r], iperm_[A.j_[jj]]) + 1]++;
+        for (unsigned i = 0; i < n_; i++)
+            sp[i + 1] += sp[i];
+        std::vector<unsigned> next(sp.begin(), sp.end() - 1);
+        sj.resize(sp[n_]);
+        sx.resize(sp[n_]);
+        for (unsigned r = 0; r < n_; r++) {
+            for (unsigned jj = A.p_[r]; jj < A.p_[r + 1]; jj++) {
+                if (A.j_[jj] > r)
+                    continue;
+                const unsigned a = iperm_[r], b = iperm_[A.j_[jj]];
+                const unsigned pos = next[std::max(a, b)]++;
+                sj[pos] = std::min(a, b);
+                sx[pos] = jj;
             }
-            B_pos++;
         }
+    }
 
-        C.p_[i + 1] = nnz;
+    for (unsigned i = 0; i < n_; i++) {
+        for (unsigned q = lp_[i]; q < lp_[i + 1]; q++)
+            mark[lj_[q]] = i;
+        mark[i] = i;
+        if (not symmetric)
+            for (unsigned q = up_[i]; q < up_[i + 1]; q++)
+                mark[uj_[q]] = i;
+
+        if (symmetric) {
+            for (unsigned q = sp[i]; q < sp[i + 1]; q++) {
+                if (mark[sj[q]] != i)
+                    throw SymEngineException(
+                        "Matrix does not match the analysed sparsity pattern");
+                terms[sj[q]].push_back(A.x_[sx[q]]);
+            }
+        } else {
+            const unsigned r = perm_[i];
+            for (unsigned jj = A.p_[r]; jj < A.p_[r + 1]; jj++) {
+                const unsigned j = iperm_[A.j_[jj]];
+                if (mark[j] != i)
+                    throw SymEngineException(
+                        "Matrix does not match the analysed sparsity pattern");
+                terms[j].push_back(A.x_[jj]);
+            }
+        }
+
+        for (unsigned q = lp_[i]; q < lp_[i + 1]; q++) {
+            const unsigned k = lj_[q];
+            lx_[q] = div(add(terms[k]), d_[k]);
+            terms[k].clear();
+            if (symmetric)
+                ux_[tpos_[q]] = mul(d_[k], lx_[q]);
+            const RCP<const Basic> l = neg(lx_[q]);
+            for (unsigned p = up_[k]; p < up_[k + 1]; p++) {
+                if (symmetric and uj_[p] > i)
+                    break;
+                terms[uj_[p]].push_back(mul(l, ux_[p]));
+            }
+        }
+
+        d_[i] = add(terms[i]);
+        terms[i].clear();
+        if (eq(*d_[i], *zero))
+            return false;
+
+        if (not symmetric) {
+            for (unsigned q = up_[i]; q < up_[i + 1]; q++) {
+                ux_[q] = add(terms[uj_[q]]);
+                terms[uj_[q]].clear();
+            }
+        }
+    }
+    return true;
+}
+
+void CSRFactorization::solve(const DenseMatrix &b, DenseMatrix &x) const
+{
+    SYMENGINE_ASSERT(b.nrows() == n_ and x.nrows() == n_
+                     and b.ncols() == x.ncols());
+
+    const unsigned m = b.ncols();
+    std::vector<vec_basic> results(m);
+
+#pragma omp parallel for schedule(dynamic)
+    for (unsigned c = 0; c < m; c++) {
+        vec_basic y(n_), t;
+        for (unsigned i = 0; i < n_; i++) {
+            t.clear();
+            for (unsigned q = lp_[i]; q < lp_[i + 1]; q++)
+                t.push_back(mul(lx_[q], y[lj_[q]]));
+            y[i] = sub(b.get(perm_[i], c), add(t));
+        }
+        for (unsigned i = n_; i-- > 0;) {
+            t.clear();
+            for (unsigned q = up_[i]; q < up_[i + 1]; q++)
+                t.push_back(mul(ux_[q], y[uj_[q]]));
+            y[i] = div(sub(y[i], add(t)), d_[i]);
+        }
+        results[c] = std::move(y);
+    }
+
+    for (unsigned c = 0; c < m; c++)
+        for (unsigned i = 0; i < n_; i++)
+            x.set(perm_[i], c, results[c][i]);
+}
+
+RCP<const Basic> CSRFactorization::det() const
+{
+    return mul(d_);
+}
+
+void CSRFactorization::get_LU(CSRMatrix &L, CSRMatrix &U) const
+{
+    std::vector<unsigned> lp(n_ + 1, 0), lj, up(n_ + 1, 0), uj;
+    vec_basic lx, ux;
+    for (unsigned i = 0; i < n_; i++) {
+        for (unsigned q = lp_[i]; q < lp_[i + 1]; q++) {
+            if (neq(*lx_[q], *zero)) {
+                lj.push_back(lj_[q]);
+                lx.push_back(lx_[q]);
+            }
+        }
+        lj.push_back(i);
+        lx.push_back(one);
+        lp[i + 1] = numeric_cast<unsigned>(lj.size());
+
+        uj.push_back(i);
+        ux.push_back(d_[i]);
+        for (unsigned q = up_[i]; q < up_[i + 1]; q++) {
+            if (neq(*ux_[q], *zero)) {
+                uj.push_back(uj_[q]);
+                ux.push_back(ux_[q]);
+            }
+        }
+        up[i + 1] = numeric_cast<unsigned>(uj.size());
+    }
+    L = CSRMatrix(n_, n_, std::move(lp), std::move(lj), std::move(lx));
+    U = CSRMatrix(n_, n_, std::move(up), std::move(uj), std::move(ux));
+}
+
+void CSRFactorization::get_LDL(CSRMatrix &L, CSRMatrix &D) const
+{
+    CSRMatrix U;
+    get_LU(L, U);
+    std::vector<unsigned> p(n_ + 1), j(n_);
+    for (unsigned i = 0; i < n_; i++) {
+        p[i + 1] = i + 1;
+        j[i] = i;
+    }
+    vec_basic x = d_;
+    D = CSRMatrix(n_, n_, std::move(p), std::move(j), std::move(x));
+}
+
+// ---------------------------- Jacobian -------------------------------------//
+
+void jacobian(const DenseMatrix &A, const DenseMatrix &x, CSRMatrix &result)
+{
+    SYMENGINE_ASSERT(A.ncols() == 1);
+    SYMENGINE_ASSERT(x.ncols() == 1);
+
+    unsigned row = A.nrows(), col = x.nrows();
+    for (unsigned j = 0; j < col; j++) {
+        if (not is_a<Symbol>(*(x.get(j, 0))))
+            throw SymEngineException("'x' must contain Symbols only");
+    }
+
+    // Columns and values of the nonzero entries of each row. A row is only
+    // differentiated with respect to the symbols it contains, every other
+    // entry is a structural zero.
+    std::vector<std::vector<unsigned>> cols(row);
+    std::vector<vec_basic> vals(row);
+
+#pragma omp parallel for schedule(dynamic)
+    for (unsigned i = 0; i < row; i++) {
+        const RCP<const Basic> f = A.get(i, 0);
+        const set_basic syms = free_symbols(*f);
+        for (unsigned j = 0; j < col; j++) {
+            const RCP<const Basic> xj = x.get(j, 0);
+            if (syms.find(xj) == syms.end())
+                continue;
+            RCP<const Basic> d = f->diff(rcp_static_cast<const Symbol>(xj));
+            if (neq(*d, *zero)) {
+                cols[i].push_back(j);
+                vals[i].push_back(d);
+            }
+        }
+    }
+
+    std::vector<unsigned> p(row + 1, 0);
+    for (unsigned i = 0; i < row; i++)
+        p[i + 1] = p[i] + numeric_cast<unsigned>(cols[i].size());
+
+    std::vector<unsigned> j_;
+    vec_basic x_;
+    j_.reserve(p[row]);
+    x_.reserve(p[row]);
+    for (unsigned i = 0; i < row; i++) {
+        j_.insert(j_.end(), cols[i].begin(), cols[i].end());
+        x_.insert(x_.end(), vals[i].begin(), vals[i].end());
     }
 
-    // It's enough to check for duplicates as the column indices
-    // remain sorted after the above operations
-    if (CSRMatrix::csr_has_duplicates(C.p_, C.j_, A.row_))
-        CSRMatrix::csr_sum_duplicates(C.p_, C.j_, C.x_, A.row_);
+    result = CSRMatrix(row, col, std::move(p), std::move(j_), std::move(x_));
 }
 
 } // SymEngine
@@ -5,6 +5,7 @@
 #include <symengine/add.h>
 #include <symengine/mul.h>
 #include <symengine/functions.h>
+#include <symengine/cse.h>
 
 using SymEngine::Basic;
 using SymEngine::symbol;
@@ -23,6 +24,9 @@ using SymEngine::cse;
 using SymEngine::one;
 using SymEngine::unified_eq;
 using SymEngine::integer;
+using SymEngine::cos;
+using SymEngine::exp;
+using SymEngine::StraightLineProgram;
 
 TEST_CASE("CSE: simple", "[cse]")
 {
@@ -302,4 +306,57 @@ TEST_CASE("CSE: simple", "[cse]")
         REQUIRE(unified_eq(substs, {{x0, add(x, y)}, {x1, add(x0, z)}}));
         REQUIRE(unified_eq(reduced, {x0, add(i2, x0), x1, add(i3, x1)}));
     }
+    {
+        // Many sums sharing x, of which only the last two share y
+        vec_basic exprs, expected;
+        for (unsigned i = 0; i < 4000; i++) {
+            auto t = symbol("t" + std::to_string(i));
+            exprs.push_back(add(x, t));
+            expected.push_back(add(x, t));
+        }
+        exprs.push_back(add({x, y, z}));
+        exprs.push_back(add({x, y, w}));
+        expected.push_back(add(x0, z));
+        expected.push_back(add(x0, w));
+        vec_pair substs;
+        vec_basic reduced;
+        cse(substs, reduced, exprs);
+        REQUIRE(unified_eq(substs, {{x0, add(x, y)}}));
+        REQUIRE(unified_eq(reduced, expected));
+    }
+}
+
+TEST_CASE("CSE: straight-line program", "[cse]")
+{
+    RCP<const Basic> x = symbol("x");
+    RCP<const Basic> y = symbol("y");
+    RCP<const Basic> z = symbol("z");
+    RCP<const Basic> x0 = symbol("x0");
+    RCP<const Basic> x1 = symbol("x1");
+    RCP<const Basic> x2 = symbol("x2");
+
+    auto a = add(x, y);
+    auto b = add(sin(a), cos(a));
+    auto e1 = add(exp(b), b);
+    auto e2 = mul(add(x, z), add(y, mul(a, add(x, z))));
+    {
+        // x0 dies when x1 is assigned, so both share a register
+        StraightLineProgram p({x, y}, {e1});
+        REQUIRE(unified_eq(p.get_instructions(),
+                           {{x0, a}, {x1, add(sin(x0), cos(x0))}}));
+        REQUIRE(unified_eq(p.get_outputs(), {add(exp(x1), x1)}));
+        REQUIRE(p.get_last_use() == std::vector<unsigned>({1, 2}));
+        REQUIRE(p.get_registers() == std::vector<unsigned>({0, 0}));
+        REQUIRE(p.get_nregisters() == 1);
+    }
+    {
+        StraightLineProgram p({x, y, z}, {e1, e2});
+        REQUIRE(unified_eq(p.get_instructions(),
+                           {{x0, a},
+                            {x1, add(sin(x0), cos(x0))},
+                            {x2, add(x, z)}}));
+        REQUIRE(p.get_last_use() == std::vector<unsigned>({3, 3, 3}));
+        REQUIRE(p.get_registers() == std::vector<unsigned>({0, 1, 2}));
+        REQUIRE(p.get_nregisters() == 3);
+    }
 }
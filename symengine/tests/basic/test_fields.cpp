@@ -573,6 +573,134 @@ TEST_CASE("GaloisFieldDict pow_mod : Basic", "[basic]")
     REQUIRE(h == (d1.gf_pow(3) % d2));
 }
 
+TEST_CASE("GaloisFieldDict word-size moduli : Basic", "[basic]")
+{
+    // Coefficients modulo 65537 are reduced by Barrett's method, and modulo
+    // 2**61 - 1 with 128-bit products. Products are checked against the
+    // arbitrary precision path modulo p**2, which is too large for a word.
+    for (const integer_class &p : {65537_z, 2305843009213693951_z}) {
+        std::vector<integer_class> va, vb;
+        integer_class s = 12345_z;
+        for (unsigned i = 0; i < 40; i++) {
+            s = (s * s + 7) % (p * p);
+            va.push_back(s);
+            s = (s * s + 7) % (p * p);
+            vb.push_back(s);
+        }
+        va.resize(35);
+        GaloisFieldDict a = GaloisFieldDict::from_vec(va, p);
+        GaloisFieldDict b = GaloisFieldDict::from_vec(vb, p);
+        GaloisFieldDict c = a * b;
+        GaloisFieldDict C = GaloisFieldDict::from_vec(va, p * p)
+                            * GaloisFieldDict::from_vec(vb, p * p);
+        REQUIRE(c == GaloisFieldDict::from_vec(C.get_dict(), p));
+
+        REQUIRE((c / b == a));
+        REQUIRE((c % a).empty());
+        GaloisFieldDict q, r;
+        (c + b).gf_div(a, outArg(q), outArg(r));
+        REQUIRE(r.degree() < a.degree());
+        REQUIRE((q * a + r == c + b));
+
+        integer_class lc;
+        GaloisFieldDict monic;
+        a.gf_monic(lc, outArg(monic));
+        REQUIRE(a.gf_gcd(b).is_one());
+        REQUIRE(c.gf_gcd(a * a) == monic);
+        REQUIRE((b.gf_pow_mod(a, 7) == a.gf_pow(7) % b));
+    }
+}
+
+TEST_CASE("GaloisFieldDict word-size moduli : Large", "[basic]")
+{
+    // Degrees above the thresholds of the Karatsuba and NTT products, Newton
+    // division and the half-gcd
+    for (const integer_class &p : {65537_z, 2305843009213693951_z}) {
+        std::vector<integer_class> v[4];
+        const unsigned len[4] = {2600, 2300, 150, 900};
+        integer_class s = 12345_z;
+        for (unsigned k = 0; k < 4; k++) {
+            for (unsigned i = 0; i < len[k]; i++) {
+                s = (s * 6364136223846793005_z + 1442695040888963407_z)
+                    % (p * p);
+                v[k].push_back(s);
+            }
+        }
+        const std::vector<integer_class> w(v[0].begin(), v[0].begin() + 1000);
+        for (unsigned k = 1; k < 3; k++) {
+            const std::vector<integer_class> u(
+                v[k].begin(), v[k].begin() + std::min(len[k], 700u));
+            GaloisFieldDict c = GaloisFieldDict::from_vec(w, p)
+                                * GaloisFieldDict::from_vec(u, p);
+            GaloisFieldDict C = GaloisFieldDict::from_vec(w, p * p)
+                                * GaloisFieldDict::from_vec(u, p * p);
+            REQUIRE(c == GaloisFieldDict::from_vec(C.get_dict(), p));
+        }
+
+        GaloisFieldDict a = GaloisFieldDict::from_vec(v[0], p);
+        GaloisFieldDict b = GaloisFieldDict::from_vec(v[1], p);
+        GaloisFieldDict g = GaloisFieldDict::from_vec(v[3], p);
+        GaloisFieldDict c = a * b;
+        REQUIRE((c / b == a));
+        REQUIRE((c % a).empty());
+        GaloisFieldDict q, r;
+        (c + g).gf_div(b, outArg(q), outArg(r));
+        REQUIRE((q == a));
+        REQUIRE((r == g));
+        (c + b).gf_div(g, outArg(q), outArg(r));
+        REQUIRE(r.degree() < g.degree());
+        REQUIRE((q * g + r == c + b));
+
+        integer_class lc;
+        GaloisFieldDict monic;
+        g.gf_monic(lc, outArg(monic));
+        REQUIRE(a.gf_gcd(b).is_one());
+        REQUIRE((a * g).gf_gcd(b * g) == monic);
+
+        GaloisFieldDict h = b.gf_pow_mod(a, 1001);
+        GaloisFieldDict e = GaloisFieldDict::from_vec({1_z}, p);
+        GaloisFieldDict t = a % b;
+        for (unsigned long n = 1001; n > 0; n >>= 1) {
+            if (n & 1)
+                e = e * t % b;
+            t = t * t % b;
+        }
+        REQUIRE(h == e);
+
+        v[2].resize(20);
+        GaloisFieldDict u = GaloisFieldDict::from_vec({v[2].back()}, p);
+        for (unsigned i = 19; i-- > 0;)
+            u = (u * g + GaloisFieldDict::from_vec({v[2][i]}, p)) % b;
+        REQUIRE(b.gf_compose_mod(GaloisFieldDict::from_vec(v[2], p), g) == u);
+    }
+}
+
+TEST_CASE("GaloisFieldDict word-size moduli : Unbalanced", "[basic]")
+{
+    // The Newton division multiplies the quotient by the zero-padded
+    // inverse of the reversed divisor, cut into blocks of unequal lengths
+    const integer_class p = 2305843009213693951_z;
+    std::vector<integer_class> v, r(1000, 0_z);
+    integer_class s = 12345_z;
+    for (unsigned i = 0; i < 1900; i++) {
+        s = (s * 6364136223846793005_z + 1442695040888963407_z) % p;
+        v.push_back(s);
+        r[i % 1000] = (r[i % 1000] + s) % p;
+    }
+    GaloisFieldDict a = GaloisFieldDict::from_vec(v, p);
+    GaloisFieldDict m = GaloisFieldDict({{1000, 1_z}, {0, -1_z}}, p);
+    REQUIRE((a % m == GaloisFieldDict::from_vec(r, p)));
+
+    std::vector<integer_class> w(v.begin(), v.begin() + 700);
+    w.resize(1200, 0_z);
+    w.push_back(1_z);
+    GaloisFieldDict b = GaloisFieldDict::from_vec(w, p);
+    GaloisFieldDict q, t;
+    (a * b + m).gf_div(b, outArg(q), outArg(t));
+    REQUIRE((q == a));
+    REQUIRE((t == m));
+}
+
 TEST_CASE("GaloisFieldDict distinct degree factorization : Basic", "[basic]")
 {
     std::vector<integer_class> a, mp;
@@ -145,6 +145,29 @@ TEST_CASE("Multiplication of two UExprDict with precision",
 
     REQUIRE(e == c);
     REQUIRE(f == d);
+
+    // Dense numeric series are multiplied with Karatsuba's algorithm
+    map_int_Expr ma, mb, mc, md;
+    RCP<const Symbol> y = symbol("y");
+    for (int i = 0; i < 70; i++) {
+        ma[i] = Expression(i + 1);
+        mb[i - 2] = Expression(rational(1, i + 1));
+    }
+    for (int i = 0; i < 70; i++) {
+        for (int j = 0; j < 70; j++) {
+            if (i + j - 2 < 60) {
+                mc[i + j - 2] += ma[i] * mb[j - 2];
+                md[i + j - 2] += ma[i] * mb[j - 2] * Expression(y);
+            }
+        }
+    }
+    UExprDict g(ma), h(mb);
+    REQUIRE(UnivariateSeries::mul(g, h, 60) == UExprDict(mc));
+    REQUIRE(UnivariateSeries::mul(h, g, 60) == UExprDict(mc));
+
+    // and symbolic ones by collecting the terms of each coefficient
+    h *= Expression(y);
+    REQUIRE(UnivariateSeries::mul(g, h, 60) == UExprDict(md));
 }
 
 TEST_CASE("Exponentiation of UExprDict with precision", "[UnivariateSeries]")
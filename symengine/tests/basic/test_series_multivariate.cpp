@@ -0,0 +1,132 @@
+#include "catch.hpp"
+
+#include <symengine/series_multivariate.h>
+#include <symengine/symengine_exception.h>
+
+using SymEngine::Basic;
+using SymEngine::RCP;
+using SymEngine::MultivariateSeries;
+using SymEngine::multivariate_series;
+using SymEngine::symbol;
+using SymEngine::vec_basic;
+using SymEngine::vec_int;
+using SymEngine::integer;
+using SymEngine::rational;
+using SymEngine::one;
+using SymEngine::zero;
+using SymEngine::pi;
+using SymEngine::add;
+using SymEngine::sub;
+using SymEngine::mul;
+using SymEngine::div;
+using SymEngine::pow;
+using SymEngine::exp;
+using SymEngine::log;
+using SymEngine::sin;
+using SymEngine::cos;
+using SymEngine::tan;
+using SymEngine::atan;
+using SymEngine::lambertw;
+using SymEngine::sqrt;
+using SymEngine::expand;
+using SymEngine::SymEngineException;
+
+TEST_CASE("MultivariateSeries: arithmetic", "[MultivariateSeries]")
+{
+    RCP<const Basic> x = symbol("x"), y = symbol("y"), z = symbol("z");
+    vec_basic vars = {x, y};
+
+    // (1 + x + y*z)**3 with the terms of total degree 3 and above dropped
+    RCP<const Basic> ex = pow(add(add(one, x), mul(y, z)), integer(3));
+    MultivariateSeries s = multivariate_series(ex, vars, 3);
+    REQUIRE(s.get_prec() == 3);
+    REQUIRE(eq(*s.get_coeff({0, 0}), *one));
+    REQUIRE(eq(*s.get_coeff({1, 0}), *integer(3)));
+    REQUIRE(eq(*s.get_coeff({0, 1}), *mul(integer(3), z)));
+    REQUIRE(eq(*s.get_coeff({1, 1}), *mul(integer(6), z)));
+    REQUIRE(eq(*s.get_coeff({0, 2}), *mul(integer(3), pow(z, integer(2)))));
+    REQUIRE(eq(*s.get_coeff({3, 0}), *zero));
+
+    MultivariateSeries a = multivariate_series(add(x, y), vars, 4);
+    MultivariateSeries b = multivariate_series(sub(x, y), vars, 4);
+    RCP<const Basic> r = (a * b).as_basic();
+    REQUIRE(eq(*expand(r), *sub(pow(x, integer(2)), pow(y, integer(2)))));
+    REQUIRE(eq(*(a + b).as_basic(), *mul(integer(2), x)));
+    REQUIRE(eq(*(a - b).as_basic(), *mul(integer(2), y)));
+    MultivariateSeries c
+        = multivariate_series(mul(add(x, y), sub(x, y)), vars, 4);
+    REQUIRE((a * b == c));
+
+    // Monomials that cannot be packed into a single word
+    vec_basic many;
+    RCP<const Basic> sum = zero;
+    for (unsigned i = 0; i < 12; i++) {
+        many.push_back(symbol("x" + std::to_string(i)));
+        sum = add(sum, many.back());
+    }
+    MultivariateSeries t = multivariate_series(pow(sum, integer(2)), many, 50);
+    REQUIRE(eq(*expand(t.as_basic()), *expand(pow(sum, integer(2)))));
+    t = multivariate_series(pow(sum, integer(2)), many, 2);
+    REQUIRE(eq(*t.as_basic(), *zero));
+
+    CHECK_THROWS_AS(multivariate_series(x, {add(x, y)}, 3),
+                    SymEngineException &);
+    CHECK_THROWS_AS(multivariate_series(log(x), vars, 3),
+                    SymEngineException &);
+}
+
+TEST_CASE("MultivariateSeries: functions", "[MultivariateSeries]")
+{
+    RCP<const Basic> x = symbol("x"), y = symbol("y"), z = symbol("z");
+    vec_basic vars = {x, y};
+    RCP<const Basic> s = add(x, y), s2 = pow(s, integer(2)),
+                     s3 = pow(s, integer(3));
+
+    auto check = [&](const RCP<const Basic> &ex, unsigned prec,
+                     const RCP<const Basic> &expected) {
+        MultivariateSeries r = multivariate_series(ex, vars, prec);
+        REQUIRE(eq(*expand(r.as_basic()), *expand(expected)));
+    };
+
+    check(exp(s), 3, add({one, s, div(s2, integer(2))}));
+    check(sin(s), 4, sub(s, div(s3, integer(6))));
+    check(cos(mul(x, y)), 4, one);
+    check(cos(mul(x, y)), 5,
+          sub(one, div(pow(mul(x, y), integer(2)), integer(2))));
+    check(tan(s), 4, add(s, div(s3, integer(3))));
+    check(atan(s), 4, sub(s, div(s3, integer(3))));
+    auto powers = [&](const RCP<const Basic> &b,
+                      const std::vector<RCP<const Basic>> &c) {
+        RCP<const Basic> r = zero;
+        for (size_t k = 0; k < c.size(); k++)
+            r = add(r, mul(c[k], pow(b, integer(static_cast<long>(k)))));
+        return r;
+    };
+    check(tan(s), 10,
+          powers(s, {zero, one, zero, rational(1, 3), zero, rational(2, 15),
+                     zero, rational(17, 315), zero, rational(62, 2835)}));
+    check(atan(s), 10,
+          powers(s, {zero, one, zero, rational(-1, 3), zero, rational(1, 5),
+                     zero, rational(-1, 7), zero, rational(1, 9)}));
+    check(lambertw(s), 5,
+          powers(s, {zero, one, integer(-1), rational(3, 2),
+                     rational(-8, 3)}));
+    check(atan(add(one, x)), 7,
+          powers(x, {div(pi, integer(4)), rational(1, 2), rational(-1, 4),
+                     rational(1, 12), zero, rational(-1, 40),
+                     rational(1, 48)}));
+    check(div(one, sub(one, s)), 4, add({one, s, s2, s3}));
+    check(log(add(one, s)), 3, sub(s, div(s2, integer(2))));
+    check(sqrt(add(one, s)), 3,
+          add({one, div(s, integer(2)), div(s2, integer(-8))}));
+    check(pow(add(one, x), y), 3, add(one, mul(x, y)));
+    check(add(exp(x), sin(y)), 3,
+          add({one, x, div(pow(x, integer(2)), integer(2)), y}));
+
+    // Symbols other than the variables end up in the coefficients
+    MultivariateSeries r = multivariate_series(sin(add(z, x)), vars, 3);
+    REQUIRE(eq(*r.get_coeff({0, 0}), *sin(z)));
+    REQUIRE(eq(*r.get_coeff({1, 0}), *cos(z)));
+    REQUIRE(eq(*r.get_coeff({2, 0}), *div(sin(z), integer(-2))));
+    REQUIRE(eq(*r.get_coeff({0, 1}), *zero));
+}
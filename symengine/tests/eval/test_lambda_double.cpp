@@ -2,6 +2,7 @@
 #include <chrono>
 
 #include <symengine/lambda_double.h>
+#include <symengine/lambda_matrix.h>
 #include <symengine/symengine_exception.h>
 
 #ifdef HAVE_SYMENGINE_LLVM
@@ -59,6 +60,10 @@ using SymEngine::Lt;
 using SymEngine::Le;
 using SymEngine::NotImplementedError;
 using SymEngine::SymEngineException;
+using SymEngine::DenseMatrix;
+using SymEngine::CSRMatrix;
+using SymEngine::LambdaMatrix;
+using SymEngine::LambdaLinearSolver;
 
 TEST_CASE("Evaluate to double", "[lambda_double]")
 {
@@ -120,6 +125,102 @@ TEST_CASE("Evaluate double cse", "[lambda_double_cse]")
     REQUIRE(::fabs(d[1] - 45.0) < 1e-12);
 }
 
+TEST_CASE("Evaluate matrices", "[lambda_matrix]")
+{
+    RCP<const Basic> x, y, z, r;
+    x = symbol("x");
+    y = symbol("y");
+    z = symbol("z");
+    r = pow(mul(y, z), integer(2));
+
+    DenseMatrix A(2, 3, {add(x, r), integer(0), integer(3), integer(0),
+                         mul(x, r), sin(z)});
+    LambdaMatrix<> v;
+    v.init({x, y, z}, A);
+
+    double d[6] = {-1, -1, -1, -1, -1, -1};
+    double inps[] = {1.5, 2.0, 3.0};
+    v.call(d, inps);
+    REQUIRE(::fabs(d[0] - 37.5) < 1e-12);
+    REQUIRE(d[1] == 0.0);
+    REQUIRE(::fabs(d[2] - 3.0) < 1e-12);
+    REQUIRE(d[3] == 0.0);
+    REQUIRE(::fabs(d[4] - 54.0) < 1e-12);
+    REQUIRE(::fabs(d[5] - std::sin(3.0)) < 1e-12);
+
+    // Values of a sparse matrix in the order of its nonzeros
+    CSRMatrix B(2, 3, {0, 1, 3}, {0, 1, 2}, {add(x, r), mul(x, r), sin(z)});
+    LambdaMatrix<LambdaRealDoubleVisitor> w;
+    w.init({x, y, z}, B, false);
+    w.call(d, inps);
+    REQUIRE(::fabs(d[0] - 37.5) < 1e-12);
+    REQUIRE(::fabs(d[1] - 54.0) < 1e-12);
+    REQUIRE(::fabs(d[2] - std::sin(3.0)) < 1e-12);
+#ifdef HAVE_SYMENGINE_LLVM
+    LambdaMatrix<LLVMDoubleVisitor> u;
+    u.init({x, y, z}, B);
+    double e[3];
+    u.call(e, inps);
+    for (unsigned i = 0; i < 3; i++)
+        REQUIRE(::fabs(d[i] - e[i]) < 1e-12);
+#endif
+}
+
+TEST_CASE("Solve batches of systems", "[lambda_matrix]")
+{
+    // Systems of every specialized size and one larger, with a zero leading
+    // entry so that rows are exchanged. The solution is known.
+    for (unsigned n = 1; n <= 13; n++) {
+        const unsigned nrhs = 2, batch = 11;
+        std::vector<double> A(batch * n * n), X(batch * n * nrhs),
+            B(batch * n * nrhs, 0.0);
+        for (unsigned s = 0; s < batch; s++) {
+            double *a = &A[s * n * n];
+            for (unsigned i = 0; i < n; i++)
+                for (unsigned j = 0; j < n; j++)
+                    a[i * n + j] = i == j ? s + 2.0 : 1.0 / (i + 2 * j + s + 1);
+            if (n > 1)
+                a[0] = 0.0;
+            for (unsigned i = 0; i < n * nrhs; i++)
+                X[s * n * nrhs + i] = i + s + 1.0;
+            for (unsigned i = 0; i < n; i++)
+                for (unsigned j = 0; j < nrhs; j++)
+                    for (unsigned k = 0; k < n; k++)
+                        B[(s * n + i) * nrhs + j]
+                            += a[i * n + k] * X[(s * n + k) * nrhs + j];
+        }
+        SymEngine::batch_LU_solve(n, nrhs, batch, A.data(), B.data());
+        for (unsigned i = 0; i < B.size(); i++)
+            REQUIRE(::fabs(B[i] - X[i]) < 1e-9 * ::fabs(X[i]));
+    }
+
+    // x * u + v = 1, u + y * v = z
+    RCP<const Basic> x, y, z;
+    x = symbol("x");
+    y = symbol("y");
+    z = symbol("z");
+    DenseMatrix A(2, 2, {x, integer(1), integer(1), y});
+    DenseMatrix b(2, 1, {integer(1), z});
+    LambdaLinearSolver<> v;
+    v.init({x, y, z}, A, b);
+    double inps[] = {0.0, 2.0, 3.0, 2.0, 3.0, 4.0};
+    double d[4];
+    v.call(d, inps, 2);
+    REQUIRE(::fabs(d[0] - 1.0) < 1e-12);
+    REQUIRE(::fabs(d[1] - 1.0) < 1e-12);
+    REQUIRE(::fabs(d[2] + 0.2) < 1e-12);
+    REQUIRE(::fabs(d[3] - 1.4) < 1e-12);
+#ifdef HAVE_SYMENGINE_LLVM
+    LambdaLinearSolver<LLVMDoubleVisitor> u;
+    u.init({x, y, z}, A, b);
+    double e[4];
+    u.call(e, inps, 2);
+    v.call(d, inps, 2);
+    for (unsigned i = 0; i < 4; i++)
+        REQUIRE(::fabs(d[i] - e[i]) < 1e-12);
+#endif
+}
+
 TEST_CASE("Evaluate to std::complex<double>", "[lambda_complex_double]")
 {
     RCP<const Basic> x, y, z, r;
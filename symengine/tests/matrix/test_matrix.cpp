@@ -4,6 +4,9 @@
 #include <symengine/matrix.h>
 #include <symengine/add.h>
 #include <symengine/pow.h>
+#include <symengine/real_double.h>
+#include <symengine/polys/uintpoly.h>
+#include <symengine/polys/msymenginepoly.h>
 #include <symengine/symengine_exception.h>
 
 using SymEngine::print_stack_on_segfault;
@@ -29,6 +32,18 @@ using SymEngine::eigen_values;
 using SymEngine::finiteset;
 using SymEngine::one;
 using SymEngine::mul;
+using SymEngine::map_basic_basic;
+using SymEngine::rational;
+using SymEngine::real_double;
+using SymEngine::RealDouble;
+using SymEngine::down_cast;
+using SymEngine::expand;
+using SymEngine::set_basic;
+using SymEngine::UIntPoly;
+using SymEngine::MIntPoly;
+using SymEngine::PivotStrategy;
+using SymEngine::ZeroTest;
+using SymEngine::pow;
 
 TEST_CASE("test_get_set(): matrices", "[matrices]")
 {
@@ -222,6 +237,63 @@ TEST_CASE("test_dense_dense_multiplication(): matrices", "[matrices]")
                                     add(add(mul(symbol("u"), symbol("x")),
                                             mul(symbol("v"), symbol("y"))),
                                         mul(symbol("w"), symbol("z")))}));
+
+    // Larger than one tile, with numeric and symbolic entries mixed
+    const unsigned n = 40, m = 35;
+    A = DenseMatrix(n, m);
+    B = DenseMatrix(m, n);
+    for (unsigned i = 0; i < n; i++) {
+        for (unsigned j = 0; j < m; j++) {
+            RCP<const Basic> a
+                = integer(static_cast<long>(i) - static_cast<long>(j));
+            RCP<const Basic> b = symbol("x" + std::to_string((i + j) % 5));
+            A.set(i, j, (i + j) % 3 == 0 ? b : a);
+            B.set(j, i, (i * j) % 4 == 0 ? a : b);
+        }
+    }
+    C = DenseMatrix(n, n);
+    mul_dense_dense(A, B, C);
+    for (unsigned i = 0; i < n; i += 13) {
+        for (unsigned j = 0; j < n; j += 7) {
+            RCP<const Basic> c = integer(0);
+            for (unsigned k = 0; k < m; k++)
+                c = add(c, mul(A.get(i, k), B.get(k, j)));
+            REQUIRE(eq(*C.get(i, j), *c));
+        }
+    }
+
+    // Integer and Rational products large enough for a Strassen-Winograd
+    // step, with odd dimensions. The sum over k of (i - k) * (k + j) is
+    // i * j * K + (i - j) * S1 - S2 with K, S1 and S2 the sums of 1, k and
+    // k**2.
+    const unsigned r = 129, s = 131, t = 130;
+    A = DenseMatrix(r, s);
+    B = DenseMatrix(s, t);
+    DenseMatrix Q = DenseMatrix(r, s);
+    for (unsigned i = 0; i < r; i++) {
+        for (unsigned k = 0; k < s; k++) {
+            A.set(i, k, integer((int)i - (int)k));
+            Q.set(i, k, rational((long)i - (long)k, i + 1));
+        }
+    }
+    for (unsigned k = 0; k < s; k++)
+        for (unsigned j = 0; j < t; j++)
+            B.set(k, j, integer(k + j));
+    C = DenseMatrix(r, t);
+    DenseMatrix D = DenseMatrix(r, t);
+    mul_dense_dense(A, B, C);
+    mul_dense_dense(Q, B, D);
+    const long S1 = s * (s - 1) / 2, S2 = (s - 1) * s * (2 * s - 1) / 6;
+    for (unsigned i = 0; i < r; i += 4) {
+        for (unsigned j = 0; j < t; j += 3) {
+            const long c = (long)i * j * s + ((long)i - (long)j) * S1 - S2;
+            REQUIRE(eq(*C.get(i, j), *integer(c)));
+            REQUIRE(eq(*D.get(i, j), *rational(c, i + 1)));
+        }
+    }
+    REQUIRE(eq(*C.get(r - 1, t - 1),
+               *integer((long)(r - 1) * (t - 1) * s
+                        + ((long)r - (long)t) * S1 - S2)));
 }
 
 TEST_CASE("test_mul_dense_scalar(): matrices", "[matrices]")
@@ -585,6 +657,62 @@ TEST_CASE("test_pivoted_fraction_free_gaussian_elimination(): matrices",
     REQUIRE(B == DenseMatrix(3, 3, {integer(1), integer(1), integer(1),
                                     integer(0), integer(2), integer(4),
                                     integer(0), integer(0), integer(6)}));
+
+    // A column without a pivot is skipped and the next step divides by the
+    // last pivot
+    A = DenseMatrix(3, 4, {integer(1), integer(2), integer(3), integer(1),
+                           integer(2), integer(4), integer(7), integer(3),
+                           integer(1), integer(2), integer(5), integer(4)});
+    B = DenseMatrix(3, 4);
+    pl = {};
+    pivoted_fraction_free_gaussian_elimination(A, B, pl);
+
+    REQUIRE(B == DenseMatrix(3, 4, {integer(1), integer(2), integer(3),
+                                    integer(1), integer(0), integer(0),
+                                    integer(1), integer(1), integer(0),
+                                    integer(0), integer(0), integer(1)}));
+
+    // h is zero, but not structurally
+    RCP<const Basic> x = symbol("x");
+    RCP<const Basic> h = sub(pow(add(x, one), integer(2)),
+                             add(add(pow(x, integer(2)), mul(integer(2), x)),
+                                 one));
+    REQUIRE(neq(*h, *integer(0)));
+    A = DenseMatrix(2, 2, {h, one, x, integer(2)});
+    REQUIRE(pivot(A, 0, 0) == 0);
+    REQUIRE(pivot(A, 0, 0, PivotStrategy::FirstNonzero,
+                  ZeroTest::NumericProbe)
+            == 1);
+    B = DenseMatrix(2, 2);
+    pl = {};
+    pivoted_fraction_free_gaussian_elimination(
+        A, B, pl, PivotStrategy::FirstNonzero, ZeroTest::NumericProbe);
+    REQUIRE(pl == permutelist({{1, 0}}));
+    REQUIRE(eq(*B.get(0, 0), *x));
+    A = DenseMatrix(2, 1, {h, integer(0)});
+    REQUIRE(pivot(A, 0, 0, PivotStrategy::SmallestSize,
+                  ZeroTest::NumericProbe)
+            == 2);
+
+    // h / g is zero and g is small, so that the rounding errors of h are
+    // magnified
+    RCP<const Basic> g = add(h, rational(1, 1000000000));
+    A = DenseMatrix(2, 1, {div(h, g), one});
+    REQUIRE(pivot(A, 0, 0, PivotStrategy::FirstNonzero,
+                  ZeroTest::NumericProbe)
+            == 1);
+    A = DenseMatrix(2, 1, {pow(g, minus_one), one});
+    REQUIRE(pivot(A, 0, 0, PivotStrategy::FirstNonzero,
+                  ZeroTest::NumericProbe)
+            == 0);
+
+    A = DenseMatrix(3, 3, {add(pow(x, integer(3)), add(x, one)), one, one,
+                           mul(integer(2), x), one, integer(0), integer(3),
+                           one, one});
+    REQUIRE(pivot(A, 0, 0) == 0);
+    REQUIRE(pivot(A, 0, 0, PivotStrategy::SmallestSize) == 2);
+    REQUIRE(pivot(A, 0, 0, PivotStrategy::Markowitz) == 1);
+    REQUIRE(pivot(A, 1, 0, PivotStrategy::Markowitz) == 1);
 }
 
 TEST_CASE("test_pivoted_gauss_jordan_elimination(): matrices", "[matrices]")
@@ -1299,6 +1427,34 @@ TEST_CASE("test_char_poly(): matrices", "[matrices]")
                                 add(mul(integer(-1), mul(y, z)), mul(t, x))}));
 }
 
+TEST_CASE("test_det_interpolation(): matrices", "[matrices]")
+{
+    RCP<const Basic> x = symbol("x"), y = symbol("y");
+    DenseMatrix A = DenseMatrix(2, 2, {x, y, integer(1), x});
+    RCP<const MIntPoly> p = det_interpolation(A, set_basic({x, y}));
+    REQUIRE(eq(*p->as_symbolic(), *sub(mul(x, x), y)));
+
+    A = DenseMatrix(3, 3, {add(x, integer(2)), mul(integer(3), x), integer(-1),
+                           integer(4), mul(x, x), sub(x, integer(5)),
+                           integer(0), integer(7), add(mul(x, x), integer(1))});
+    RCP<const UIntPoly> q = det_interpolation(A, x);
+    REQUIRE(eq(*q->as_symbolic(), *expand(det_berkowitz(A))));
+    p = det_interpolation(A, set_basic({x, y}));
+    REQUIRE(eq(*p->as_symbolic(), *q->as_symbolic()));
+
+    A = DenseMatrix(3, 3, {integer(1), integer(-2), integer(3), integer(4),
+                           integer(0), integer(-6), integer(7), integer(8),
+                           integer(9)});
+    DenseMatrix B = DenseMatrix(4, 1);
+    char_poly(A, B);
+    q = char_poly_interpolation(A, x);
+    for (unsigned i = 0; i < 4; i++)
+        REQUIRE(eq(*B.get(i, 0), *integer(q->get_coeff(3 - i))));
+
+    A = DenseMatrix(1, 1, {rational(1, 2)});
+    CHECK_THROWS_AS(det_interpolation(A, x), SymEngineException &);
+}
+
 TEST_CASE("test_inverse(): matrices", "[matrices]")
 {
     DenseMatrix I3 = DenseMatrix(3, 3);
@@ -1359,6 +1515,154 @@ TEST_CASE("test_inverse(): matrices", "[matrices]")
     REQUIRE(C == I2);
 }
 
+TEST_CASE("test_numeric_fast_paths(): matrices", "[matrices]")
+{
+    const unsigned n = 6;
+    DenseMatrix A(n, n), S(n, n), B(n, n), C(n, n), L(n, n), U(n, n), I(n, n);
+    eye(I);
+    RCP<const Basic> x = symbol("x");
+    for (unsigned i = 0; i < n; i++) {
+        for (unsigned j = 0; j < n; j++) {
+            A.set(i, j, integer((i * 7 + j * j * 3 + i * j) % 11 - 5));
+            // Same values, but not numeric, so the generic algorithms run
+            S.set(i, j, A.get(i, j));
+        }
+    }
+    S.set(0, 0, x);
+
+    // Integer kernels agree with the generic algorithms after x = A[0][0]
+    map_basic_basic m({{x, A.get(0, 0)}});
+    REQUIRE(eq(*det_bareis(A), *det_berkowitz(A)));
+    REQUIRE(eq(*det_bareis(A), *expand(det_bareis(S)->subs(m))));
+
+    fraction_free_gaussian_elimination(A, B);
+    fraction_free_gaussian_elimination(S, C);
+    for (unsigned i = 0; i < n * n; i++)
+        REQUIRE(eq(*B.get(i / n, i % n),
+                   *expand(C.get(i / n, i % n)->subs(m))));
+
+    // Rational LU and exact inverse
+    LU(A, L, U);
+    mul_dense_dense(L, U, B);
+    REQUIRE(B == A);
+    for (unsigned i = 0; i < n; i++)
+        REQUIRE(eq(*L.get(i, i), *one));
+
+    inverse_pivoted_LU(A, B);
+    mul_dense_dense(A, B, C);
+    REQUIRE(C == I);
+    inverse_fraction_free_LU(A, C);
+    REQUIRE(C == B);
+    inverse_gauss_jordan(A, C);
+    REQUIRE(C == B);
+
+    A.set(0, 0, rational(1, 3));
+    inverse_LU(A, B);
+    mul_dense_dense(A, B, C);
+    REQUIRE(C == I);
+
+    // A zero leading entry needs a row exchange
+    A = DenseMatrix(3, 3, {integer(0), integer(2), integer(1), integer(4),
+                           integer(1), integer(0), integer(2), integer(3),
+                           integer(5)});
+    permutelist pl;
+    B = DenseMatrix(3, 3);
+    pivoted_LU(A, B, pl);
+    REQUIRE(pl.size() == 1);
+    REQUIRE(pl[0].first == 1);
+    REQUIRE(pl[0].second == 0);
+    REQUIRE(eq(*B.get(1, 0), *integer(0)));
+    REQUIRE(eq(*B.get(2, 0), *rational(1, 2)));
+    REQUIRE(eq(*det_bareis(DenseMatrix(4, 4, {integer(0), integer(2),
+                                               integer(1), integer(0),
+                                               integer(4), integer(1),
+                                               integer(0), integer(0),
+                                               integer(2), integer(3),
+                                               integer(5), integer(0),
+                                               integer(0), integer(0),
+                                               integer(0), integer(1)})),
+               *integer(-30)));
+
+    // Doubles
+    A = DenseMatrix(4, 4, {real_double(2.0), real_double(1.0), real_double(0.5),
+                           real_double(0.0), real_double(1.0), real_double(3.0),
+                           real_double(1.0), real_double(0.5), real_double(0.5),
+                           real_double(1.0), real_double(4.0), real_double(1.0),
+                           real_double(0.0), real_double(0.5), real_double(1.0),
+                           real_double(5.0)});
+    RCP<const Basic> d = det_bareis(A);
+    REQUIRE(is_a<RealDouble>(*d));
+    REQUIRE(std::abs(down_cast<const RealDouble &>(*d).i - 85.8125) < 1e-10);
+    L = DenseMatrix(4, 4);
+    U = DenseMatrix(4, 4);
+    LU(A, L, U);
+    REQUIRE(eq(*L.get(0, 0), *one));
+    REQUIRE(eq(*U.get(1, 0), *integer(0)));
+    REQUIRE(is_a<RealDouble>(*U.get(3, 3)));
+    B = DenseMatrix(4, 4);
+    mul_dense_dense(L, U, B);
+    for (unsigned i = 0; i < 16; i++) {
+        const double b = down_cast<const RealDouble &>(*B.get(i / 4, i % 4)).i;
+        const double a = down_cast<const RealDouble &>(*A.get(i / 4, i % 4)).i;
+        REQUIRE(std::abs(a - b) < 1e-12);
+    }
+}
+
+TEST_CASE("test_multimodular(): matrices", "[matrices]")
+{
+    DenseMatrix A = DenseMatrix(
+        3, 3, {integer(2), integer(-3), integer(5), integer(7), integer(11),
+               integer(-13), integer(17), integer(19), integer(23)});
+    REQUIRE(eq(*det_multimodular(A), *det_bareis(A)));
+    A.set(1, 1, rational(11, 6));
+    REQUIRE(eq(*det_multimodular(A), *det_bareis(A)));
+
+    // The third row is the sum of the first two
+    A = DenseMatrix(3, 4, {integer(1), integer(2), integer(3), integer(4),
+                           integer(5), integer(6), integer(7), integer(8),
+                           integer(6), integer(8), integer(10), integer(12)});
+    REQUIRE(A.rank() == 2);
+    DenseMatrix N, C;
+    nullspace_multimodular(A, N);
+    REQUIRE(N.nrows() == 4);
+    REQUIRE(N.ncols() == 2);
+    C = DenseMatrix(3, 2);
+    mul_dense_dense(A, N, C);
+    for (unsigned i = 0; i < 6; i++)
+        REQUIRE(eq(*C.get(i / 2, i % 2), *integer(0)));
+
+    DenseMatrix S = DenseMatrix(3, 3);
+    A.submatrix(S, 0, 0, 2, 2);
+    REQUIRE(eq(*det_multimodular(S), *integer(0)));
+    DenseMatrix b = DenseMatrix(3, 1, {integer(1), integer(2), integer(3)});
+    DenseMatrix x = DenseMatrix(3, 1);
+    CHECK_THROWS_AS(solve_multimodular(S, b, x), SymEngineException &);
+    S = DenseMatrix(1, 1, {symbol("x")});
+    CHECK_THROWS_AS(rank_multimodular(S), SymEngineException &);
+
+    // Large enough for det() and LU_solve to use the multi-modular methods
+    const unsigned n = 20;
+    A = DenseMatrix(n, n);
+    b = DenseMatrix(n, 1);
+    unsigned seed = 1;
+    for (unsigned i = 0; i < n; i++) {
+        for (unsigned j = 0; j < n; j++) {
+            seed = (seed * 1103515245u + 12345u) % 2147483648u;
+            A.set(i, j, integer(static_cast<int>(seed % 19) - 9));
+        }
+        b.set(i, 0, rational(i + 1, 3));
+    }
+    REQUIRE(eq(*A.det(), *det_bareis(A)));
+    x = DenseMatrix(n, 1);
+    LU_solve(A, b, x);
+    C = DenseMatrix(n, 1);
+    mul_dense_dense(A, x, C);
+    REQUIRE(C == b);
+    solve_multimodular(A, b, C);
+    REQUIRE(C == x);
+    REQUIRE(rank_multimodular(A) == n);
+}
+
 TEST_CASE("test_dot(): matrices", "[matrices]")
 {
     DenseMatrix A = DenseMatrix(1, 3);
@@ -1582,6 +1886,131 @@ TEST_CASE("test_csr_binop_csr_canonical(): matrices", "[matrices]")
                             integer(6)}));
 }
 
+TEST_CASE("test_csr_mul_matrix(): matrices", "[matrices]")
+{
+    RCP<const Basic> x = symbol("x");
+    CSRMatrix A = CSRMatrix(3, 4, {0, 2, 3, 5}, {0, 3, 1, 0, 2},
+                            {integer(1), x, integer(2), integer(-1), x});
+    CSRMatrix B = CSRMatrix(4, 2, {0, 1, 2, 3, 4}, {0, 1, 1, 0},
+                            {x, integer(3), integer(1), integer(-1)});
+    CSRMatrix C = CSRMatrix(3, 2);
+
+    // Row 0 is x * e0 - x * e0, which cancels
+    A.mul_matrix(B, C);
+    REQUIRE(C.is_canonical());
+    REQUIRE(C == CSRMatrix(3, 2, {0, 0, 1, 3}, {1, 0, 1},
+                           {integer(6), mul(integer(-1), x), x}));
+
+    DenseMatrix D = DenseMatrix(4, 2, {x, integer(0), integer(0), integer(3),
+                                       integer(0), integer(1), integer(-1),
+                                       integer(0)});
+    DenseMatrix E = DenseMatrix(3, 2);
+    A.mul_matrix(D, E);
+    REQUIRE(E == DenseMatrix(3, 2, {integer(0), integer(0), integer(0),
+                                    integer(6), mul(integer(-1), x), x}));
+
+    DenseMatrix v = DenseMatrix(4, 1, {integer(1), integer(2), integer(3),
+                                       integer(4)});
+    DenseMatrix w = DenseMatrix(3, 1);
+    csr_mul_dense(A, v, w);
+    REQUIRE(w == DenseMatrix(3, 1, {add(integer(1), mul(integer(4), x)),
+                                    integer(4),
+                                    add(integer(-1), mul(integer(3), x))}));
+}
+
+TEST_CASE("test_csr_factorizations(): matrices", "[matrices]")
+{
+    // Arrow matrix, eliminating the first row and column late avoids fill
+    RCP<const Basic> x = symbol("x");
+    CSRMatrix A = CSRMatrix::from_coo(
+        5, 5, {0, 0, 0, 0, 0, 1, 2, 3, 4, 1, 2, 3, 4},
+        {0, 1, 2, 3, 4, 0, 0, 0, 0, 1, 2, 3, 4},
+        {x, integer(1), integer(1), integer(1), integer(1), integer(1),
+         integer(1), integer(1), integer(1), integer(2), integer(3), integer(4),
+         integer(5)});
+    DenseMatrix D = DenseMatrix(5, 5);
+    for (unsigned i = 0; i < 5; i++)
+        for (unsigned j = 0; j < 5; j++)
+            D.set(i, j, A.get(i, j));
+    // Pivots are rational functions of x, compare at a sample point
+    auto require_zero = [&x](const RCP<const Basic> &e) {
+        REQUIRE(eq(*expand(e->subs({{x, integer(11)}})), *integer(0)));
+    };
+
+    SymEngine::CSRFactorization F(A);
+    REQUIRE(F.get_nnz_L() == 4);
+    REQUIRE(SymEngine::CSRFactorization(A, false).get_nnz_L() == 10);
+    REQUIRE(F.factorize_LU(A));
+    require_zero(sub(F.det(), det_bareis(D)));
+    require_zero(sub(A.det(), det_bareis(D)));
+
+    DenseMatrix b = DenseMatrix(
+        5, 1, {integer(1), integer(2), integer(3), integer(4), integer(5)});
+    DenseMatrix y = DenseMatrix(5, 1), c = DenseMatrix(5, 1);
+    A.LU_solve(b, y);
+    mul_dense_dense(D, y, c);
+    for (unsigned i = 0; i < 5; i++)
+        require_zero(sub(c.get(i, 0), b.get(i, 0)));
+
+    // New values with the same pattern reuse the analysis
+    CSRMatrix A2 = A;
+    A2.set(0, 0, integer(7));
+    A2.set(3, 3, rational(1, 2));
+    D.set(0, 0, integer(7));
+    D.set(3, 3, rational(1, 2));
+    REQUIRE(F.factorize_LU(A2));
+    REQUIRE(eq(*F.det(), *det_bareis(D)));
+    CSRMatrix C = A2;
+    C.set(1, 2, integer(1));
+    CHECK_THROWS_AS(F.factorize_LU(C), SymEngineException &);
+
+    DenseMatrix L = DenseMatrix(5, 5), U = DenseMatrix(5, 5);
+    DenseMatrix P = DenseMatrix(5, 5);
+    A2.LU(L, U);
+    mul_dense_dense(L, U, P);
+    REQUIRE(P == D);
+    A2.LDL(L, U);
+    DenseMatrix Lt = DenseMatrix(5, 5);
+    L.transpose(Lt);
+    mul_dense_dense(L, U, P);
+    mul_dense_dense(P, Lt, U);
+    REQUIRE(U == D);
+
+    // LDL reads the lower triangle of A only, also where the permutation
+    // moves it above the diagonal
+    CSRMatrix T = CSRMatrix::from_coo(
+        5, 5, {0, 1, 2, 3, 4, 1, 2, 3, 4}, {0, 0, 0, 0, 0, 1, 2, 3, 4},
+        {integer(7), integer(1), integer(1), integer(1), integer(1),
+         integer(2), integer(3), rational(1, 2), integer(5)});
+    SymEngine::CSRFactorization G(T);
+    REQUIRE(G.get_nnz_L() == 4);
+    REQUIRE(G.factorize_LDL(T));
+    REQUIRE(eq(*G.det(), *det_bareis(D)));
+    G.solve(b, y);
+    mul_dense_dense(D, y, c);
+    REQUIRE(c == b);
+    REQUIRE(F.factorize_LDL(A2));
+    REQUIRE(eq(*F.det(), *det_bareis(D)));
+
+    A2.inv(P);
+    mul_dense_dense(D, P, U);
+    DenseMatrix I = DenseMatrix(5, 5);
+    eye(I);
+    REQUIRE(U == I);
+    REQUIRE(A2.rank() == 5);
+
+    // A zero pivot falls back to the dense methods
+    C = CSRMatrix(2, 2, {0, 1, 2}, {1, 0}, {integer(1), integer(1)});
+    REQUIRE(eq(*C.det(), *integer(-1)));
+    b = DenseMatrix(2, 1, {integer(3), integer(4)});
+    y = DenseMatrix(2, 1);
+    C.LU_solve(b, y);
+    REQUIRE(y == DenseMatrix(2, 1, {integer(4), integer(3)}));
+    L = DenseMatrix(2, 2);
+    U = DenseMatrix(2, 2);
+    CHECK_THROWS_AS(C.LU(L, U), SymEngineException &);
+}
+
 TEST_CASE("test_eye(): matrices", "[matrices]")
 {
     DenseMatrix A(3, 3);
@@ -1688,6 +2117,40 @@ TEST_CASE("Test Jacobian", "[matrices]")
     J = DenseMatrix(2, 2);
     sjacobian(A, X, J);
     REQUIRE(J == DenseMatrix(2, 2, {y, f, integer(0), mul(integer(2), y)}));
+
+    A = DenseMatrix(
+        4, 1, {add(x, z), mul(y, z), add(mul(z, x), add(y, t)), add(x, y)});
+    X = DenseMatrix(4, 1, {x, y, z, t});
+    J = DenseMatrix(4, 4);
+    jacobian(A, X, J);
+    CSRMatrix S;
+    jacobian(A, X, S);
+    REQUIRE(S == CSRMatrix(4, 4, {0, 2, 4, 8, 10},
+                           {0, 2, 1, 2, 0, 1, 2, 3, 0, 1},
+                           {integer(1), integer(1), z, y, z, integer(1), x,
+                            integer(1), integer(1), integer(1)}));
+    REQUIRE(S == J);
+
+    X = DenseMatrix(4, 1, {f, y, z, t});
+    CHECK_THROWS_AS(jacobian(A, X, S), SymEngineException);
+}
+
+TEST_CASE("Test Hessian", "[matrices]")
+{
+    DenseMatrix X, H;
+    RCP<const Basic> x = symbol("x"), y = symbol("y"), z = symbol("z"),
+                     f = function_symbol("f", x);
+    RCP<const Basic> e = add(mul(pow(x, integer(2)), y), mul(y, z));
+    X = DenseMatrix(3, 1, {x, y, z});
+    H = DenseMatrix(3, 3);
+    hessian(e, X, H);
+    REQUIRE(H == DenseMatrix(3, 3, {mul(integer(2), y), mul(integer(2), x),
+                                    integer(0), mul(integer(2), x), integer(0),
+                                    integer(1), integer(0), integer(1),
+                                    integer(0)}));
+
+    X = DenseMatrix(3, 1, {f, y, z});
+    CHECK_THROWS_AS(hessian(e, X, H), SymEngineException);
 }
 
 TEST_CASE("Test Diff", "[matrices]")
@@ -7,6 +7,11 @@ using SymEngine::print_stack_on_segfault;
 using SymEngine::DenseMatrix;
 using SymEngine::integer;
 using SymEngine::homogeneous_lde;
+using SymEngine::lll_reduce;
+using SymEngine::integer_class;
+using SymEngine::rational_class;
+using SymEngine::vec_integer_class;
+using SymEngine::SymEngineException;
 
 bool vec_dense_matrix_eq_perm(const std::vector<DenseMatrix> &a,
                               const std::vector<DenseMatrix> &b)
@@ -80,3 +85,71 @@ TEST_CASE("test_homogeneous_lde()", "[diophantine]")
 
     REQUIRE(vec_dense_matrix_eq_perm(basis, true_basis));
 }
+
+TEST_CASE("test_homogeneous_lde(): integer vectors", "[diophantine]")
+{
+    typedef std::vector<vec_integer_class> vecs;
+    auto sorted = [](vecs v) {
+        std::sort(v.begin(), v.end());
+        return v;
+    };
+    vecs basis;
+
+    // A dependent row does not change the solutions
+    homogeneous_lde(basis, vecs{{-1, 1, 2, -3}, {-1, 3, -2, -1},
+                                {-2, 4, 0, -4}});
+    vecs expected{{0, 1, 1, 1}, {4, 2, 1, 0}};
+    REQUIRE(sorted(basis) == expected);
+
+    basis.clear();
+    homogeneous_lde(basis, vecs{{0, 0, 0}});
+    expected = vecs{{0, 0, 1}, {0, 1, 0}, {1, 0, 0}};
+    REQUIRE(sorted(basis) == expected);
+
+    basis.clear();
+    homogeneous_lde(basis, vecs{{1, 2}, {3, -4}});
+    REQUIRE(basis.empty());
+
+    // Coefficients too large for the word arithmetic
+    integer_class m = integer_class(1) << 40;
+    basis.clear();
+    homogeneous_lde(basis, vecs{{m, m, -2 * m}});
+    expected = vecs{{0, 2, 1}, {1, 1, 1}, {2, 0, 1}};
+    REQUIRE(sorted(basis) == expected);
+
+    // 21 minimal solutions, each solving both equations
+    vecs A{{1, -2, 3, 0, -1, 2}, {2, 1, -1, -3, 1, 0}};
+    basis.clear();
+    homogeneous_lde(basis, A);
+    REQUIRE(basis.size() == 21);
+    for (const vec_integer_class &b : basis) {
+        for (const vec_integer_class &a : A) {
+            integer_class s(0);
+            for (size_t j = 0; j < a.size(); j++)
+                s += a[j] * b[j];
+            REQUIRE(s == 0);
+        }
+    }
+}
+
+TEST_CASE("test_lll_reduce()", "[diophantine]")
+{
+    typedef std::vector<vec_integer_class> vecs;
+    vecs b{{1, 1, 1}, {-1, 0, 2}, {3, 5, 6}};
+    lll_reduce(b);
+    vecs expected{{0, 1, 0}, {1, 0, 1}, {-1, 0, 2}};
+    REQUIRE(b == expected);
+
+    // The knapsack lattice of 3 a - 5 b + 7 c = 0, whose shortest vectors
+    // are the small solutions
+    b = vecs{{1, 0, 0, 3000}, {0, 1, 0, -5000}, {0, 0, 1, 7000}};
+    lll_reduce(b, rational_class(integer_class(99), integer_class(100)));
+    REQUIRE(b[0][3] == 0);
+    integer_class s = 3 * b[0][0] - 5 * b[0][1] + 7 * b[0][2];
+    REQUIRE(s == 0);
+    s = b[0][0] * b[0][0] + b[0][1] * b[0][1] + b[0][2] * b[0][2];
+    REQUIRE(s == 6);
+
+    b = vecs{{1, 2, 3}, {2, 4, 6}};
+    CHECK_THROWS_AS(lll_reduce(b), SymEngineException &);
+}
@@ -1,5 +1,6 @@
 #include "catch.hpp"
 #include <chrono>
+#include <limits>
 
 #include <symengine/ntheory.h>
 #include <symengine/rational.h>
@@ -37,8 +38,20 @@ using SymEngine::multiplicative_order;
 using SymEngine::totient;
 using SymEngine::carmichael;
 using SymEngine::mertens;
+using SymEngine::mobius_range;
+using SymEngine::totient_range;
+using SymEngine::divisor_sigma_range;
+using SymEngine::probab_prime_p_batch;
+using SymEngine::prime_factors_batch;
+using SymEngine::discrete_log;
+using SymEngine::discrete_log_batch;
 using SymEngine::integer_class;
 using SymEngine::harmonic;
+using SymEngine::rational_class;
+using SymEngine::get_num;
+using SymEngine::get_den;
+using SymEngine::mp_fdiv_r;
+using SymEngine::mp_powm;
 using SymEngine::vec_integer_class;
 using SymEngine::zero;
 using SymEngine::one;
@@ -171,6 +184,31 @@ TEST_CASE("test_fibonacci_lucas(): ntheory", "[ntheory]")
     lucas2(outArg(g), outArg(s), 10);
     REQUIRE(eq(*g, *integer(123)));
     REQUIRE(eq(*s, *integer(76)));
+
+    REQUIRE(eq(*fibonacci(0), *zero));
+    REQUIRE(eq(*lucas(0), *integer(2)));
+    fibonacci2(outArg(g), outArg(s), 0);
+    REQUIRE(eq(*g, *zero));
+    REQUIRE(eq(*s, *one));
+    lucas2(outArg(g), outArg(s), 0);
+    REQUIRE(eq(*g, *integer(2)));
+    REQUIRE(eq(*s, *minus_one));
+
+    REQUIRE(eq(*fibonacci(100),
+               *integer(integer_class("354224848179261915075"))));
+    REQUIRE(eq(*lucas(100), *integer(integer_class("792070839848372253127"))));
+    RCP<const Integer> p = integer(1000000007);
+    REQUIRE(eq(*mod(*fibonacci(5000), *p), *integer(976496506)));
+    REQUIRE(eq(*mod(*lucas(4096), *p), *integer(296947521)));
+    for (unsigned long n = 1; n < 200; n++) {
+        fibonacci2(outArg(g), outArg(s), n);
+        REQUIRE(eq(*g, *fibonacci(n)));
+        REQUIRE(eq(*s, *fibonacci(n - 1)));
+        lucas2(outArg(g), outArg(s), n);
+        REQUIRE(eq(*g, *lucas(n)));
+        REQUIRE(eq(*s, *lucas(n - 1)));
+        REQUIRE(eq(*lucas(n), *add(fibonacci(n - 1), fibonacci(n + 1))));
+    }
 }
 
 TEST_CASE("test_binomial(): ntheory", "[ntheory]")
@@ -188,6 +226,25 @@ TEST_CASE("test_binomial(): ntheory", "[ntheory]")
 
     REQUIRE(eq(*binomial(*m10, 3), *integer(-220)));
     REQUIRE(eq(*binomial(*m10, 2), *integer(55)));
+
+    REQUIRE(eq(*binomial(*i0, 0), *one));
+    REQUIRE(eq(*binomial(*integer(100), 50),
+               *integer(integer_class("100891344545564193334812497256"))));
+    REQUIRE(eq(*binomial(*integer(100000), 99990),
+               *integer(integer_class(
+                   "27544920827561470257469913571105409574990000"))));
+    integer_class n("1000000000000000000000");
+    REQUIRE(eq(*binomial(*integer(n), 5),
+               *integer(integer_class(
+                   "83333333333333333332500000000000000000002916666666666666"
+                   "66666250000000000000000000200000000000000000000"))));
+    REQUIRE(eq(*binomial(*integer(-n), 3),
+               *integer(integer_class("-1666666666666666666671666666666666666"
+                                      "66667000000000000000000000"))));
+    RCP<const Integer> p = integer(1000000007);
+    REQUIRE(eq(*mod(*binomial(*integer(2000), 1000), *p), *integer(72475738)));
+    REQUIRE(
+        eq(*mod(*binomial(*integer(100000), 3000), *p), *integer(516644401)));
 }
 
 TEST_CASE("test_factorial(): ntheory", "[ntheory]")
@@ -198,6 +255,17 @@ TEST_CASE("test_factorial(): ntheory", "[ntheory]")
     REQUIRE(eq(*factorial(0), *i1));
     REQUIRE(eq(*factorial(5), *integer(120)));
     REQUIRE(eq(*factorial(9), *integer(362880)));
+
+    REQUIRE(eq(*factorial(25),
+               *integer(integer_class("15511210043330985984000000"))));
+    RCP<const Integer> p = integer(1000000007);
+    REQUIRE(eq(*mod(*factorial(1000), *p), *integer(641419708)));
+    REQUIRE(eq(*mod(*factorial(100000), *p), *integer(457992974)));
+    RCP<const Integer> f = one;
+    for (unsigned long n = 1; n < 300; n++) {
+        f = rcp_static_cast<const Integer>(mul(f, integer(n)));
+        REQUIRE(eq(*factorial(n), *f));
+    }
 }
 
 TEST_CASE("test_factor(): ntheory", "[ntheory]")
@@ -229,6 +297,58 @@ TEST_CASE("test_factor(): ntheory", "[ntheory]")
     REQUIRE(not divides(*i1001, *i6));
     REQUIRE(factor(outArg(f), *i900) > 0);
     REQUIRE(divides(*i900, *f));
+
+    // Beyond trial division: a 64-bit semiprime, a square of a 30-digit
+    // prime and a 45-digit semiprime with balanced factors
+    integer_class p("4294967311"), q("4294967357"),
+        r("100000000000000000000000000319"), s("1000000000000000000000007"),
+        t("100000000000000000039");
+    REQUIRE(factor(outArg(f), *integer(p * q)) > 0);
+    REQUIRE((f->as_integer_class() == p or f->as_integer_class() == q));
+    REQUIRE(factor(outArg(f), *integer(r * r)) > 0);
+    REQUIRE(f->as_integer_class() == r);
+    REQUIRE(factor(outArg(f), *integer(r)) == 0);
+    REQUIRE(factor(outArg(f), *integer(s * t)) > 0);
+    REQUIRE((f->as_integer_class() == s or f->as_integer_class() == t));
+}
+
+TEST_CASE("test_factor_ecm_method(): ntheory", "[ntheory]")
+{
+    integer_class p("1000000007"), q("100000000000000000000000000319");
+    RCP<const Integer> f;
+
+    REQUIRE(factor_ecm_method(outArg(f), *integer(p * q)) > 0);
+    REQUIRE((f->as_integer_class() == p or f->as_integer_class() == q));
+    REQUIRE(factor_ecm_method(outArg(f), *integer(q), 100, 5) == 0);
+
+    CHECK_THROWS_AS(factor_ecm_method(outArg(f), *integer(5)),
+                    SymEngineException);
+}
+
+TEST_CASE("test_factor_quadratic_sieve_method(): ntheory", "[ntheory]")
+{
+    RCP<const Integer> f, n;
+    std::vector<integer_class> primes
+        = {integer_class("1000003"), integer_class("4294967311"),
+           integer_class("1000000000000000003"),
+           integer_class("100000000000000000039")};
+    for (unsigned i = 0; i < primes.size(); i++) {
+        for (unsigned j = i + 1; j < primes.size(); j++) {
+            n = integer(primes[i] * primes[j]);
+            REQUIRE(factor_quadratic_sieve_method(outArg(f), *n) > 0);
+            REQUIRE((f->as_integer_class() == primes[i]
+                     or f->as_integer_class() == primes[j]));
+        }
+    }
+    REQUIRE(factor_quadratic_sieve_method(outArg(f), *integer(1000003)) == 0);
+    REQUIRE(factor_quadratic_sieve_method(outArg(f), *integer(4096)) > 0);
+    REQUIRE(divides(*integer(4096), *f));
+    n = integer(primes[1] * primes[1] * primes[1]);
+    REQUIRE(factor_quadratic_sieve_method(outArg(f), *n) > 0);
+    REQUIRE(f->as_integer_class() == primes[1]);
+
+    CHECK_THROWS_AS(factor_quadratic_sieve_method(outArg(f), *integer(3)),
+                    SymEngineException);
 }
 
 TEST_CASE("test_factor_lehman_method(): ntheory", "[ntheory]")
@@ -364,6 +484,102 @@ TEST_CASE("test_sieve_iterator(): ntheory", "[ntheory]")
     REQUIRE(count == 9593);
 }
 
+TEST_CASE("test_sieve_range(): ntheory", "[ntheory]")
+{
+    std::vector<unsigned> v;
+    SymEngine::Sieve::generate_primes(v, 1000);
+    std::vector<uint64_t> w;
+    SymEngine::Sieve::generate_primes(w, 0, 1000);
+    REQUIRE(w.size() == v.size());
+    REQUIRE(std::equal(v.begin(), v.end(), w.begin()));
+
+    for (uint64_t start : {0, 1, 2, 6, 7, 29, 30, 31, 100}) {
+        w.clear();
+        SymEngine::Sieve::generate_primes(w, start, 1000);
+        auto it = std::lower_bound(v.begin(), v.end(), start);
+        REQUIRE(w.size() == static_cast<size_t>(v.end() - it));
+        REQUIRE(std::equal(it, v.end(), w.begin()));
+        REQUIRE(SymEngine::Sieve::count_primes(start, 1000) == w.size());
+    }
+    REQUIRE(SymEngine::Sieve::count_primes(0, 1) == 0);
+    REQUIRE(SymEngine::Sieve::count_primes(7, 5) == 0);
+    REQUIRE(SymEngine::Sieve::count_primes(0, 100000000) == 5761455);
+
+    // Primes between 10**12 and 10**12 + 1000, and just above 2**32
+    w.clear();
+    SymEngine::Sieve::generate_primes(w, 1000000000000ULL, 1000000001000ULL);
+    REQUIRE(w.size() == 37);
+    REQUIRE(w.front() == 1000000000039ULL);
+    REQUIRE(w.back() == 1000000000997ULL);
+    w.clear();
+    SymEngine::Sieve::generate_primes(w, 4294967291ULL, 4294967400ULL);
+    REQUIRE((w == std::vector<uint64_t>{4294967291ULL, 4294967311ULL,
+                                        4294967357ULL, 4294967371ULL,
+                                        4294967377ULL, 4294967387ULL,
+                                        4294967389ULL}));
+
+    // A window that is sieved, and narrower ones within it that are tested
+    // one integer at a time
+    w.clear();
+    SymEngine::Sieve::generate_primes(w, 1000000000000ULL, 1000001000000ULL);
+    REQUIRE(w.size() == 36249);
+    REQUIRE(w.back() == 1000000999999ULL);
+    REQUIRE(SymEngine::Sieve::count_primes(1000000000000ULL, 1000001000000ULL)
+            == 36249);
+    for (uint64_t lo : {1000000000000ULL, 1000000123457ULL, 1000000999000ULL}) {
+        std::vector<uint64_t> u;
+        SymEngine::Sieve::generate_primes(u, lo, lo + 1000);
+        auto it = std::lower_bound(w.begin(), w.end(), lo);
+        auto jt = std::upper_bound(w.begin(), w.end(), lo + 1000);
+        REQUIRE((std::vector<uint64_t>(it, jt) == u));
+        REQUIRE(SymEngine::Sieve::count_primes(lo, lo + 1000) == u.size());
+    }
+
+    // The base primes are kept from the first call and sieved again after
+    // clear()
+    for (int i = 0; i < 2; i++) {
+        w.clear();
+        SymEngine::Sieve::generate_primes(w, 1099511527776ULL,
+                                          1099511627776ULL);
+        REQUIRE(w.size() == 3594);
+        REQUIRE((std::vector<uint64_t>(w.end() - 3, w.end())
+                 == std::vector<uint64_t>{1099511627581ULL, 1099511627609ULL,
+                                          1099511627689ULL}));
+        SymEngine::Sieve::clear();
+    }
+}
+
+// Sieves all the base primes below 2**32, which takes seconds
+TEST_CASE("test_sieve_range_top(): ntheory", "[ntheory][.slow]")
+{
+    // The top of the range, where a segment bound one past the limit would
+    // wrap around to 0. Such a narrow window is tested one integer at a
+    // time, unless the segments are large enough to sieve it.
+    const uint64_t top = std::numeric_limits<uint64_t>::max();
+    const std::vector<uint64_t> expected
+        = {18446744073709551427ULL, 18446744073709551437ULL,
+           18446744073709551521ULL, 18446744073709551533ULL,
+           18446744073709551557ULL};
+    std::vector<uint64_t> w;
+    SymEngine::Sieve::generate_primes(w, top - 199, top);
+    REQUIRE(w == expected);
+    REQUIRE(SymEngine::Sieve::count_primes(top - 199, top) == 5);
+
+    const uint64_t width = uint64_t(1) << 26;
+    SymEngine::Sieve::set_sieve_size(4096);
+    w.clear();
+    SymEngine::Sieve::generate_primes(w, top - width, top);
+    const uint64_t count = SymEngine::Sieve::count_primes(top - width, top);
+    SymEngine::Sieve::set_sieve_size(32);
+    SymEngine::Sieve::clear();
+    REQUIRE(std::vector<uint64_t>(w.end() - 5, w.end()) == expected);
+    REQUIRE(count == w.size());
+    std::vector<int> prime;
+    SymEngine::probab_prime_p_batch(
+        prime, std::vector<uint64_t>(w.begin(), w.begin() + 1000));
+    REQUIRE(std::count(prime.begin(), prime.end(), 2) == 1000);
+}
+
 // helper function for test_primefactors
 void _test_primefactors(const RCP<const Integer> &a, unsigned size)
 {
@@ -398,6 +614,11 @@ TEST_CASE("test_prime_factors(): ntheory", "[ntheory]")
     _test_primefactors(i125, 3);
     _test_primefactors(i1001, 3);
     _test_primefactors(minus_one, 0);
+    _test_primefactors(
+        integer(integer_class("340282366920938463463374607431768211457")), 2);
+    _test_primefactors(integer(integer_class("1000000000000000003")
+                               * integer_class("1000000000000000003") * 12),
+                       5);
 }
 
 void _test_prime_factor_multiplicities(const RCP<const Integer> &a)
@@ -436,6 +657,116 @@ TEST_CASE("test_prime_factor_multiplicities(): ntheory", "[ntheory]")
     _test_prime_factor_multiplicities(i36);
     _test_prime_factor_multiplicities(i125);
     _test_prime_factor_multiplicities(i2357);
+
+    map_integer_uint prime_mul;
+    prime_factor_multiplicities(
+        prime_mul,
+        *integer(integer_class("123456789012345678901234567890123456789")));
+    REQUIRE(prime_mul.size() == 10);
+    REQUIRE(prime_mul[integer(3)] == 2);
+    REQUIRE(prime_mul[integer(integer_class("5964848081"))] == 1);
+    prime_mul.clear();
+    prime_factor_multiplicities(prime_mul,
+                                *integer(integer_class("4294967311")
+                                         * integer_class("4294967311")
+                                         * integer_class("4294967357") * 8));
+    REQUIRE(prime_mul.size() == 3);
+    REQUIRE(prime_mul[integer(2)] == 3);
+    REQUIRE(prime_mul[integer(integer_class("4294967311"))] == 2);
+    REQUIRE(prime_mul[integer(integer_class("4294967357"))] == 1);
+}
+
+TEST_CASE("test_probab_prime_p_batch(): ntheory", "[ntheory]")
+{
+    // 3215031751 and 3825123056546413051 are strong pseudoprimes to the
+    // bases up to 7 and up to 23, 18446744073709551557 is the largest prime
+    // below 2**64 and 4294967291**2 is the largest prime square below it.
+    // The squares of the Wieferich primes 1093 and 3511 are strong
+    // pseudoprimes to base 2.
+    std::vector<uint64_t> words = {0,
+                                   1,
+                                   2,
+                                   3,
+                                   4,
+                                   561,
+                                   2047,
+                                   2809,
+                                   5777,
+                                   65521,
+                                   3215031751u,
+                                   4294967291u,
+                                   4294967291ULL * 4294967291ULL,
+                                   1093ULL * 1093,
+                                   3511ULL * 3511,
+                                   3825123056546413051u,
+                                   18446744073709551557u,
+                                   18446744073709551615u};
+    std::vector<int> expected
+        = {0, 0, 2, 2, 0, 0, 0, 0, 0, 2, 0, 2, 0, 0, 0, 0, 2, 0};
+    std::vector<int> result;
+    probab_prime_p_batch(result, words);
+    REQUIRE(result == expected);
+
+    vec_integer_class n;
+    for (uint64_t w : words)
+        n.push_back(integer_class(std::to_string(w)));
+    n.push_back(integer_class("-7"));
+    n.push_back(integer_class("18446744073709551629"));
+    n.push_back(integer_class("340282366920938463463374607431768211457"));
+    n.push_back(integer_class("18446744073709551629") * 65537);
+    n.push_back(integer_class("1000000000000000003")
+                * integer_class("1000000000000000009"));
+    for (unsigned i = 0; i < 100; i++)
+        n.push_back((integer_class(1) << 80) + i);
+    probab_prime_p_batch(result, n);
+    REQUIRE(result.size() == n.size());
+    for (unsigned i = 0; i < words.size(); i++)
+        REQUIRE(result[i] == expected[i]);
+    for (size_t i = words.size(); i < n.size(); i++)
+        REQUIRE((result[i] != 0) == (probab_prime_p(*integer(n[i])) != 0));
+    REQUIRE(result[words.size()] == 2);
+    REQUIRE(result[words.size() + 1] != 0);
+    REQUIRE(result[words.size() + 2] == 0);
+
+    probab_prime_p_batch(result, vec_integer_class());
+    REQUIRE(result.empty());
+}
+
+TEST_CASE("test_prime_factors_batch(): ntheory", "[ntheory]")
+{
+    vec_integer_class n
+        = {integer_class(0), integer_class(1), integer_class(-12),
+           integer_class(65521) * 65521 * 65519 * 2,
+           integer_class("18446744073709551557"),
+           integer_class("340282366920938463463374607431768211457"),
+           integer_class("1000000000000000003")
+               * integer_class("1000000000000000003") * 12,
+           integer_class("123456789012345678901234567890123456789")};
+    for (unsigned i = 0; i < 100; i++)
+        n.push_back((integer_class(1) << 70) + 1000 * i + 1);
+
+    vec_integer_class primes;
+    std::vector<size_t> offsets;
+    prime_factors_batch(primes, offsets, n);
+    REQUIRE(offsets.size() == n.size() + 1);
+    REQUIRE(offsets[0] == 0);
+    REQUIRE(offsets.back() == primes.size());
+    for (size_t i = 0; i < n.size(); i++) {
+        std::vector<RCP<const Integer>> expected;
+        prime_factors(expected, *integer(n[i]));
+        size_t count = offsets[i + 1] - offsets[i];
+        REQUIRE(count == expected.size());
+        for (size_t j = 0; j < expected.size(); j++)
+            REQUIRE(primes[offsets[i] + j] == expected[j]->as_integer_class());
+    }
+    size_t count = offsets[3] - offsets[2];
+    REQUIRE(count == 3);
+    REQUIRE(primes[offsets[3]] == 2);
+    REQUIRE(primes[offsets[4] - 1] == 65521);
+
+    prime_factors_batch(primes, offsets, vec_integer_class());
+    REQUIRE(primes.empty());
+    REQUIRE(offsets.size() == 1);
 }
 
 TEST_CASE("test_bernoulli(): ntheory", "[ntheory]")
@@ -445,6 +776,37 @@ TEST_CASE("test_bernoulli(): ntheory", "[ntheory]")
     r1 = bernoulli(12);
     r2 = Rational::from_two_ints(*integer(-691), *integer(2730));
     REQUIRE(eq(*r1, *r2));
+
+    REQUIRE(eq(*bernoulli(0), *one));
+    REQUIRE(eq(*bernoulli(1), *rational(1, 2)));
+    REQUIRE(eq(*bernoulli(3), *zero));
+    REQUIRE(eq(*bernoulli(1001), *zero));
+    r1 = bernoulli(60);
+    r2 = Rational::from_mpq(rational_class(
+        integer_class("-1215233140483755572040304994079820246041491"),
+        integer_class(56786730)));
+    REQUIRE(eq(*r1, *r2));
+
+    // B_258 and above are not taken from the table of tangent numbers, so
+    // compare them with the Akiyama-Tanigawa recurrence
+    for (unsigned n : {256u, 258u, 300u}) {
+        std::vector<rational_class> v(n + 1);
+        for (unsigned m = 0; m <= n; ++m) {
+            v[m] = rational_class(1u, m + 1);
+            for (unsigned j = m; j >= 1; --j)
+                v[j - 1] = j * (v[j - 1] - v[j]);
+        }
+        REQUIRE(eq(*bernoulli(n), *Rational::from_mpq(v[0])));
+    }
+
+    rational_class b
+        = rcp_static_cast<const Rational>(bernoulli(1000))->as_rational_class();
+    integer_class r;
+    mp_fdiv_r(r, get_num(b), integer_class(1000000007));
+    REQUIRE(get_den(b) == 342999030);
+    REQUIRE(r == 483463231);
+    // A second query is answered from the cache
+    REQUIRE(eq(*bernoulli(1000), *Rational::from_mpq(b)));
 }
 
 TEST_CASE("test_crt(): ntheory", "[ntheory]")
@@ -692,6 +1054,90 @@ TEST_CASE("test_nthroot_mod(): ntheory", "[ntheory]")
     REQUIRE(roots.size() == 1);
 }
 
+TEST_CASE("test_discrete_log(): ntheory", "[ntheory]")
+{
+    RCP<const Integer> x;
+    vec_integer_class a, y;
+    for (long n = 1; n < 40; n++) {
+        for (long g = 0; g < n; g++) {
+            a.clear();
+            for (long b = 0; b < n; b++)
+                a.push_back(integer_class(b));
+            discrete_log_batch(y, a, integer_class(g), integer_class(n));
+            REQUIRE(y.size() == a.size());
+            for (long b = 0; b < n; b++) {
+                long e = -1, t = 1 % n;
+                for (long j = 0; j < 2 * n; j++, t = t * g % n) {
+                    if (t == b) {
+                        e = j;
+                        break;
+                    }
+                }
+                REQUIRE(y[b] == e);
+            }
+        }
+    }
+
+    REQUIRE(discrete_log(outArg(x), *integer(16), *integer(6), *integer(20)));
+    REQUIRE(eq(*x, *integer(2)));
+    REQUIRE(not discrete_log(outArg(x), *integer(3), *integer(4), *integer(7)));
+    REQUIRE(not discrete_log(outArg(x), *integer(1), *integer(2), *zero));
+
+    // Word modulus, with 52445056723 | p - 1 found by baby-step giant-step
+    integer_class p("1000000000000000003"), b;
+    a.clear();
+    for (unsigned long e = 1; e < 20; e++) {
+        mp_powm(b, integer_class(2), integer_class(e * 987654321987), p);
+        a.push_back(b);
+    }
+    discrete_log_batch(y, a, integer_class(2), p);
+    for (size_t i = 0; i < a.size(); i++) {
+        mp_powm(b, integer_class(2), y[i], p);
+        REQUIRE(b == a[i]);
+    }
+
+    // Pollard's rho for the factor 5594472617641 of p - 1
+    p = integer_class("18446744073709551557");
+    integer_class c;
+    mp_powm(c, integer_class(2), integer_class("12345678901234567"), p);
+    REQUIRE(discrete_log(outArg(x), *integer(c), *integer(2), *integer(p)));
+    mp_powm(b, integer_class(2), x->as_integer_class(), p);
+    REQUIRE(b == c);
+    REQUIRE(x->as_integer_class() < p);
+
+    // Multiprecision modulus; 5 is a primitive root of p
+    p = integer_class("2835234296501697128601200562200991079102847");
+    a.clear();
+    vec_integer_class e;
+    for (unsigned long i = 1; i < 10; i++) {
+        e.push_back(p / (i * 1000003 + 7));
+        mp_powm(b, integer_class(5), e.back(), p);
+        a.push_back(b);
+    }
+    discrete_log_batch(y, a, integer_class(5), p);
+    for (size_t i = 0; i < a.size(); i++)
+        REQUIRE(y[i] == e[i]);
+
+    // Even modulus: 3 has order 2**68 mod 2**70
+    p = integer_class(1) << 70;
+    mp_powm(b, integer_class(3), integer_class("123456789012345"), p);
+    REQUIRE(discrete_log(outArg(x), *integer(b), *integer(3), *integer(p)));
+    REQUIRE(eq(*x, *integer(integer_class("123456789012345"))));
+
+    // The prime q = 68719476767 divides p1 - 1 and p2 - 1 for n = p1 p2,
+    // with g of order q mod p1 and 1 mod p2, and c the other way around.
+    // Rho never finds the power of g that c is not, and baby-step
+    // giant-step confirms it.
+    p = integer_class("2436741107365532622363689");
+    integer_class g("1401126136707257098474847");
+    c = integer_class("106260230030960316175029");
+    REQUIRE(not discrete_log(outArg(x), *integer(c), *integer(g),
+                             *integer(p)));
+    mp_powm(b, g, integer_class("123456789012"), p);
+    REQUIRE(discrete_log(outArg(x), *integer(b), *integer(g), *integer(p)));
+    REQUIRE(eq(*x, *integer(54737312245)));
+}
+
 TEST_CASE("test_powermod(): ntheory", "[ntheory]")
 {
     RCP<const Integer> im1 = integer(-1);
@@ -882,6 +1328,80 @@ TEST_CASE("test_mertens(): ntheory", "[ntheory]")
     REQUIRE(mertens(36) == -1);
     REQUIRE(mertens(39) == 0);
     REQUIRE(mertens(113) == -5);
+    REQUIRE(mertens(0) == 0);
+
+    std::vector<int> mu;
+    mobius_range(mu, 1, 200000);
+    long m = 0;
+    for (unsigned long i = 1; i <= 200000; i++) {
+        m += mu[i - 1];
+        if (i % 997 == 0)
+            REQUIRE(mertens(i) == m);
+    }
+    REQUIRE(mertens(1000000) == 212);
+    REQUIRE(mertens(1000000000) == -222);
+    REQUIRE(mertens(10000000000) == -33722);
+}
+
+TEST_CASE("test_multiplicative_range(): ntheory", "[ntheory]")
+{
+    std::vector<int> mu;
+    mobius_range(mu, 1, 1000);
+    for (unsigned i = 1; i <= 1000; i++)
+        REQUIRE(mu[i - 1] == mobius(*integer(i)));
+    mobius_range(mu, 1000000000000ULL, 1000000000100ULL);
+    REQUIRE(mu.size() == 101);
+    for (unsigned i = 0; i <= 100; i++)
+        REQUIRE(mu[i]
+                == mobius(*integer(integer_class(1000000000000ULL + i))));
+    mobius_range(mu, 5, 4);
+    REQUIRE(mu.empty());
+    CHECK_THROWS_AS(mobius_range(mu, 0, 10), SymEngineException);
+
+    std::vector<uint64_t> phi, sigma, tau;
+    totient_range(phi, 999900, 1000100);
+    divisor_sigma_range(sigma, 999900, 1000100);
+    divisor_sigma_range(tau, 999900, 1000100, 0);
+    for (unsigned i = 0; i < phi.size(); i++) {
+        uint64_t n = 999900 + i, s = 0, t = 0;
+        for (uint64_t d = 1; d <= n; d++) {
+            if (n % d == 0) {
+                s += d;
+                t++;
+            }
+        }
+        REQUIRE(totient(integer(n))->as_integer_class() == phi[i]);
+        REQUIRE(sigma[i] == s);
+        REQUIRE(tau[i] == t);
+    }
+    divisor_sigma_range(sigma, 12, 12, 2);
+    REQUIRE(sigma[0] == 210);
+}
+
+// Sieves all the base primes below 2**32, which takes seconds
+TEST_CASE("test_multiplicative_range_top(): ntheory", "[ntheory][.slow]")
+{
+    // The top of the range, where the end of the last segment wraps around
+    // to 0
+    const uint64_t top = std::numeric_limits<uint64_t>::max();
+    std::vector<int> mu;
+    mobius_range(mu, top - 199, top);
+    std::vector<uint64_t> phi;
+    totient_range(phi, top - 199, top);
+    SymEngine::Sieve::clear();
+    REQUIRE(mu.size() == 200);
+    REQUIRE(phi.size() == 200);
+    for (unsigned i = 0; i < 200; i++) {
+        // mobius() only takes integers that fit in a long
+        RCP<const Integer> n = integer(integer_class(top - 199 + i));
+        map_integer_uint factors;
+        prime_factor_multiplicities(factors, *n);
+        int m = 1;
+        for (const auto &f : factors)
+            m = f.second > 1 ? 0 : -m;
+        REQUIRE(mu[i] == m);
+        REQUIRE(totient(n)->as_integer_class() == phi[i]);
+    }
 }
 
 TEST_CASE("test_harmonic(): ntheory", "[ntheory]")
@@ -894,6 +1414,21 @@ TEST_CASE("test_harmonic(): ntheory", "[ntheory]")
     r1 = harmonic(3, 2);
     r2 = rational(49, 36);
     REQUIRE(eq(*r1, *r2));
+
+    REQUIRE(eq(*harmonic(0, 1), *zero));
+    REQUIRE(eq(*harmonic(7, 0), *integer(7)));
+    REQUIRE(eq(*harmonic(5, -2), *integer(55)));
+    r2 = Rational::from_mpq(rational_class(integer_class("19164113947"),
+                                           integer_class("16003008000")));
+    REQUIRE(eq(*harmonic(10, 3), *r2));
+
+    rational_class h
+        = rcp_static_cast<const Rational>(harmonic(1000))->as_rational_class();
+    integer_class r;
+    mp_fdiv_r(r, get_num(h), integer_class(1000000007));
+    REQUIRE(r == 737132998);
+    mp_fdiv_r(r, get_den(h), integer_class(1000000007));
+    REQUIRE(r == 849686073);
 }
 
 TEST_CASE("test_factor_trial_division(): ntheory", "[ntheory]")
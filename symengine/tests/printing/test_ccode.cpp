@@ -4,6 +4,7 @@
 #include <symengine/add.h>
 #include <symengine/codegen.h>
 #include <symengine/sets.h>
+#include <symengine/cse.h>
 
 using SymEngine::Basic;
 using SymEngine::E;
@@ -25,6 +26,9 @@ using SymEngine::boolTrue;
 using SymEngine::sin;
 using SymEngine::sqrt;
 using SymEngine::rational;
+using SymEngine::cos;
+using SymEngine::exp;
+using SymEngine::StraightLineProgram;
 
 TEST_CASE("Arithmetic", "[ccode]")
 {
@@ -88,3 +92,18 @@ TEST_CASE("Piecewise", "[ccode]")
     REQUIRE(ccode(*p) == "((x <= 2) ? (\n   x\n)\n: ((x > 2 && x <= 5) ? (\n   "
                          "y\n)\n: (\n   x + y\n)))");
 }
+
+TEST_CASE("StraightLineProgram", "[ccode]")
+{
+    auto x = symbol("x");
+    auto y = symbol("y");
+    auto a = add(x, y);
+    auto b = add(sin(a), cos(a));
+
+    StraightLineProgram p({x, y}, {add(exp(b), b), mul(b, y)});
+    REQUIRE(ccode(p) == "double x0;\n"
+                        "x0 = x + y;\n"
+                        "x0 = sin(x0) + cos(x0);\n"
+                        "out[0] = x0 + pow(M_E, x0);\n"
+                        "out[1] = y*x0;\n");
+}